@@ -23,6 +23,7 @@ limitations under the License.
 ///
 //----------------------------------------------------------------------------
 
+#include <cstddef>
 #include <sys/time.h>
 #include <sys/resource.h>
 #include "nic/gpuagent/core/trace.hpp"
@@ -36,6 +37,8 @@ aga_state g_aga_state;
 
 aga_state::aga_state() {
     memset(state_, 0, sizeof(state_));
+    api_params_slab_key_ = NULL;
+    memset(api_params_slab_obj_, 0, sizeof(api_params_slab_obj_));
 }
 
 aga_state::~aga_state() {
@@ -47,10 +50,52 @@ aga_state::store_init_(void) {
     state_[AGA_STATE_GPU_WATCH] = new gpu_watch_state();
 }
 
+sdk_ret_t
+aga_state::api_params_slab_init_(void) {
+    size_t hdr_sz;
+
+    // API params carry the spec of only one object type at a time, so size
+    // the elements to the object's spec instead of the whole spec union; the
+    // params are handed out zeroed as the spec fill routines expect
+    // NOTE: aga_api_params is polymorphic, so offsetof() is only
+    //       conditionally supported; gcc lays out the vptr and base first
+    //       as expected
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winvalid-offsetof"
+    hdr_sz = offsetof(aga_api_params, key);
+#pragma GCC diagnostic pop
+    api_params_slab_key_ =
+        slab_create("api_params_key", AGA_SLAB_ID_API_PARAMS_KEY,
+                    hdr_sz + sizeof(aga_obj_key_t), 64, true);
+    api_params_slab_obj_[AGA_OBJ_ID_GPU] =
+        slab_create("api_params_gpu", AGA_SLAB_ID_API_PARAMS_GPU,
+                    hdr_sz + sizeof(aga_gpu_spec_t), 32, true);
+    api_params_slab_obj_[AGA_OBJ_ID_TASK] =
+        slab_create("api_params_task", AGA_SLAB_ID_API_PARAMS_TASK,
+                    hdr_sz + sizeof(aga_task_spec_t), 16, true);
+    api_params_slab_obj_[AGA_OBJ_ID_GPU_WATCH] =
+        slab_create("api_params_gpu_watch", AGA_SLAB_ID_API_PARAMS_GPU_WATCH,
+                    hdr_sz + sizeof(aga_gpu_watch_spec_t), 16, true);
+    if (!api_params_slab_key_ || !api_params_slab_obj_[AGA_OBJ_ID_GPU] ||
+        !api_params_slab_obj_[AGA_OBJ_ID_TASK] ||
+        !api_params_slab_obj_[AGA_OBJ_ID_GPU_WATCH]) {
+        return SDK_RET_OOM;
+    }
+    return SDK_RET_OK;
+}
+
 sdk_ret_t
 aga_state::init(void) {
+    sdk_ret_t ret;
+
     // initialize all the internal databases
     store_init_();
+    // initialize memory pools
+    ret = api_params_slab_init_();
+    if (unlikely(ret != SDK_RET_OK)) {
+        AGA_TRACE_ERR("Failed to create API params slabs, err {}", ret());
+        return ret;
+    }
     return SDK_RET_OK;
 }
 
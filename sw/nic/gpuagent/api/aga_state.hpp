@@ -26,6 +26,7 @@ limitations under the License.
 #define __AGA_STATE_HPP__
 
 #include "nic/gpuagent/core/state_base.hpp"
+#include "nic/gpuagent/core/mem.hpp"
 #include "nic/gpuagent/api/gpu_state.hpp"
 #include "nic/gpuagent/api/task_state.hpp"
 #include "nic/gpuagent/api/gpu_watch_state.hpp"
@@ -93,15 +94,20 @@ public:
     }
 
     /// \brief    allocate an instance of API params
+    /// \param[in] obj_id    object id/type
+    /// \param[in] api_op    API operation being performed
     /// \return    pointer to API params instance or NULL
-    api_params_base *aga_api_params_alloc(void) {
-        return (api_params_base *)calloc(1, sizeof(aga_api_params));
+    api_params_base *aga_api_params_alloc(obj_id_t obj_id, api_op_t api_op) {
+        return (api_params_base *)api_params_slab_(obj_id, api_op)->alloc();
     }
 
     /// \brief    free the given instance of API params object
+    /// \param[in] obj_id        object id/type
+    /// \param[in] api_op        API operation the params were allocated for
     /// \param[in] api_params    API params object to be freed
-    void aga_api_params_free(api_params_base *api_params) {
-        free(api_params);
+    void aga_api_params_free(obj_id_t obj_id, api_op_t api_op,
+                             api_params_base *api_params) {
+        api_params_slab_(obj_id, api_op)->free(api_params);
     }
 
     /// \brief    walk all the internal databases and invokve the given callback
@@ -111,7 +117,30 @@ public:
 private:
     /// \brief    initialize all internal databases
     void store_init_(void);
+
+    /// \brief    create API params slabs, one per object type sized to fit
+    ///           only that object's spec
+    /// \return SDK_RET_OK or error code in case of failure
+    sdk_ret_t api_params_slab_init_(void);
+
+    /// \brief    return the API params slab for the given API operation on
+    ///           the given object
+    /// \param[in] obj_id    object id/type
+    /// \param[in] api_op    API operation being performed
+    /// \return    API params slab
+    slab *api_params_slab_(obj_id_t obj_id, api_op_t api_op) {
+        // delete operations carry only the key
+        if (api_op == API_OP_DELETE) {
+            return api_params_slab_key_;
+        }
+        return api_params_slab_obj_[obj_id];
+    }
+
 private:
+    /// API params slab for delete operations
+    slab *api_params_slab_key_;
+    /// per object API params slabs for create and update operations
+    slab *api_params_slab_obj_[AGA_OBJ_ID_MAX];
     /// all object databases
     state_base *state_[AGA_STATE_MAX];
 
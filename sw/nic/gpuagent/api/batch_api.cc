@@ -0,0 +1,50 @@
+
+/*
+Copyright (c) Advanced Micro Devices, Inc. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+//----------------------------------------------------------------------------
+///
+/// \file
+/// this file implements API batching APIs
+///
+//----------------------------------------------------------------------------
+
+#include "nic/sdk/include/sdk/base.hpp"
+#include "nic/gpuagent/core/trace.hpp"
+#include "nic/gpuagent/core/api_msg.hpp"
+#include "nic/gpuagent/api/include/aga_batch.hpp"
+
+aga_batch_ctxt_t
+aga_batch_start (_In_ aga_batch_params_t *params)
+{
+    if (unlikely(params == NULL)) {
+        return AGA_BATCH_CTXT_INVALID;
+    }
+    return aga::batch_start(params);
+}
+
+sdk_ret_t
+aga_batch_commit (_In_ aga_batch_ctxt_t bctxt)
+{
+    return aga::batch_commit(bctxt);
+}
+
+sdk_ret_t
+aga_batch_destroy (_In_ aga_batch_ctxt_t bctxt)
+{
+    return aga::batch_destroy(bctxt);
+}
@@ -32,9 +32,10 @@ limitations under the License.
 #include "nic/gpuagent/api/smi/smi_api.hpp"
 
 sdk_ret_t
-aga_event_read_all (aga_event_read_cb_t cb, void *ctxt)
+aga_event_read_all (aga_event_read_cb_t cb, void *ctxt,
+                    const aga_event_query_t *query)
 {
-    return aga::smi_event_read_all(cb, ctxt);
+    return aga::smi_event_read_all(cb, ctxt, query);
 }
 
 static void
@@ -55,52 +56,45 @@ aga_event_subscribe (aga_event_subscribe_req_t *req)
     aga_event_subscribe_args_t *args;
 
     args = new aga_event_subscribe_args_t();
-    // allocate the client context
-    args->client_ctxt = new aga_event_client_ctxt_t();
-    AGA_TRACE_VERBOSE("Event subscribe request client_ctxt {}",
-                      (void *)args->client_ctxt);
-    // initialize the client context
-    args->client_ctxt->client = req->client;
-    args->client_ctxt->client_inactive = false;
-    args->client_ctxt->cond = PTHREAD_COND_INITIALIZER;
-    args->client_ctxt->lock = PTHREAD_MUTEX_INITIALIZER;
-    args->client_ctxt->stream = req->stream;
-    args->client_ctxt->notify_cb = req->notify_cb;
-
     for (auto i = 0; i < req->num_gpu; i++) {
         entry = gpu_db()->find(&req->gpu[i]);
         if (unlikely(entry == NULL)) {
             AGA_TRACE_ERR("Failed to subscribe events, GPU {} not found",
                           req->gpu[i].str());
+            delete args;
             return SDK_RET_INVALID_ARG;
         }
         args->gpu_ids.push_back(entry->id());
     }
+    // allocate the client context, backend owns it once the subscription
+    // goes through and releases it when the client becomes unreachable
+    args->client_ctxt = new aga_event_client_ctxt_t();
+    AGA_TRACE_VERBOSE("Event subscribe request client_ctxt {}",
+                      (void *)args->client_ctxt);
+    // initialize the client context
+    args->client_ctxt->client = req->client;
+    args->client_ctxt->stream = req->stream;
+    args->client_ctxt->notify_cb = req->notify_cb;
+    args->client_ctxt->close_cb = req->close_cb;
     for (auto i = 0; i < req->num_events; i++) {
         // convert the event id
         args->events.push_back(req->events[i]);
     }
+    args->resume_seq = req->resume_seq;
     // send this request to backend service thread
     // NOTE: intention is to send pointer to the backend thread
     sdk::ipc::FIXME_request(aga::AGA_THREAD_ID_EVENT_MONITOR,
                             aga::AGA_IPC_MSG_ID_EVENT_SUBSCRIBE, &args,
                             sizeof(args),
                             aga_event_subscribe_rsp_cb, &ret);
-    /// wait until gRPC client closes the connection and becomes inactive
-    pthread_mutex_lock(&args->client_ctxt->lock);
-    while (args->client_ctxt->client_inactive == false) {
-        pthread_cond_wait(&args->client_ctxt->cond, &args->client_ctxt->lock);
+    if (unlikely(ret != SDK_RET_OK)) {
+        AGA_TRACE_ERR("Event subscribe request failed, client {}, err {}",
+                      req->client, ret());
+        delete args->client_ctxt;
+        delete args;
+        return ret;
     }
-    AGA_TRACE_INFO("Rcvd signal from backend thread to quit, releasing "
-                   "client {} ctxt {}, event stream {}",
-                   args->client_ctxt->client.c_str(),
-                   (void *)args->client_ctxt,
-                   (void *)args->client_ctxt->stream);
-    pthread_mutex_unlock(&args->client_ctxt->lock);
-    pthread_mutex_destroy(&args->client_ctxt->lock);
-
-    // free the client context
-    delete args->client_ctxt;
+    // client context is owned by the backend from here on
     delete args;
     return SDK_RET_OK;
 }
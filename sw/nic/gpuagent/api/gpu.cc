@@ -20,20 +20,44 @@ limitations under the License.
 ///
 //----------------------------------------------------------------------------
 
+#include "nic/sdk/include/sdk/timestamp.hpp"
 #include "nic/gpuagent/core/trace.hpp"
 #include "nic/gpuagent/api/mem.hpp"
 #include "nic/gpuagent/api/gpu.hpp"
 #include "nic/gpuagent/api/aga_state.hpp"
 #include "nic/gpuagent/api/internal/aga_api_params.hpp"
 #include "nic/gpuagent/api/smi/smi_api.hpp"
+#include "nic/gpuagent/api/gpu_watch_sched.hpp"
+
+/// how long the watch attributes reported in the GPU stats keep getting
+/// sampled after the stats are read (in milliseconds)
+#define AGA_GPU_STATS_WATCH_LEASE_TTL    60000
 
 namespace aga {
 
+/// \brief    return the watch attributes reported in the GPU stats
+/// \return   list of attributes
+static std::vector<aga_gpu_watch_attr_id_t>
+gpu_stats_watch_attrs_ (void)
+{
+    std::vector<aga_gpu_watch_attr_id_t> attrs;
+
+    attrs.push_back(AGA_GPU_WATCH_ATTR_ID_POWER_USAGE);
+    for (uint32_t attr = AGA_GPU_WATCH_ATTR_ID_ECC_CORRECT_TOTAL;
+         attr <= AGA_GPU_WATCH_ATTR_ID_XGMI_5_THRPUT; attr++) {
+        attrs.push_back((aga_gpu_watch_attr_id_t)attr);
+    }
+    return attrs;
+}
+
 gpu_entry::gpu_entry() {
     // set partition id as invalid
     partition_id_ = AGA_GPU_INVALID_PARTITION_ID;
     // reset parent GPU uuid
     parent_gpu_.reset();
+    // spec and status are cached on first read
+    cache_stale_ = true;
+    SDK_SPINLOCK_INIT(&slock_, PTHREAD_PROCESS_PRIVATE);
 }
 
 gpu_entry *
@@ -48,6 +72,7 @@ gpu_entry::factory(aga_gpu_spec_t *spec) {
 }
 
 gpu_entry::~gpu_entry() {
+    SDK_SPINLOCK_DESTROY(&slock_);
 }
 
 void
@@ -105,111 +130,178 @@ sdk_ret_t
 gpu_entry::update_handler(api_params_base *api_params) {
     sdk_ret_t ret;
     uint64_t upd_mask = 0;
+    aga_gpu_spec_t cur_spec, new_spec = { 0 };
     aga_gpu_spec_t *spec = AGA_GPU_SPEC(api_params);
 
-    if (spec_.compute_partition_type != spec->compute_partition_type) {
+    // spec_ is refreshed from the gRPC threads as well, work off a copy
+    SDK_SPINLOCK_LOCK(&slock_);
+    memcpy(&cur_spec, &spec_, sizeof(aga_gpu_spec_t));
+    SDK_SPINLOCK_UNLOCK(&slock_);
+
+    if (cur_spec.compute_partition_type != spec->compute_partition_type) {
         upd_mask |= AGA_GPU_UPD_COMPUTE_PARTITION_TYPE;
     }
-    if (spec_.memory_partition_type != spec->memory_partition_type) {
+    if (cur_spec.memory_partition_type != spec->memory_partition_type) {
         upd_mask |= AGA_GPU_UPD_MEMORY_PARTITION_TYPE;
     }
-    if (spec_.admin_state != spec->admin_state) {
+    if (cur_spec.admin_state != spec->admin_state) {
         upd_mask |= AGA_GPU_UPD_ADMIN_STATE;
     }
-    if (spec_.overdrive_level != spec->overdrive_level) {
+    if (cur_spec.overdrive_level != spec->overdrive_level) {
         upd_mask |= AGA_GPU_UPD_OVERDRIVE_LEVEL;
     }
-    if (spec_.gpu_power_cap != spec->gpu_power_cap) {
+    if (cur_spec.gpu_power_cap != spec->gpu_power_cap) {
         upd_mask |= AGA_GPU_UPD_POWER_CAP;
     }
-    if (spec_.perf_level != spec->perf_level) {
+    if (cur_spec.perf_level != spec->perf_level) {
         upd_mask |= AGA_GPU_UPD_PERF_LEVEL;
     }
-    if (memcmp(spec_.clock_freq, spec->clock_freq,
+    if (memcmp(cur_spec.clock_freq, spec->clock_freq,
                sizeof(aga_gpu_clock_freq_range_t) * AGA_GPU_CLOCK_TYPE_MAX)) {
         upd_mask |= AGA_GPU_UPD_CLOCK_FREQ_RANGE;
     }
-    if (spec_.fan_speed != spec->fan_speed) {
+    if (cur_spec.fan_speed != spec->fan_speed) {
         upd_mask |= AGA_GPU_UPD_FAN_SPEED;
     }
-    if (memcmp(&spec_.ras_spec, &spec->ras_spec, sizeof(aga_gpu_ras_spec_t))) {
+    if (memcmp(&cur_spec.ras_spec, &spec->ras_spec,
+               sizeof(aga_gpu_ras_spec_t))) {
         upd_mask |= AGA_GPU_UPD_RAS_SPEC;
     }
     ret = smi_gpu_update(handle_, spec, upd_mask);
     if (unlikely(ret != SDK_RET_OK)) {
         return ret;
     }
-    // update the stashed spec if the gpu update goes through
-    memcpy(spec, &spec_, sizeof(aga_gpu_spec_t));
+    // update the stashed spec if the gpu update goes through; it is read
+    // back from the GPU as the GPU may normalize some of the values, except
+    // for parent GPUs whose spec is not read from the GPU
+    if (child_gpus_.size()) {
+        memcpy(&new_spec, spec, sizeof(aga_gpu_spec_t));
+    } else {
+        fill_spec_(&new_spec);
+    }
+    SDK_SPINLOCK_LOCK(&slock_);
+    memcpy(&spec_, &new_spec, sizeof(aga_gpu_spec_t));
+    SDK_SPINLOCK_UNLOCK(&slock_);
+    // status reflects some of the updated attributes, refresh it on next read
+    cache_invalidate();
     return ret;
 }
 
+sdk_ret_t
+gpu_entry::backup(api_params_base *api_params) {
+    aga_gpu_spec_t *spec = AGA_GPU_SPEC(api_params);
+
+    memset(spec, 0, sizeof(aga_gpu_spec_t));
+    if (child_gpus_.size()) {
+        SDK_SPINLOCK_LOCK(&slock_);
+        memcpy(spec, &spec_, sizeof(aga_gpu_spec_t));
+        SDK_SPINLOCK_UNLOCK(&slock_);
+    } else {
+        // read the spec from the GPU as the cached one may be stale
+        fill_spec_(spec);
+    }
+    return SDK_RET_OK;
+}
+
 void
-gpu_entry::fill_stats_(aga_gpu_stats_t *stats) {
+gpu_entry::fill_stats_(aga_gpu_stats_t *stats, bool live) {
+    uint64_t now_ns;
+    timespec_t now_ts;
     gpu_entry *parent_gpu;
+    aga_gpu_watch_fields_t fields;
+    aga_gpu_watch_attr_set_t stale;
     aga_gpu_handle_t first_partition_handle;
 
     // fill stats only for non-parent GPUs
     if (child_gpus_.size()) {
         return;
     }
-    // fill stats stased from watch infra
-    stats->power_usage = stats_.power_usage;
-    stats->total_correctable_errors = stats_.total_correctable_errors;
-    stats->total_uncorrectable_errors = stats_.total_uncorrectable_errors;
-    stats->sdma_correctable_errors = stats_.sdma_correctable_errors;
-    stats->sdma_uncorrectable_errors = stats_.sdma_uncorrectable_errors;
-    stats->gfx_correctable_errors = stats_.gfx_correctable_errors;
-    stats->gfx_uncorrectable_errors = stats_.gfx_uncorrectable_errors;
-    stats->mmhub_correctable_errors = stats_.mmhub_correctable_errors;
-    stats->mmhub_uncorrectable_errors = stats_.mmhub_uncorrectable_errors;
-    stats->athub_correctable_errors = stats_.athub_correctable_errors;
-    stats->athub_uncorrectable_errors = stats_.athub_uncorrectable_errors;
-    stats->bif_correctable_errors = stats_.bif_correctable_errors;
-    stats->bif_uncorrectable_errors = stats_.bif_uncorrectable_errors;
-    stats->hdp_correctable_errors = stats_.hdp_correctable_errors;
-    stats->hdp_uncorrectable_errors = stats_.hdp_uncorrectable_errors;
-    stats->xgmi_wafl_correctable_errors = stats_.xgmi_wafl_correctable_errors;
+    // power, ECC and XGMI counters are sampled by the watcher only while
+    // someone reads them, so keep them sampled for a while
+    static const std::vector<aga_gpu_watch_attr_id_t> watch_attrs =
+        gpu_stats_watch_attrs_();
+    g_gpu_watch_sched.lease(id_, watch_attrs.data(), watch_attrs.size(),
+                            AGA_GPU_STATS_WATCH_LEASE_TTL);
+    // fill stats from the latest snapshot published by watch infra
+    {
+        gpu_watch_snapshot_guard snapshot;
+
+        memcpy(&fields, snapshot.watch_fields(id_), sizeof(fields));
+    }
+    // attributes the watcher has not sampled recently, because this is the
+    // first read or the stats are read less often than the lease lasts, are
+    // read right away instead of reporting stale values
+    clock_gettime(CLOCK_MONOTONIC, &now_ts);
+    sdk::timestamp_to_nsecs(&now_ts, &now_ns);
+    for (auto attr : watch_attrs) {
+        if (live || (fields.attr_capture_ns[attr] == 0) ||
+            ((now_ns - fields.attr_capture_ns[attr]) >
+                 ((uint64_t)AGA_GPU_WATCH_LEASE_INTERVAL *
+                      TIME_NSECS_PER_MSEC))) {
+            stale.set(attr);
+        }
+    }
+    if (stale.any()) {
+        smi_gpu_watch_fields_read(id_, stale, &fields);
+    }
+
+    stats->power_usage = fields.power_usage;
+    stats->total_correctable_errors = fields.total_correctable_errors;
+    stats->total_uncorrectable_errors = fields.total_uncorrectable_errors;
+    stats->sdma_correctable_errors = fields.sdma_correctable_errors;
+    stats->sdma_uncorrectable_errors = fields.sdma_uncorrectable_errors;
+    stats->gfx_correctable_errors = fields.gfx_correctable_errors;
+    stats->gfx_uncorrectable_errors = fields.gfx_uncorrectable_errors;
+    stats->mmhub_correctable_errors = fields.mmhub_correctable_errors;
+    stats->mmhub_uncorrectable_errors = fields.mmhub_uncorrectable_errors;
+    stats->athub_correctable_errors = fields.athub_correctable_errors;
+    stats->athub_uncorrectable_errors = fields.athub_uncorrectable_errors;
+    stats->bif_correctable_errors = fields.bif_correctable_errors;
+    stats->bif_uncorrectable_errors = fields.bif_uncorrectable_errors;
+    stats->hdp_correctable_errors = fields.hdp_correctable_errors;
+    stats->hdp_uncorrectable_errors = fields.hdp_uncorrectable_errors;
+    stats->xgmi_wafl_correctable_errors = fields.xgmi_wafl_correctable_errors;
     stats->xgmi_wafl_uncorrectable_errors =
-        stats_.xgmi_wafl_uncorrectable_errors;
-    stats->df_correctable_errors = stats_.df_correctable_errors;
-    stats->df_uncorrectable_errors = stats_.df_uncorrectable_errors;
-    stats->smn_correctable_errors = stats_.smn_correctable_errors;
-    stats->smn_uncorrectable_errors = stats_.smn_uncorrectable_errors;
-    stats->sem_correctable_errors = stats_.sem_correctable_errors;
-    stats->sem_uncorrectable_errors = stats_.sem_uncorrectable_errors;
-    stats->mp0_correctable_errors = stats_.mp0_correctable_errors;
-    stats->mp0_uncorrectable_errors = stats_.mp0_uncorrectable_errors;
-    stats->mp1_correctable_errors = stats_.mp1_correctable_errors;
-    stats->mp1_uncorrectable_errors = stats_.mp1_uncorrectable_errors;
-    stats->fuse_correctable_errors = stats_.fuse_correctable_errors;
-    stats->fuse_uncorrectable_errors = stats_.fuse_uncorrectable_errors;
-    stats->umc_correctable_errors = stats_.umc_correctable_errors;
-    stats->umc_uncorrectable_errors = stats_.umc_uncorrectable_errors;
-    stats->mca_correctable_errors = stats_.mca_correctable_errors;
-    stats->mca_uncorrectable_errors = stats_.mca_uncorrectable_errors;
-    stats->vcn_correctable_errors = stats_.vcn_correctable_errors;
-    stats->vcn_uncorrectable_errors = stats_.vcn_uncorrectable_errors;
-    stats->jpeg_correctable_errors = stats_.jpeg_correctable_errors;
-    stats->jpeg_uncorrectable_errors = stats_.jpeg_uncorrectable_errors;
-    stats->ih_correctable_errors = stats_.ih_correctable_errors;
-    stats->ih_uncorrectable_errors = stats_.ih_uncorrectable_errors;
-    stats->mpio_correctable_errors = stats_.mpio_correctable_errors;
-    stats->mpio_uncorrectable_errors = stats_.mpio_uncorrectable_errors;
-    stats->xgmi_neighbor0_tx_nops = stats_.xgmi_neighbor0_tx_nops;
-    stats->xgmi_neighbor0_tx_requests = stats_.xgmi_neighbor0_tx_requests;
-    stats->xgmi_neighbor0_tx_responses = stats_.xgmi_neighbor0_tx_responses;
-    stats->xgmi_neighbor0_tx_beats = stats_.xgmi_neighbor0_tx_beats;
-    stats->xgmi_neighbor1_tx_nops = stats_.xgmi_neighbor1_tx_nops;
-    stats->xgmi_neighbor1_tx_requests = stats_.xgmi_neighbor1_tx_requests;
-    stats->xgmi_neighbor1_tx_responses = stats_.xgmi_neighbor1_tx_responses;
-    stats->xgmi_neighbor1_tx_beats = stats_.xgmi_neighbor1_tx_beats;
-    stats->xgmi_neighbor0_tx_throughput = stats_.xgmi_neighbor0_tx_throughput;
-    stats->xgmi_neighbor1_tx_throughput = stats_.xgmi_neighbor1_tx_throughput;
-    stats->xgmi_neighbor2_tx_throughput = stats_.xgmi_neighbor2_tx_throughput;
-    stats->xgmi_neighbor3_tx_throughput = stats_.xgmi_neighbor3_tx_throughput;
-    stats->xgmi_neighbor4_tx_throughput = stats_.xgmi_neighbor4_tx_throughput;
-    stats->xgmi_neighbor5_tx_throughput = stats_.xgmi_neighbor5_tx_throughput;
+        fields.xgmi_wafl_uncorrectable_errors;
+    stats->df_correctable_errors = fields.df_correctable_errors;
+    stats->df_uncorrectable_errors = fields.df_uncorrectable_errors;
+    stats->smn_correctable_errors = fields.smn_correctable_errors;
+    stats->smn_uncorrectable_errors = fields.smn_uncorrectable_errors;
+    stats->sem_correctable_errors = fields.sem_correctable_errors;
+    stats->sem_uncorrectable_errors = fields.sem_uncorrectable_errors;
+    stats->mp0_correctable_errors = fields.mp0_correctable_errors;
+    stats->mp0_uncorrectable_errors = fields.mp0_uncorrectable_errors;
+    stats->mp1_correctable_errors = fields.mp1_correctable_errors;
+    stats->mp1_uncorrectable_errors = fields.mp1_uncorrectable_errors;
+    stats->fuse_correctable_errors = fields.fuse_correctable_errors;
+    stats->fuse_uncorrectable_errors = fields.fuse_uncorrectable_errors;
+    stats->umc_correctable_errors = fields.umc_correctable_errors;
+    stats->umc_uncorrectable_errors = fields.umc_uncorrectable_errors;
+    stats->mca_correctable_errors = fields.mca_correctable_errors;
+    stats->mca_uncorrectable_errors = fields.mca_uncorrectable_errors;
+    stats->vcn_correctable_errors = fields.vcn_correctable_errors;
+    stats->vcn_uncorrectable_errors = fields.vcn_uncorrectable_errors;
+    stats->jpeg_correctable_errors = fields.jpeg_correctable_errors;
+    stats->jpeg_uncorrectable_errors = fields.jpeg_uncorrectable_errors;
+    stats->ih_correctable_errors = fields.ih_correctable_errors;
+    stats->ih_uncorrectable_errors = fields.ih_uncorrectable_errors;
+    stats->mpio_correctable_errors = fields.mpio_correctable_errors;
+    stats->mpio_uncorrectable_errors = fields.mpio_uncorrectable_errors;
+    stats->xgmi_neighbor0_tx_nops = fields.xgmi_neighbor0_tx_nops;
+    stats->xgmi_neighbor0_tx_requests = fields.xgmi_neighbor0_tx_requests;
+    stats->xgmi_neighbor0_tx_responses = fields.xgmi_neighbor0_tx_responses;
+    stats->xgmi_neighbor0_tx_beats = fields.xgmi_neighbor0_tx_beats;
+    stats->xgmi_neighbor1_tx_nops = fields.xgmi_neighbor1_tx_nops;
+    stats->xgmi_neighbor1_tx_requests = fields.xgmi_neighbor1_tx_requests;
+    stats->xgmi_neighbor1_tx_responses = fields.xgmi_neighbor1_tx_responses;
+    stats->xgmi_neighbor1_tx_beats = fields.xgmi_neighbor1_tx_beats;
+    stats->xgmi_neighbor0_tx_throughput = fields.xgmi_neighbor0_tx_throughput;
+    stats->xgmi_neighbor1_tx_throughput = fields.xgmi_neighbor1_tx_throughput;
+    stats->xgmi_neighbor2_tx_throughput = fields.xgmi_neighbor2_tx_throughput;
+    stats->xgmi_neighbor3_tx_throughput = fields.xgmi_neighbor3_tx_throughput;
+    stats->xgmi_neighbor4_tx_throughput = fields.xgmi_neighbor4_tx_throughput;
+    stats->xgmi_neighbor5_tx_throughput = fields.xgmi_neighbor5_tx_throughput;
+    stats->watch_collection_latency = fields.collection_latency;
 
     // initialize first partition handle to be the same as current GPUs handle
     first_partition_handle = handle_;
@@ -233,7 +325,7 @@ gpu_entry::fill_stats_(aga_gpu_stats_t *stats) {
         }
     }
     // fetch stats from smi apis
-    smi_gpu_fill_stats(handle_, first_partition_handle, stats);
+    smi_gpu_fill_stats(handle_, first_partition_handle, stats, live);
 }
 
 void
@@ -263,11 +355,38 @@ gpu_entry::fill_spec_(aga_gpu_spec_t *spec) {
     }
 }
 
+void
+gpu_entry::refresh_cache_(aga_gpu_spec_t *spec, aga_gpu_status_t *status) {
+    // clear the flag first so an invalidation racing with the refresh isn't
+    // lost
+    cache_stale_ = false;
+    fill_spec_(spec);
+    fill_status_(status);
+    SDK_SPINLOCK_LOCK(&slock_);
+    memcpy(&spec_, spec, sizeof(aga_gpu_spec_t));
+    memcpy(&status_, status, sizeof(aga_gpu_status_t));
+    SDK_SPINLOCK_UNLOCK(&slock_);
+}
+
 sdk_ret_t
-gpu_entry::read(aga_gpu_info_t *info) {
-    fill_spec_(&info->spec);
-    fill_status_(&info->status);
-    fill_stats_(&info->stats);
+gpu_entry::read(aga_gpu_info_t *info, bool live) {
+    // parent GPUs are assembled from the child GPUs, nothing to cache
+    if (child_gpus_.size()) {
+        fill_spec_(&info->spec);
+        fill_status_(&info->status);
+        return SDK_RET_OK;
+    }
+    if (live || cache_stale_) {
+        refresh_cache_(&info->spec, &info->status);
+    } else {
+        SDK_SPINLOCK_LOCK(&slock_);
+        memcpy(&info->spec, &spec_, sizeof(aga_gpu_spec_t));
+        memcpy(&info->status, &status_, sizeof(aga_gpu_status_t));
+        SDK_SPINLOCK_UNLOCK(&slock_);
+        // overlay the fields that change at runtime
+        smi_gpu_fill_dynamic_status(handle_, id_, &info->status);
+    }
+    fill_stats_(&info->stats, live);
     return SDK_RET_OK;
 }
 
@@ -282,218 +401,36 @@ gpu_entry::read_topology(aga_device_topology_info_t *info) {
 }
 
 sdk_ret_t
-gpu_entry::update_stats(aga_gpu_watch_fields_t *stats) {
-    memcpy(&stats_, stats, sizeof(aga_gpu_watch_fields_t));
-    return SDK_RET_OK;
-}
+gpu_entry::fill_gpu_watch_stats(const gpu_watch_snapshot_guard& snapshot,
+                                uint32_t gpu_id, aga_gpu_watch_attrs_t *stats) {
+    sdk_ret_t ret;
+    uint64_t capture_ns, wall_ns;
+    const aga_gpu_watch_fields_t& fields = *snapshot.watch_fields(gpu_id);
 
-sdk_ret_t
-gpu_entry::fill_gpu_watch_stats(aga_gpu_watch_attrs_t *stats) {
     for (auto i = 0; i < stats->num_attrs; i++) {
         auto attr_val = &stats->attr[i].value;
 
-        // set all attributes types to long upfront, if any attribute type
-        // is different, can be overwritten in switch case
+        // all the watch fields are long for now, if any attribute type is
+        // different, it can be overwritten after reading the field
         attr_val->type = AGA_GPU_WATCH_ATTR_VALUE_TYPE_LONG;
 
-        switch (stats->attr[i].id) {
-        case AGA_GPU_WATCH_ATTR_ID_GPU_CLOCK:
-            attr_val->long_val = stats_.gpu_clock;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_MEM_CLOCK:
-            attr_val->long_val = stats_.memory_clock;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_GPU_TEMP:
-            attr_val->long_val = stats_.gpu_temperature;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_MEMORY_TEMP:
-            attr_val->long_val = stats_.memory_temperature;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_POWER_USAGE:
-            attr_val->long_val = stats_.power_usage;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_PCIE_TX:
-            attr_val->long_val = stats_.pcie_tx_usage;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_PCIE_RX:
-            attr_val->long_val = stats_.pcie_rx_usage;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_PCIE_BANDWIDTH:
-            attr_val->long_val = stats_.pcie_bandwidth;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_GPU_UTIL:
-            attr_val->long_val = stats_.gpu_util;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_GPU_MEMORY_USAGE:
-            attr_val->long_val = stats_.gpu_memory_usage;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_CORRECT_TOTAL:
-            attr_val->long_val = stats_.total_correctable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_UNCORRECT_TOTAL:
-            attr_val->long_val = stats_.total_uncorrectable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_SDMA_CE:
-            attr_val->long_val = stats_.sdma_correctable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_SDMA_UE:
-            attr_val->long_val = stats_.sdma_uncorrectable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_GFX_CE:
-            attr_val->long_val = stats_.gfx_correctable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_GFX_UE:
-            attr_val->long_val = stats_.gfx_uncorrectable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_MMHUB_CE:
-            attr_val->long_val = stats_.mmhub_correctable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_MMHUB_UE:
-            attr_val->long_val = stats_.mmhub_uncorrectable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_ATHUB_CE:
-            attr_val->long_val = stats_.athub_correctable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_ATHUB_UE:
-            attr_val->long_val = stats_.athub_uncorrectable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_PCIE_BIF_CE:
-            attr_val->long_val = stats_.bif_correctable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_PCIE_BIF_UE:
-            attr_val->long_val = stats_.bif_uncorrectable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_HDP_CE:
-            attr_val->long_val = stats_.hdp_correctable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_HDP_UE:
-            attr_val->long_val = stats_.hdp_uncorrectable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_XGMI_WAFL_CE:
-            attr_val->long_val = stats_.xgmi_wafl_correctable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_XGMI_WAFL_UE:
-            attr_val->long_val = stats_.xgmi_wafl_uncorrectable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_DF_CE:
-            attr_val->long_val = stats_.df_correctable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_DF_UE:
-            attr_val->long_val = stats_.df_uncorrectable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_SMN_CE:
-            attr_val->long_val = stats_.smn_correctable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_SMN_UE:
-            attr_val->long_val = stats_.smn_uncorrectable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_SEM_CE:
-            attr_val->long_val = stats_.sem_correctable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_SEM_UE:
-            attr_val->long_val = stats_.sem_uncorrectable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_MP0_CE:
-            attr_val->long_val = stats_.mp0_correctable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_MP0_UE:
-            attr_val->long_val = stats_.mp0_uncorrectable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_MP1_CE:
-            attr_val->long_val = stats_.mp1_correctable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_MP1_UE:
-            attr_val->long_val = stats_.mp1_uncorrectable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_FUSE_CE:
-            attr_val->long_val = stats_.fuse_correctable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_FUSE_UE:
-            attr_val->long_val = stats_.fuse_uncorrectable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_UMC_CE:
-            attr_val->long_val = stats_.umc_correctable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_UMC_UE:
-            attr_val->long_val = stats_.umc_uncorrectable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_MCA_CE:
-            attr_val->long_val = stats_.mca_correctable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_MCA_UE:
-            attr_val->long_val = stats_.mca_uncorrectable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_VCN_CE:
-            attr_val->long_val = stats_.vcn_correctable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_VCN_UE:
-            attr_val->long_val = stats_.vcn_uncorrectable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_JPEG_CE:
-            attr_val->long_val = stats_.jpeg_correctable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_JPEG_UE:
-            attr_val->long_val = stats_.jpeg_uncorrectable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_IH_CE:
-            attr_val->long_val = stats_.ih_correctable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_IH_UE:
-            attr_val->long_val = stats_.ih_uncorrectable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_MPIO_CE:
-            attr_val->long_val = stats_.mpio_correctable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_ECC_MPIO_UE:
-            attr_val->long_val = stats_.mpio_uncorrectable_errors;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_XGMI_0_NOP_TX:
-            attr_val->long_val = stats_.xgmi_neighbor0_tx_nops;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_XGMI_0_REQ_TX:
-            attr_val->long_val = stats_.xgmi_neighbor0_tx_requests;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_XGMI_0_RESP_TX:
-            attr_val->long_val = stats_.xgmi_neighbor0_tx_responses;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_XGMI_0_BEATS_TX:
-            attr_val->long_val = stats_.xgmi_neighbor0_tx_beats;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_XGMI_1_NOP_TX:
-            attr_val->long_val = stats_.xgmi_neighbor1_tx_nops;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_XGMI_1_REQ_TX:
-            attr_val->long_val = stats_.xgmi_neighbor1_tx_requests;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_XGMI_1_RESP_TX:
-            attr_val->long_val = stats_.xgmi_neighbor1_tx_responses;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_XGMI_1_BEATS_TX:
-            attr_val->long_val = stats_.xgmi_neighbor1_tx_beats;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_XGMI_0_THRPUT:
-            attr_val->long_val = stats_.xgmi_neighbor0_tx_throughput;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_XGMI_1_THRPUT:
-            attr_val->long_val = stats_.xgmi_neighbor1_tx_throughput;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_XGMI_2_THRPUT:
-            attr_val->long_val = stats_.xgmi_neighbor2_tx_throughput;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_XGMI_3_THRPUT:
-            attr_val->long_val = stats_.xgmi_neighbor3_tx_throughput;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_XGMI_4_THRPUT:
-            attr_val->long_val = stats_.xgmi_neighbor4_tx_throughput;
-            break;
-        case AGA_GPU_WATCH_ATTR_ID_XGMI_5_THRPUT:
-            attr_val->long_val = stats_.xgmi_neighbor5_tx_throughput;
-            break;
-        default:
+        ret = gpu_watch_field_get(fields, stats->attr[i].id,
+                                  &attr_val->long_val);
+        if (unlikely(ret != SDK_RET_OK)) {
             AGA_TRACE_ERR("unknown watch attribute {}, GPU {}",
-                          stats->attr[i].id, key_.str());
+                          stats->attr[i].id, stats->gpu.str());
             return SDK_RET_ERR;
         }
+        // stamp the attribute with the time it was last sampled, wall clock
+        // time is derived from the monotonic one so the two always agree
+        capture_ns = fields.attr_capture_ns[stats->attr[i].id];
+        wall_ns = capture_ns ? (fields.capture_wall_ns -
+                                    (fields.capture_mono_ns - capture_ns)) : 0;
+        stats->attr[i].capture_ns = capture_ns;
+        stats->attr[i].timestamp.tv_sec = wall_ns / TIME_NSECS_PER_SEC;
+        stats->attr[i].timestamp.tv_nsec = wall_ns % TIME_NSECS_PER_SEC;
+        stats->attr[i].collection_latency =
+            fields.attr_collection_latency[stats->attr[i].id];
     }
     return SDK_RET_OK;
 }
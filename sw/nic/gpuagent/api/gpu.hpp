@@ -26,10 +26,13 @@ limitations under the License.
 #ifndef __AGA_GPU_HPP__
 #define __AGA_GPU_HPP__
 
+#include <atomic>
+#include "nic/sdk/include/sdk/lock.hpp"
 #include "nic/gpuagent/core/api_base.hpp"
 #include "nic/gpuagent/core/api_params.hpp"
 #include "nic/gpuagent/api/include/aga_gpu.hpp"
 #include "nic/gpuagent/api/include/aga_task.hpp"
+#include "nic/gpuagent/api/gpu_watch_snapshot.hpp"
 
 namespace aga {
 
@@ -98,10 +101,18 @@ public:
     /// \return   SDK_RET_OK or error code
     virtual sdk_ret_t delete_handler(api_params_base *api_params) override;
 
+    /// \brief capture the current spec of the gpu in the given API params
+    /// \param[out] api_params    API parameters to be filled with the spec
+    /// \return   SDK_RET_OK or error code
+    virtual sdk_ret_t backup(api_params_base *api_params) override;
+
     /// \brief          read config
     /// \param[out]     info pointer to the info object
+    /// \param[in]      live true to read everything from the GPU, false to
+    ///                 serve the cached spec and status with only the
+    ///                 runtime varying fields refreshed
     /// \return         SDK_RET_OK on success, failure status code on error
-    sdk_ret_t read(aga_gpu_info_t *info);
+    sdk_ret_t read(aga_gpu_info_t *info, bool live = false);
 
     /// \brief return stringified key of the object (for debugging)
     virtual string key2str(void) const override {
@@ -156,7 +167,31 @@ public:
 
     /// \brief  initialize GPU spec
     void init_spec(void) {
-        fill_spec_(&spec_);
+        aga_gpu_spec_t spec = { 0 };
+
+        fill_spec_(&spec);
+        SDK_SPINLOCK_LOCK(&slock_);
+        memcpy(&spec_, &spec, sizeof(aga_gpu_spec_t));
+        SDK_SPINLOCK_UNLOCK(&slock_);
+    }
+
+    /// \brief  initialize cached GPU status
+    void init_status(void) {
+        aga_gpu_status_t status = {};
+
+        if (!child_gpus_.size()) {
+            fill_status_(&status);
+            SDK_SPINLOCK_LOCK(&slock_);
+            memcpy(&status_, &status, sizeof(aga_gpu_status_t));
+            SDK_SPINLOCK_UNLOCK(&slock_);
+            cache_stale_ = false;
+        }
+    }
+
+    /// \brief  mark the cached GPU spec and status stale so that the next
+    ///         read refreshes them from the GPU (e.g., after GPU reset)
+    void cache_invalidate(void) {
+        cache_stale_ = true;
     }
 
     /// \brief  return parent GPU uuid
@@ -204,7 +239,12 @@ public:
     /// \brief function to return compute partition type
     /// \return partition type
     aga_gpu_compute_partition_type_t compute_partition_type(void) {
-        return spec_.compute_partition_type;
+        aga_gpu_compute_partition_type_t partition_type;
+
+        SDK_SPINLOCK_LOCK(&slock_);
+        partition_type = spec_.compute_partition_type;
+        SDK_SPINLOCK_UNLOCK(&slock_);
+        return partition_type;
     }
 
     /// \brief function to set compute partition type for partitioned GPUs
@@ -214,14 +254,21 @@ public:
         // this function is only used for partitioned GPUs, for child GPUs this
         // is set during init_spec
         if (child_gpus_.size() > 0) {
+            SDK_SPINLOCK_LOCK(&slock_);
             spec_.compute_partition_type = partition_type;
+            SDK_SPINLOCK_UNLOCK(&slock_);
         }
     }
 
     /// \brief function to return memory partition type
     /// \return partition type
     aga_gpu_memory_partition_type_t memory_partition_type(void) {
-        return spec_.memory_partition_type;
+        aga_gpu_memory_partition_type_t partition_type;
+
+        SDK_SPINLOCK_LOCK(&slock_);
+        partition_type = spec_.memory_partition_type;
+        SDK_SPINLOCK_UNLOCK(&slock_);
+        return partition_type;
     }
 
     /// \brief function to set memory partition type for partitioned GPUs
@@ -231,23 +278,26 @@ public:
         // this function is only used for partitioned GPUs, for child GPUs this
         // is set during init_spec
         if (child_gpus_.size() > 0) {
+            SDK_SPINLOCK_LOCK(&slock_);
             spec_.memory_partition_type = partition_type;
+            SDK_SPINLOCK_UNLOCK(&slock_);
         }
     }
 
-    /// \brief     update gpu stats
-    /// \param[in] stats gpu stats read by watcher infra
-    /// \return    SDK_RET_OK on success, failure status code on error
-    sdk_ret_t update_stats(aga_gpu_watch_fields_t *stats);
-
     /// \brief      read topology of the GPU
     /// \param[out] info    pointer to the info object
     /// \return     SDK_RET_OK on success, failure status code on error
     sdk_ret_t read_topology(aga_device_topology_info_t *info);
 
-    /// \brief  return gpu stats
-    /// \return gpu stats
-    sdk_ret_t fill_gpu_watch_stats(aga_gpu_watch_attrs_t *stats);
+    /// \brief      fill gpu watch attributes of a GPU from the watch fields
+    ///             snapshot
+    /// \param[in]  snapshot    pinned GPU watch snapshot
+    /// \param[in]  gpu_id      id of the GPU
+    /// \param[out] stats       gpu watch attributes to be filled
+    /// \return     SDK_RET_OK on success, failure status code on error
+    static sdk_ret_t fill_gpu_watch_stats(
+                         const gpu_watch_snapshot_guard& snapshot,
+                         uint32_t gpu_id, aga_gpu_watch_attrs_t *stats);
 
 private:
     /// \brief constructor
@@ -266,7 +316,14 @@ private:
 
     /// \brief      fill the gpu statistics
     /// \param[out] stats statistics
-    void fill_stats_(aga_gpu_stats_t *stats);
+    /// \param[in]  live  true to bypass the smi cache
+    void fill_stats_(aga_gpu_stats_t *stats, bool live);
+
+    /// \brief      fill the gpu spec and operational status and stash them
+    ///             as the cached spec and status
+    /// \param[out] spec   config specification
+    /// \param[out] status operational status
+    void refresh_cache_(aga_gpu_spec_t *spec, aga_gpu_status_t *status);
 
 private:
     /// uuid of the object
@@ -283,8 +340,14 @@ private:
     aga_gpu_handle_t handle_;
     /// GPU spec
     aga_gpu_spec_t spec_;
-    /// GPU watch stats
-    aga_gpu_watch_fields_t stats_;
+    /// cached GPU status, served to reads with the runtime varying fields
+    /// refreshed; valid only for non-parent GPUs
+    aga_gpu_status_t status_;
+    /// true if spec_ and status_ have to be refreshed before being served
+    std::atomic<bool> cache_stale_;
+    /// lock protecting every access to spec_ and status_, as they are
+    /// refreshed from the gRPC threads and updated from the API thread
+    sdk_spinlock_t slock_;
     /// number of GPU watch objects watching this GPU
     uint32_t num_gpu_watch_;
     /// a friend of gpu entry
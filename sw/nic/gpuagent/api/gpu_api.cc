@@ -37,7 +37,8 @@ limitations under the License.
 #include "nic/gpuagent/api/smi/smi_api.hpp"
 
 static sdk_ret_t
-aga_gpu_api_handle (api_op_t op, aga_obj_key_t *key, aga_gpu_spec_t *spec)
+aga_gpu_api_handle (aga_batch_ctxt_t bctxt, api_op_t op, aga_obj_key_t *key,
+                    aga_gpu_spec_t *spec)
 {
     sdk_ret_t ret;
     api_ctxt_t *api_ctxt;
@@ -54,7 +55,7 @@ aga_gpu_api_handle (api_op_t op, aga_obj_key_t *key, aga_gpu_spec_t *spec)
         } else {
             AGA_API_PARAMS_FROM_API_CTXT(api_ctxt)->gpu_spec = *spec;
         }
-        return process_api(api_ctxt);
+        return process_api(bctxt, api_ctxt);
     }
     return SDK_RET_OOM;
 }
@@ -77,13 +78,14 @@ aga_gpu_entry_find (_In_ aga_obj_key_t *key, _Out_ gpu_entry **gpu)
 }
 
 sdk_ret_t
-aga_gpu_create (_In_ aga_gpu_spec_t *spec)
+aga_gpu_create (_In_ aga_gpu_spec_t *spec, _In_ aga_batch_ctxt_t bctxt)
 {
-    return aga_gpu_api_handle(API_OP_CREATE, NULL, spec);
+    return aga_gpu_api_handle(bctxt, API_OP_CREATE, NULL, spec);
 }
 
 sdk_ret_t
-aga_gpu_read (_In_ aga_obj_key_t *key, _Out_ aga_gpu_info_t *info)
+aga_gpu_read (_In_ aga_obj_key_t *key, _Out_ aga_gpu_info_t *info,
+              _In_ bool live)
 {
     sdk_ret_t ret;
     gpu_entry *entry;
@@ -95,12 +97,13 @@ aga_gpu_read (_In_ aga_obj_key_t *key, _Out_ aga_gpu_info_t *info)
     if (unlikely(ret != SDK_RET_OK)) {
         return ret;
     }
-    return entry->read(info);
+    return entry->read(info, live);
 }
 
 typedef struct aga_gpu_read_args_s {
     void *ctxt;
     gpu_read_cb_t cb;
+    bool live;
 } aga_gpu_read_args_t;
 
 static bool
@@ -116,19 +119,20 @@ aga_gpu_info_from_entry (void *entry, void *ctxt)
     }
     memset(&info, 0, sizeof(aga_gpu_info_t));
     // call entry read
-    gpu->read(&info);
+    gpu->read(&info, args->live);
     // call cb on info
     args->cb(&info, args->ctxt);
     return false;
 }
 
 sdk_ret_t
-aga_gpu_read_all (gpu_read_cb_t gpu_read_cb, void *ctxt)
+aga_gpu_read_all (gpu_read_cb_t gpu_read_cb, void *ctxt, bool live)
 {
     aga_gpu_read_args_t args = { 0 };
 
     args.ctxt = ctxt;
     args.cb = gpu_read_cb;
+    args.live = live;
     return gpu_db()->walk(aga_gpu_info_from_entry, &args);
 }
 
@@ -210,13 +214,15 @@ aga_gpu_compute_partition_read_all (gpu_compute_partition_read_cb_t read_cb,
 sdk_ret_t
 aga_gpu_compute_partition_set (_In_ aga_gpu_spec_t *spec)
 {
-    return aga_gpu_api_handle(API_OP_UPDATE, NULL, spec);
+    return aga_gpu_api_handle(AGA_BATCH_CTXT_INVALID, API_OP_UPDATE, NULL,
+                              spec);
 }
 
 sdk_ret_t
 aga_gpu_memory_partition_set (_In_ aga_gpu_spec_t *spec)
 {
-    return aga_gpu_api_handle(API_OP_UPDATE, NULL, spec);
+    return aga_gpu_api_handle(AGA_BATCH_CTXT_INVALID, API_OP_UPDATE, NULL,
+                              spec);
 }
 
 sdk_ret_t
@@ -388,13 +394,13 @@ aga_gpu_read_topology_all (device_topology_read_cb_t gpu_topology_read_cb,
 }
 
 sdk_ret_t
-aga_gpu_update (_In_ aga_gpu_spec_t *spec)
+aga_gpu_update (_In_ aga_gpu_spec_t *spec, _In_ aga_batch_ctxt_t bctxt)
 {
-    return aga_gpu_api_handle(API_OP_UPDATE, NULL, spec);
+    return aga_gpu_api_handle(bctxt, API_OP_UPDATE, NULL, spec);
 }
 
 sdk_ret_t
-aga_gpu_delete (_In_ aga_obj_key_t *key)
+aga_gpu_delete (_In_ aga_obj_key_t *key, _In_ aga_batch_ctxt_t bctxt)
 {
-    return aga_gpu_api_handle(API_OP_DELETE, key, NULL);
+    return aga_gpu_api_handle(bctxt, API_OP_DELETE, key, NULL);
 }
@@ -45,12 +45,10 @@ gpu_state::insert(gpu_entry *gpu) {
     sdk_ret_t ret;
 
     AGA_TRACE_DEBUG("Inserting GPU {} in db", gpu->key_.str());
-    auto it = gpu_key_db_.find(gpu->key_);
-    if (it != gpu_key_db_.end()) {
+    if (!gpu_key_db_.insert(gpu->key_, gpu)) {
         AGA_STATE_CNTR_INSERT_ERR_INC();
         ret = SDK_RET_ENTRY_EXISTS;
     } else {
-        gpu_key_db_[gpu->key_] = gpu;
         AGA_STATE_CNTR_INSERT_OK_INC();
         AGA_STATE_CNTR_NUM_ELEMS_INC();
         ret = SDK_RET_OK;
@@ -60,31 +58,26 @@ gpu_state::insert(gpu_entry *gpu) {
 
 sdk_ret_t
 gpu_state::insert_in_handle_db(gpu_entry *gpu) {
-    sdk_ret_t ret;
-
     AGA_TRACE_DEBUG("Inserting GPU {} with handle {} in db", gpu->key_.str(),
                     gpu->handle_);
-    gpu_db_[gpu->handle_] = gpu;
-    return ret;
+    gpu_db_.insert(gpu->handle_, gpu, true);
+    return SDK_RET_OK;
 }
 
 gpu_entry *
 gpu_state::remove(gpu_entry *gpu) {
-    void *rv;
+    gpu_entry *rv;
 
-    auto it = gpu_key_db_.find(gpu->key_);
-    if (it == gpu_key_db_.end()) {
+    if (!gpu_key_db_.erase(gpu->key_, &rv)) {
         AGA_STATE_CNTR_REMOVE_ERR_INC();
         rv = NULL;
     } else {
-        rv = it->second;
-        gpu_key_db_.erase(gpu->key_);
         // remove from handles db
-        gpu_db_.erase(gpu->handle_);
+        gpu_db_.erase(gpu->handle_, NULL);
         AGA_STATE_CNTR_REMOVE_OK_INC();
         AGA_STATE_CNTR_NUM_ELEMS_DEC();
     }
-    return (gpu_entry *)rv;
+    return rv;
 }
 
 void
@@ -94,45 +87,37 @@ gpu_state::free(gpu_entry *gpu) {
 
 gpu_entry *
 gpu_state::find(aga_obj_key_t *key) const {
-    auto it = gpu_key_db_.find(*key);
-    if (it != gpu_key_db_.end()) {
-        return it->second;
+    gpu_entry *gpu;
+
+    if (gpu_key_db_.find(*key, &gpu)) {
+        return gpu;
     }
     return NULL;
 }
 
 gpu_entry *
 gpu_state::find(aga_gpu_handle_t handle) const {
-    auto it = gpu_db_.find(handle);
-    if (it != gpu_db_.end()) {
-        return it->second;
+    gpu_entry *gpu;
+
+    if (gpu_db_.find(handle, &gpu)) {
+        return gpu;
     }
     return NULL;
 }
 
 sdk_ret_t
 gpu_state::walk(state_walk_cb_t walk_cb, void *ctxt) {
-    bool stop;
-
-    for (auto iter = gpu_key_db_.begin(); iter != gpu_key_db_.end(); ++iter) {
-        stop = walk_cb(iter->second, ctxt);
-        if (stop) {
-            break;
-        }
-    }
+    gpu_key_db_.walk([walk_cb, ctxt](gpu_entry *gpu) {
+        return walk_cb(gpu, ctxt);
+    });
     return SDK_RET_OK;
 }
 
 sdk_ret_t
 gpu_state::walk_handle_db(state_walk_cb_t walk_cb, void *ctxt) {
-    bool stop;
-
-    for (auto iter = gpu_db_.begin(); iter != gpu_db_.end(); ++iter) {
-        stop = walk_cb(iter->second, ctxt);
-        if (stop) {
-            break;
-        }
-    }
+    gpu_db_.walk([walk_cb, ctxt](gpu_entry *gpu) {
+        return walk_cb(gpu, ctxt);
+    });
     return SDK_RET_OK;
 }
 
@@ -26,19 +26,18 @@ limitations under the License.
 #ifndef __AGA_GPU_STATE_HPP__
 #define __AGA_GPU_STATE_HPP__
 
-#include <unordered_map>
 #include "nic/gpuagent/api/gpu.hpp"
 #include "nic/gpuagent/core/state_base.hpp"
+#include "nic/gpuagent/core/rcu_db.hpp"
 #include "nic/gpuagent/api/aga_state.hpp"
 
 namespace aga {
 
 /// \brief gpu entry map with handle as the key
-typedef std::unordered_map<aga_gpu_handle_t, gpu_entry *> gpu_db_t;
+typedef rcu_db<aga_gpu_handle_t, gpu_entry *> gpu_db_t;
 
 /// \brief gpu entry map with uuid as the key
-typedef std::unordered_map<aga_obj_key_t, gpu_entry *,
-                           aga_obj_key_hash> gpu_key_db_t;
+typedef rcu_db<aga_obj_key_t, gpu_entry *, aga_obj_key_hash> gpu_key_db_t;
 
 /// \defgroup AGA_GPU_STATE - GPU state functionality
 /// \ingroup AGA
@@ -92,8 +91,8 @@ public:
     /// \return   SDK_RET_OK on success, failure status code on error
     virtual sdk_ret_t walk(state_walk_cb_t walk_cb, void *ctxt) override;
 
-    /// \brief API to walk all the handle db elements without taking a lock; use
-    ///        only to access the key fields in the GPU entry
+    /// \brief API to walk all the handle db elements; use only to access the
+    ///        key fields in the GPU entry
     /// \param[in] walk_cb    callback to be invoked for every node
     /// \param[in] ctxt       opaque context passed back to the callback
     /// \return   SDK_RET_OK on success, failure status code on error
@@ -106,6 +105,8 @@ private:
     friend class gpu_entry;
 
 private:
+    /// NOTE: both the dbs are read without any locks from gRPC, watcher and
+    ///       event threads while the API thread updates them, see rcu_db
     /// map to store GPU objects keyed by uuid
     gpu_key_db_t gpu_key_db_;
     /// map to store GPU objects keyed by handle
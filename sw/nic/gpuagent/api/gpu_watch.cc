@@ -26,6 +26,7 @@ limitations under the License.
 #include "nic/gpuagent/core/trace.hpp"
 #include "nic/gpuagent/api/mem.hpp"
 #include "nic/gpuagent/api/gpu_watch.hpp"
+#include "nic/gpuagent/api/gpu_watch_sched.hpp"
 #include "nic/gpuagent/api/aga_state.hpp"
 #include "nic/gpuagent/api/internal/aga_api_params.hpp"
 
@@ -81,8 +82,49 @@ gpu_watch_entry::delay_delete(void) {
 
 sdk_ret_t
 gpu_watch_entry::create_handler(api_params_base *api_params) {
+    std::vector<uint32_t> gpu_ids;
     aga_gpu_watch_spec_t *spec = AGA_GPU_WATCH_SPEC(api_params);
 
+    if (spec->sampling_interval == 0) {
+        spec->sampling_interval = AGA_GPU_WATCH_SAMPLING_INTERVAL_DEFAULT;
+    } else if ((spec->sampling_interval >
+                    AGA_GPU_WATCH_SAMPLING_INTERVAL_MAX) ||
+               (spec->sampling_interval %
+                    AGA_GPU_WATCH_SAMPLING_INTERVAL_MIN)) {
+        AGA_TRACE_ERR("Failed to create GPU watch {}, sampling interval {}ms "
+                      "is not a multiple of {}ms or exceeds {}ms",
+                      spec->key.str(), spec->sampling_interval,
+                      AGA_GPU_WATCH_SAMPLING_INTERVAL_MIN,
+                      AGA_GPU_WATCH_SAMPLING_INTERVAL_MAX);
+        return SDK_RET_INVALID_ARG;
+    }
+    if (spec->agg_window) {
+        if ((spec->agg_window > AGA_GPU_WATCH_AGG_WINDOW_MAX) ||
+            (spec->agg_window % spec->sampling_interval)) {
+            AGA_TRACE_ERR("Failed to create GPU watch {}, aggregation window "
+                          "{}ms is not a multiple of sampling interval {}ms "
+                          "or exceeds {}ms", spec->key.str(),
+                          spec->agg_window, spec->sampling_interval,
+                          AGA_GPU_WATCH_AGG_WINDOW_MAX);
+            return SDK_RET_INVALID_ARG;
+        }
+        for (uint8_t i = 0; i < spec->num_agg_stats; i++) {
+            if ((spec->agg_stat[i] == AGA_GPU_WATCH_AGG_STAT_NONE) ||
+                (spec->agg_stat[i] >= AGA_GPU_WATCH_AGG_STATS_MAX)) {
+                AGA_TRACE_ERR("Failed to create GPU watch {}, invalid "
+                              "aggregation statistic {}", spec->key.str(),
+                              spec->agg_stat[i]);
+                return SDK_RET_INVALID_ARG;
+            }
+        }
+        if (spec->num_agg_stats == 0) {
+            spec->agg_stat[spec->num_agg_stats++] = AGA_GPU_WATCH_AGG_STAT_MIN;
+            spec->agg_stat[spec->num_agg_stats++] = AGA_GPU_WATCH_AGG_STAT_MAX;
+            spec->agg_stat[spec->num_agg_stats++] = AGA_GPU_WATCH_AGG_STAT_AVG;
+        }
+    } else {
+        spec->num_agg_stats = 0;
+    }
     for (uint8_t i = 0; i < spec->num_gpu; i++) {
         auto gpu = gpu_db()->find(&spec->gpu[i]);
         if (unlikely(gpu == NULL)) {
@@ -90,10 +132,27 @@ gpu_watch_entry::create_handler(api_params_base *api_params) {
                           spec->key.str(), spec->gpu[i].str());
             return SDK_RET_INVALID_ARG;
         }
+        if (unlikely(gpu->is_parent_gpu())) {
+            // parent GPUs aren't sampled, their partitions are
+            AGA_TRACE_ERR("Failed to create GPU watch {}, GPU {} is "
+                          "partitioned, watch its partitions instead",
+                          spec->key.str(), spec->gpu[i].str());
+            return SDK_RET_INVALID_ARG;
+        }
+    }
+    for (uint8_t i = 0; i < spec->num_gpu; i++) {
+        auto gpu = gpu_db()->find(&spec->gpu[i]);
+
         gpu->gpu_watch_add();
+        gpu_ids.push_back(gpu->id());
+        // resolve the GPU once, reads index the watch fields by GPU id
+        gpu_id_[i] = gpu->id();
     }
     key_ = spec->key;
     memcpy(&spec_, spec, sizeof(aga_gpu_watch_spec_t));
+    // let the watcher know how often these attributes need to be sampled
+    g_gpu_watch_sched.watch_add(key_, gpu_ids, spec_.attr_id, spec_.num_attrs,
+                                spec_.sampling_interval);
     return SDK_RET_OK;
 }
 
@@ -112,6 +171,7 @@ gpu_watch_entry::delete_handler(api_params_base *api_params) {
             gpu->gpu_watch_dec();
         }
     }
+    g_gpu_watch_sched.watch_del(key_);
     return SDK_RET_OK;
 }
 
@@ -120,6 +180,14 @@ gpu_watch_entry::update_handler(api_params_base *api_params) {
     return SDK_RET_INVALID_OP;
 }
 
+sdk_ret_t
+gpu_watch_entry::backup(api_params_base *api_params) {
+    aga_gpu_watch_spec_t *spec = AGA_GPU_WATCH_SPEC(api_params);
+
+    fill_spec_(spec);
+    return SDK_RET_OK;
+}
+
 void
 gpu_watch_entry::fill_spec_(aga_gpu_watch_spec_t *spec) {
     memcpy(spec, &spec_, sizeof(aga_gpu_watch_spec_t));
@@ -132,21 +200,22 @@ gpu_watch_entry::fill_status_(aga_gpu_watch_status_t *status) {
 
 void
 gpu_watch_entry::fill_stats_(aga_gpu_watch_stats_t *stats) {
-    gpu_entry *entry;
+    gpu_watch_snapshot_guard snapshot;
 
     stats->num_gpu = spec_.num_gpu;
+    stats->gpu_watch_attr.resize(spec_.num_gpu);
     for (auto gid = 0; gid < spec_.num_gpu; gid++) {
-        entry = gpu_db()->find(&spec_.gpu[gid]);
-        if (entry == NULL) {
-            // should not happen unless gpu uuid is unknown
-            continue;
-        }
-        stats->gpu_watch_attr[gid].gpu = spec_.gpu[gid];
-        stats->gpu_watch_attr[gid].num_attrs = spec_.num_attrs;
+        auto& gpu_attrs = stats->gpu_watch_attr[gid];
+
+        gpu_attrs.gpu = spec_.gpu[gid];
+        gpu_attrs.num_attrs = spec_.num_attrs;
+        gpu_attrs.attr.resize(spec_.num_attrs);
         for (auto i = 0; i < spec_.num_attrs; i++) {
-            stats->gpu_watch_attr[gid].attr[i].id = spec_.attr_id[i];
+            gpu_attrs.attr[i].id = spec_.attr_id[i];
+            // reused info may carry the aggregates of another watch
+            gpu_attrs.attr[i].agg.clear();
         }
-        entry->fill_gpu_watch_stats(&stats->gpu_watch_attr[gid]);
+        gpu_entry::fill_gpu_watch_stats(snapshot, gpu_id_[gid], &gpu_attrs);
     }
 }
 
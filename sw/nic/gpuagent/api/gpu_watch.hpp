@@ -86,6 +86,11 @@ public:
     /// \return   SDK_RET_OK or error code
     virtual sdk_ret_t delete_handler(api_params_base *api_params) override;
 
+    /// \brief capture the spec of the gpu watch in the given API params
+    /// \param[out] api_params    API parameters to be filled with the spec
+    /// \return   SDK_RET_OK or error code
+    virtual sdk_ret_t backup(api_params_base *api_params) override;
+
     /// \brief          read config
     /// \param[out]     info pointer to the info object
     /// \return         SDK_RET_OK on success, failure status code on error
@@ -148,6 +153,8 @@ private:
     aga_obj_key_t key_;
     /// GPU watch spec
     aga_gpu_watch_spec_t spec_;
+    /// ids of the GPUs in the spec, resolved when the watch is created
+    uint8_t gpu_id_[AGA_MAX_GPU];
     /// number of subscribers
     uint8_t num_subscriber_;
     /// operational state
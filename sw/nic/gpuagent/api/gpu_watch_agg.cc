@@ -0,0 +1,282 @@
+
+/*
+Copyright (c) Advanced Micro Devices, Inc. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+//----------------------------------------------------------------------------
+///
+/// \file
+/// GPU watch aggregation implementation
+///
+//----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include "nic/gpuagent/api/gpu_watch_agg.hpp"
+
+namespace aga {
+
+/// \defgroup AGA_GPU_WATCH_AGG - GPU watch aggregation functionality
+/// \ingroup AGA_GPU_WATCH
+/// \@{
+
+gpu_watch_quantile::gpu_watch_quantile(double q) {
+    q_ = q;
+    count_ = 0;
+    for (uint32_t i = 0; i < 5; i++) {
+        height_[i] = 0;
+        pos_[i] = i + 1;
+    }
+    desired_[0] = 1;
+    desired_[1] = 1 + (2 * q);
+    desired_[2] = 1 + (4 * q);
+    desired_[3] = 3 + (2 * q);
+    desired_[4] = 5;
+}
+
+void
+gpu_watch_quantile::adjust_(uint32_t i, int dir) {
+    double h;
+
+    // piecewise parabolic prediction of the marker height
+    h = height_[i] + (dir / (pos_[i + 1] - pos_[i - 1])) *
+            (((pos_[i] - pos_[i - 1] + dir) * (height_[i + 1] - height_[i]) /
+                  (pos_[i + 1] - pos_[i])) +
+             ((pos_[i + 1] - pos_[i] - dir) * (height_[i] - height_[i - 1]) /
+                  (pos_[i] - pos_[i - 1])));
+    if ((h <= height_[i - 1]) || (h >= height_[i + 1])) {
+        // parabola overshoots the neighbours, fall back to linear
+        h = height_[i] + dir * (height_[i + dir] - height_[i]) /
+                (pos_[i + dir] - pos_[i]);
+    }
+    height_[i] = h;
+    pos_[i] += dir;
+}
+
+void
+gpu_watch_quantile::add(double x) {
+    uint32_t k;
+    double d;
+    const double incr[5] = { 0, q_ / 2, q_, (1 + q_) / 2, 1 };
+
+    if (count_ < 5) {
+        height_[count_++] = x;
+        if (count_ == 5) {
+            std::sort(height_, height_ + 5);
+        }
+        return;
+    }
+    // find the cell the sample falls in, extending the extremes if needed
+    if (x < height_[0]) {
+        height_[0] = x;
+        k = 0;
+    } else if (x >= height_[4]) {
+        height_[4] = x;
+        k = 3;
+    } else {
+        for (k = 0; (k < 3) && (x >= height_[k + 1]); k++);
+    }
+    for (uint32_t i = k + 1; i < 5; i++) {
+        pos_[i]++;
+    }
+    for (uint32_t i = 0; i < 5; i++) {
+        desired_[i] += incr[i];
+    }
+    // move the middle markers towards their desired positions
+    for (uint32_t i = 1; i < 4; i++) {
+        d = desired_[i] - pos_[i];
+        if (((d >= 1) && ((pos_[i + 1] - pos_[i]) > 1)) ||
+            ((d <= -1) && ((pos_[i - 1] - pos_[i]) < -1))) {
+            adjust_(i, (d > 0) ? 1 : -1);
+        }
+    }
+    count_++;
+}
+
+double
+gpu_watch_quantile::value(void) const {
+    double sorted[5];
+
+    if (count_ == 0) {
+        return 0;
+    }
+    if (count_ < 5) {
+        // too few samples for the markers, pick the nearest rank
+        std::copy(height_, height_ + count_, sorted);
+        std::sort(sorted, sorted + count_);
+        return sorted[(uint32_t)std::lround(q_ * (count_ - 1))];
+    }
+    return height_[2];
+}
+
+/// \brief     return the quantile a statistic stands for
+/// \param[in] stat    aggregation statistic
+/// \return    quantile in (0, 1), 0 if the statistic is not a quantile
+static inline double
+gpu_watch_agg_stat_quantile_ (aga_gpu_watch_agg_stat_t stat)
+{
+    switch (stat) {
+    case AGA_GPU_WATCH_AGG_STAT_P50:
+        return 0.5;
+    case AGA_GPU_WATCH_AGG_STAT_P90:
+        return 0.9;
+    case AGA_GPU_WATCH_AGG_STAT_P95:
+        return 0.95;
+    case AGA_GPU_WATCH_AGG_STAT_P99:
+        return 0.99;
+    default:
+        return 0;
+    }
+}
+
+/// \brief     return the value of an attribute as a double
+/// \param[in] attr    watch attribute
+/// \return    attribute value, 0 for non numeric attributes
+static inline double
+gpu_watch_attr_value_ (const aga_gpu_watch_attr_t& attr)
+{
+    switch (attr.value.type) {
+    case AGA_GPU_WATCH_ATTR_VALUE_TYPE_LONG:
+        return (double)attr.value.long_val;
+    case AGA_GPU_WATCH_ATTR_VALUE_TYPE_FLOAT:
+        return attr.value.float_val;
+    default:
+        return 0;
+    }
+}
+
+gpu_watch_agg::gpu_watch_agg() {
+    reset();
+}
+
+void
+gpu_watch_agg::reset(void) {
+    stats_.clear();
+    attr_.clear();
+    num_gpu_ = 0;
+    num_attrs_ = 0;
+    samples_per_window_ = 0;
+    num_samples_ = 0;
+}
+
+void
+gpu_watch_agg::init_(const aga_gpu_watch_spec_t& spec) {
+    double q;
+    attr_agg_t agg = {};
+
+    stats_.assign(spec.agg_stat, spec.agg_stat + spec.num_agg_stats);
+    num_gpu_ = spec.num_gpu;
+    num_attrs_ = spec.num_attrs;
+    samples_per_window_ = spec.agg_window / spec.sampling_interval;
+    num_samples_ = 0;
+    for (auto stat : stats_) {
+        if ((q = gpu_watch_agg_stat_quantile_(stat)) != 0) {
+            agg.quantile.emplace_back(q);
+        }
+    }
+    attr_.assign(spec.num_gpu * num_attrs_, agg);
+}
+
+bool
+gpu_watch_agg::init_done_(const aga_gpu_watch_spec_t& spec) const {
+    if (stats_.empty() || (num_gpu_ != spec.num_gpu) ||
+        (num_attrs_ != spec.num_attrs) ||
+        (samples_per_window_ != (spec.agg_window / spec.sampling_interval)) ||
+        (stats_.size() != spec.num_agg_stats)) {
+        return false;
+    }
+    return std::equal(stats_.begin(), stats_.end(), spec.agg_stat);
+}
+
+void
+gpu_watch_agg::add(const aga_gpu_watch_spec_t& spec,
+                   const aga_gpu_watch_stats_t& stats) {
+    double x;
+
+    if (!init_done_(spec)) {
+        // spec changed under the window, the samples so far don't add up
+        // with the new ones so start afresh
+        init_(spec);
+    }
+    for (uint32_t g = 0; g < stats.num_gpu; g++) {
+        const auto& gpu_attrs = stats.gpu_watch_attr[g];
+
+        for (uint32_t a = 0; a < gpu_attrs.num_attrs; a++) {
+            auto& agg = attr_[(g * num_attrs_) + a];
+
+            x = gpu_watch_attr_value_(gpu_attrs.attr[a]);
+            if (num_samples_ == 0) {
+                agg.min = agg.max = x;
+                agg.sum = 0;
+            } else {
+                agg.min = std::min(agg.min, x);
+                agg.max = std::max(agg.max, x);
+            }
+            agg.sum += x;
+            for (auto& quantile : agg.quantile) {
+                quantile.add(x);
+            }
+        }
+    }
+    num_samples_++;
+}
+
+void
+gpu_watch_agg::fill(aga_gpu_watch_stats_t *stats) {
+    uint32_t nq;
+    aga_gpu_watch_agg_value_t agg_val;
+
+    for (uint32_t g = 0; g < stats->num_gpu; g++) {
+        auto& gpu_attrs = stats->gpu_watch_attr[g];
+
+        for (uint32_t a = 0; a < gpu_attrs.num_attrs; a++) {
+            auto& attr = gpu_attrs.attr[a];
+            auto& agg = attr_[(g * num_attrs_) + a];
+
+            // statistics are published instead of the latest sample
+            attr.value.type = AGA_GPU_WATCH_ATTR_VALUE_TYPE_NONE;
+            attr.agg.clear();
+            nq = 0;
+            for (auto stat : stats_) {
+                agg_val.stat = stat;
+                switch (stat) {
+                case AGA_GPU_WATCH_AGG_STAT_MIN:
+                    agg_val.value = agg.min;
+                    break;
+                case AGA_GPU_WATCH_AGG_STAT_MAX:
+                    agg_val.value = agg.max;
+                    break;
+                case AGA_GPU_WATCH_AGG_STAT_AVG:
+                    agg_val.value = agg.sum / num_samples_;
+                    break;
+                default:
+                    agg_val.value = agg.quantile[nq++].value();
+                    break;
+                }
+                attr.agg.push_back(agg_val);
+            }
+            // start the next window
+            for (auto& quantile : agg.quantile) {
+                quantile = gpu_watch_quantile(quantile.q());
+            }
+        }
+    }
+    num_samples_ = 0;
+}
+
+/// \@}
+
+}    // namespace aga
@@ -0,0 +1,155 @@
+
+/*
+Copyright (c) Advanced Micro Devices, Inc. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+//----------------------------------------------------------------------------
+///
+/// \file
+/// windowed aggregation of GPU watch attributes published to subscribers
+///
+//----------------------------------------------------------------------------
+
+#ifndef __AGA_GPU_WATCH_AGG_HPP__
+#define __AGA_GPU_WATCH_AGG_HPP__
+
+#include <vector>
+#include "nic/sdk/include/sdk/base.hpp"
+#include "nic/gpuagent/api/include/aga_gpu_watch.hpp"
+
+/// \defgroup AGA_GPU_WATCH_AGG - GPU watch aggregation functionality
+/// \ingroup AGA
+/// @{
+
+namespace aga {
+
+/// \brief    streaming estimator of a quantile using the P-square algorithm
+///           (Jain & Chlamtac), keeps five markers instead of the samples so
+///           the memory and the cost per sample are constant irrespective of
+///           the window size
+class gpu_watch_quantile {
+public:
+    /// \brief     constructor
+    /// \param[in] q    quantile to estimate, in (0, 1)
+    gpu_watch_quantile(double q);
+
+    /// \brief     add a sample
+    /// \param[in] x    sample value
+    void add(double x);
+
+    /// \brief    return the estimated quantile of the samples added so far
+    /// \return   estimated quantile, 0 if no sample is added
+    double value(void) const;
+
+    /// \brief    return the quantile being estimated
+    /// \return   quantile
+    double q(void) const {
+        return q_;
+    }
+
+private:
+    /// \brief     move marker i by one position in the given direction
+    /// \param[in] i      marker index
+    /// \param[in] dir    +1 or -1
+    void adjust_(uint32_t i, int dir);
+
+private:
+    /// quantile being estimated
+    double q_;
+    /// no. of samples added so far
+    uint64_t count_;
+    /// marker heights, first five samples until there are five
+    double height_[5];
+    /// actual and desired positions of the markers
+    double pos_[5];
+    double desired_[5];
+};
+
+/// \brief    running statistics of every attribute of every GPU of a watch
+///           over the current aggregation window
+/// \remark   owned and fed by the watcher thread as the watch samples are
+///           published, so no locking is needed
+class gpu_watch_agg {
+public:
+    /// \brief constructor
+    gpu_watch_agg();
+
+    /// \brief destructor
+    ~gpu_watch_agg() {}
+
+    /// \brief    forget the current window and the spec it was set up for,
+    ///           next sample starts afresh
+    void reset(void);
+
+    /// \brief     add the samples of all the GPUs of a watch to the window
+    /// \param[in] spec     spec of the watch
+    /// \param[in] stats    latest samples of the watch
+    void add(const aga_gpu_watch_spec_t& spec,
+             const aga_gpu_watch_stats_t& stats);
+
+    /// \brief    check if the current window has all its samples
+    /// \return   true if the window is complete, false otherwise
+    bool window_done(void) const {
+        return num_samples_ && (num_samples_ >= samples_per_window_);
+    }
+
+    /// \brief      replace the attribute values with their statistics over
+    ///             the current window and start a new window
+    /// \param[out] stats    stats of the watch to be published
+    void fill(aga_gpu_watch_stats_t *stats);
+
+private:
+    /// \brief    running statistics of an attribute of a GPU
+    typedef struct attr_agg_s {
+        double min;
+        double max;
+        double sum;
+        /// estimators of the quantiles in the spec, in the spec order
+        std::vector<gpu_watch_quantile> quantile;
+    } attr_agg_t;
+
+    /// \brief     set up the running statistics for a watch
+    /// \param[in] spec    spec of the watch
+    void init_(const aga_gpu_watch_spec_t& spec);
+
+    /// \brief     check if the running statistics are set up for the given
+    ///            spec, watch may have been recreated with a different one
+    /// \param[in] spec    spec of the watch
+    /// \return    true if the spec matches, false otherwise
+    bool init_done_(const aga_gpu_watch_spec_t& spec) const;
+
+private:
+    /// statistics computed, in the spec order
+    std::vector<aga_gpu_watch_agg_stat_t> stats_;
+    /// no. of GPUs watched
+    uint32_t num_gpu_;
+    /// no. of attributes watched per GPU
+    uint32_t num_attrs_;
+    /// no. of samples that make a window
+    uint32_t samples_per_window_;
+    /// no. of samples in the current window
+    uint32_t num_samples_;
+    /// running statistics indexed by (GPU index * num_attrs_ + attr index)
+    std::vector<attr_agg_t> attr_;
+};
+
+/// \@}
+
+}    // namespace aga
+
+using aga::gpu_watch_agg;
+
+#endif    // __AGA_GPU_WATCH_AGG_HPP__
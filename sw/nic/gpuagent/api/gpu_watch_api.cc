@@ -25,6 +25,7 @@ limitations under the License.
 
 #include "nic/sdk/include/sdk/base.hpp"
 #include "nic/sdk/include/sdk/assert.hpp"
+#include "nic/sdk/include/sdk/timestamp.hpp"
 #include "nic/sdk/lib/ipc/ipc.hpp"
 #include "nic/gpuagent/core/trace.hpp"
 #include "nic/gpuagent/core/aga_core.hpp"
@@ -36,11 +37,13 @@ limitations under the License.
 #include "nic/gpuagent/api/internal/aga_api_params.hpp"
 #include "nic/gpuagent/api/include/aga_gpu_watch.hpp"
 #include "nic/gpuagent/api/gpu_watch.hpp"
+#include "nic/gpuagent/api/gpu_watch_history.hpp"
+#include "nic/gpuagent/api/gpu.hpp"
 #include "nic/gpuagent/api/aga_state.hpp"
 
 static sdk_ret_t
-aga_gpu_watch_api_handle (api_op_t op, aga_obj_key_t *key,
-                          aga_gpu_watch_spec_t *spec)
+aga_gpu_watch_api_handle (aga_batch_ctxt_t bctxt, api_op_t op,
+                          aga_obj_key_t *key, aga_gpu_watch_spec_t *spec)
 {
     sdk_ret_t ret;
     api_ctxt_t *api_ctxt;
@@ -57,7 +60,7 @@ aga_gpu_watch_api_handle (api_op_t op, aga_obj_key_t *key,
         } else {
             AGA_API_PARAMS_FROM_API_CTXT(api_ctxt)->gpu_watch_spec = *spec;
         }
-        return process_api(api_ctxt);
+        return process_api(bctxt, api_ctxt);
     }
     return SDK_RET_OOM;
 }
@@ -80,9 +83,10 @@ aga_gpu_watch_entry_find (_In_ aga_obj_key_t *key, _Out_ gpu_watch_entry **gpu)
 }
 
 sdk_ret_t
-aga_gpu_watch_create (_In_ aga_gpu_watch_spec_t *spec)
+aga_gpu_watch_create (_In_ aga_gpu_watch_spec_t *spec,
+                      _In_ aga_batch_ctxt_t bctxt)
 {
-    return aga_gpu_watch_api_handle(API_OP_CREATE, NULL, spec);
+    return aga_gpu_watch_api_handle(bctxt, API_OP_CREATE, NULL, spec);
 }
 
 sdk_ret_t
@@ -117,7 +121,6 @@ aga_gpu_watch_info_from_entry (void *entry, void *ctxt)
         // some API operation is in progress on this object, skip it
         return false;
     }
-    memset(&info, 0, sizeof(aga_gpu_watch_info_t));
     // call entry read
     gpu_watch->read(&info);
     // call cb on info
@@ -136,9 +139,118 @@ aga_gpu_watch_read_all (gpu_watch_read_cb_t gpu_watch_read_cb, void *ctxt)
 }
 
 sdk_ret_t
-aga_gpu_watch_delete (_In_ aga_obj_key_t *key)
+aga_gpu_watch_delete (_In_ aga_obj_key_t *key, _In_ aga_batch_ctxt_t bctxt)
 {
-    return aga_gpu_watch_api_handle(API_OP_DELETE, key, NULL);
+    return aga_gpu_watch_api_handle(bctxt, API_OP_DELETE, key, NULL);
+}
+
+typedef struct aga_gpu_watch_history_read_args_s {
+    const aga_gpu_watch_history_query_t *query;
+    /// time range of interest (in milliseconds since epoch)
+    uint64_t start;
+    uint64_t end;
+    void *ctxt;
+    gpu_watch_history_read_cb_t cb;
+} aga_gpu_watch_history_read_args_t;
+
+static void
+aga_gpu_watch_history_read_gpu (gpu_entry *gpu,
+                                aga_gpu_watch_history_read_args_t *args)
+{
+    aga_gpu_watch_series_t series;
+    const aga_gpu_watch_history_query_t *query = args->query;
+
+    // keep recording the attributes being queried for as long as they are
+    // remembered, so that the history fills up for the next query
+    aga::g_gpu_watch_sched.lease(gpu->id(), query->attr_id, query->num_attrs,
+                                 aga::g_gpu_watch_history.retention());
+    series.gpu = gpu->key();
+    for (uint16_t i = 0; i < query->num_attrs; i++) {
+        series.id = query->attr_id[i];
+        // reuse the storage of the previous attribute's samples
+        series.sample.clear();
+        aga::g_gpu_watch_history.read(gpu->id(), series.id, args->start,
+                                      args->end, query->resolution, &series);
+        args->cb(args->ctxt, &series);
+    }
+}
+
+static bool
+aga_gpu_watch_history_from_entry (void *entry, void *ctxt)
+{
+    gpu_entry *gpu = (gpu_entry *)entry;
+
+    // parent GPUs aren't sampled, their partitions are
+    if (gpu->is_parent_gpu()) {
+        return false;
+    }
+    aga_gpu_watch_history_read_gpu(gpu,
+        (aga_gpu_watch_history_read_args_t *)ctxt);
+    return false;
+}
+
+sdk_ret_t
+aga_gpu_watch_history_read (_In_ const aga_gpu_watch_history_query_t *query,
+                            _In_ gpu_watch_history_read_cb_t cb,
+                            _In_ void *ctxt)
+{
+    gpu_entry *gpu;
+    aga_obj_key_t key;
+    timespec_t start_ts, end_ts;
+    aga_gpu_watch_history_read_args_t args = { 0 };
+
+    if (unlikely((query == NULL) || (cb == NULL) ||
+                 (query->num_gpu > AGA_MAX_GPU) ||
+                 (query->num_attrs == 0) ||
+                 (query->num_attrs > AGA_GPU_WATCH_ATTRS_MAX))) {
+        return SDK_RET_INVALID_ARG;
+    }
+    for (uint16_t i = 0; i < query->num_attrs; i++) {
+        if ((query->attr_id[i] <= AGA_GPU_WATCH_ATTR_ID_INVALID) ||
+            (query->attr_id[i] >= AGA_GPU_WATCH_ATTRS_MAX)) {
+            AGA_TRACE_ERR("Invalid GPU watch history request, unknown "
+                          "attribute {}", query->attr_id[i]);
+            return SDK_RET_INVALID_ARG;
+        }
+    }
+    args.query = query;
+    args.ctxt = ctxt;
+    args.cb = cb;
+    start_ts = query->start_time;
+    sdk::timestamp_to_nsecs(&start_ts, &args.start);
+    args.start /= TIME_NSECS_PER_MSEC;
+    end_ts = query->end_time;
+    if (end_ts.tv_sec || end_ts.tv_nsec) {
+        sdk::timestamp_to_nsecs(&end_ts, &args.end);
+        args.end /= TIME_NSECS_PER_MSEC;
+    } else {
+        args.end = UINT64_MAX;
+    }
+    if (query->num_gpu == 0) {
+        return gpu_db()->walk(aga_gpu_watch_history_from_entry, &args);
+    }
+    // validate all the GPUs before reporting any history
+    for (uint32_t i = 0; i < query->num_gpu; i++) {
+        key = query->gpu[i];
+        gpu = aga::gpu_find(&key);
+        if (unlikely(gpu == NULL)) {
+            AGA_TRACE_ERR("Invalid GPU watch history request, GPU {} "
+                          "does not exist", key.str());
+            return SDK_RET_ENTRY_NOT_FOUND;
+        }
+        if (unlikely(gpu->is_parent_gpu())) {
+            // parent GPUs aren't sampled, their partitions are
+            AGA_TRACE_ERR("Invalid GPU watch history request, GPU {} is "
+                          "partitioned, query its partitions instead",
+                          key.str());
+            return SDK_RET_INVALID_ARG;
+        }
+    }
+    for (uint32_t i = 0; i < query->num_gpu; i++) {
+        key = query->gpu[i];
+        aga_gpu_watch_history_read_gpu(aga::gpu_find(&key), &args);
+    }
+    return SDK_RET_OK;
 }
 
 static void
@@ -169,17 +281,22 @@ aga_gpu_watch_subscribe (aga_gpu_watch_subscribe_req_t *req)
         }
     }
     args = new aga_gpu_watch_subscribe_args_t();
-    // allocate the client context
+    // allocate the client context, backend owns it once the subscription
+    // goes through and releases it when the client becomes unreachable
     args->client_ctxt = new aga_gpu_watch_client_ctxt_t();
     AGA_TRACE_VERBOSE("GPU watch subscribe request client_ctxt {}",
                       (void *)args->client_ctxt);
     // initialize the client context
     args->client_ctxt->client = req->client;
-    args->client_ctxt->client_inactive = false;
-    args->client_ctxt->cond = PTHREAD_COND_INITIALIZER;
-    args->client_ctxt->lock = PTHREAD_MUTEX_INITIALIZER;
     args->client_ctxt->stream = req->stream;
     args->client_ctxt->write_cb = req->write_cb;
+    args->client_ctxt->close_cb = req->close_cb;
+    args->client_ctxt->changes_only = req->changes_only;
+    args->client_ctxt->keyframe_interval =
+        req->keyframe_interval ? req->keyframe_interval :
+                                 AGA_GPU_WATCH_KEYFRAME_INTERVAL_DEFAULT;
+    memcpy(args->client_ctxt->deadband, req->deadband,
+           sizeof(args->client_ctxt->deadband));
 
     for (auto i = 0; i < req->num_gpu_watch_ids; i++) {
         args->gpu_watch_ids.push_back(req->gpu_watch_ids[i]);
@@ -190,6 +307,13 @@ aga_gpu_watch_subscribe (aga_gpu_watch_subscribe_req_t *req)
                             aga::AGA_IPC_MSG_ID_GPU_WATCH_SUBSCRIBE, &args,
                             sizeof(args),
                             aga_gpu_watch_subscribe_rsp_cb, &ret);
+    if (unlikely(ret != SDK_RET_OK)) {
+        AGA_TRACE_ERR("GPU watch subscribe request failed, client {}, err {}",
+                      req->client, ret());
+        delete args->client_ctxt;
+        delete args;
+        return ret;
+    }
     // post task to api thread to increment the subscriber count
     task_spec.task = AGA_TASK_GPU_WATCH_SUBSCRIBE_ADD;
     task_spec.subscriber_spec.num_gpu_watch_ids = req->num_gpu_watch_ids;
@@ -202,22 +326,7 @@ aga_gpu_watch_subscribe (aga_gpu_watch_subscribe_req_t *req)
                       "for GPU watch, client {}, client ctxt {}",
                       req->client, (void *)args->client_ctxt);
     }
-
-    /// wait until gRPC client closes the connection and becomes inactive
-    pthread_mutex_lock(&args->client_ctxt->lock);
-    while (args->client_ctxt->client_inactive == false) {
-        pthread_cond_wait(&args->client_ctxt->cond, &args->client_ctxt->lock);
-    }
-    AGA_TRACE_INFO("Rcvd signal from backend thread to quit, releasing "
-                   "client {} ctxt {}, event stream {}",
-                   args->client_ctxt->client.c_str(),
-                   (void *)args->client_ctxt,
-                   (void *)args->client_ctxt->stream);
-    pthread_mutex_unlock(&args->client_ctxt->lock);
-    pthread_mutex_destroy(&args->client_ctxt->lock);
-
-    // free the client context
-    delete args->client_ctxt;
+    // client context is owned by the backend from here on
     delete args;
     return SDK_RET_OK;
 }
@@ -0,0 +1,297 @@
+
+/*
+Copyright (c) Advanced Micro Devices, Inc. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+//----------------------------------------------------------------------------
+///
+/// \file
+/// compressed chunk of GPU watch history samples
+///
+//----------------------------------------------------------------------------
+
+#ifndef __AGA_GPU_WATCH_CHUNK_HPP__
+#define __AGA_GPU_WATCH_CHUNK_HPP__
+
+#include <vector>
+#include "nic/sdk/include/sdk/base.hpp"
+
+/// \defgroup AGA_GPU_WATCH_HISTORY - GPU watch history functionality
+/// \ingroup AGA
+/// @{
+
+namespace aga {
+
+/// \brief    sequence of bits packed most significant bit first into 64 bit
+///           words
+class gpu_watch_bits {
+public:
+    /// \brief constructor
+    gpu_watch_bits() : nbits_(0) {}
+
+    /// \brief     append bits
+    /// \param[in] value    value whose low order bits are appended
+    /// \param[in] nbits    no. of bits to append (upto 64)
+    void put(uint64_t value, uint32_t nbits) {
+        uint32_t room;
+
+        if (nbits == 0) {
+            return;
+        }
+        if (nbits < 64) {
+            value &= (1ULL << nbits) - 1;
+        }
+        if ((nbits_ % 64) == 0) {
+            words_.push_back(0);
+        }
+        room = 64 - (nbits_ % 64);
+        if (nbits <= room) {
+            words_.back() |= value << (room - nbits);
+        } else {
+            words_.back() |= value >> (nbits - room);
+            words_.push_back(value << (64 - (nbits - room)));
+        }
+        nbits_ += nbits;
+    }
+
+    /// \brief     read bits
+    /// \param[in] pos      position of the first bit to read, advanced past
+    ///                     the bits read
+    /// \param[in] nbits    no. of bits to read (upto 64)
+    /// \return    bits read, as the low order bits of the value
+    uint64_t get(uint64_t *pos, uint32_t nbits) const {
+        uint64_t idx = *pos / 64;
+        uint32_t off = *pos % 64;
+        uint32_t room = 64 - off;
+        uint64_t value;
+
+        if (nbits == 0) {
+            return 0;
+        }
+        value = (words_[idx] << off) >> (64 - nbits);
+        if (nbits > room) {
+            value |= words_[idx + 1] >> (64 - (nbits - room));
+        }
+        *pos += nbits;
+        return value;
+    }
+
+    /// \brief    release the unused capacity
+    void shrink(void) {
+        words_.shrink_to_fit();
+    }
+
+    /// \brief    return the memory taken by the bits
+    /// \return   size in bytes
+    size_t mem_size(void) const {
+        return words_.capacity() * sizeof(uint64_t);
+    }
+
+private:
+    /// words holding the bits
+    std::vector<uint64_t> words_;
+    /// no. of bits appended so far
+    uint64_t nbits_;
+};
+
+/// \brief    chunk of consecutive samples of an attribute compressed as in
+///           Facebook's Gorilla time series database
+/// \remark
+///   - first sample is kept as is, every timestamp after it is encoded as
+///     the difference of its delta from the previous delta, so samples taken
+///     at a steady interval cost a single bit
+///   - every value after the first is XORed with the previous one and only
+///     the meaningful bits of the XOR are encoded, so an unchanged value
+///     (e.g., ECC counters) costs a single bit and slowly changing gauges
+///     reuse the previous window of meaningful bits
+///   - chunks are append only and decoded from the start, one sample at a
+///     time
+class gpu_watch_chunk {
+public:
+    /// \brief     constructor
+    /// \param[in] ts       time of the first sample (in milliseconds)
+    /// \param[in] value    value of the first sample
+    gpu_watch_chunk(uint64_t ts, uint64_t value) :
+        first_ts_(ts), first_value_(value), num_samples_(1), last_ts_(ts),
+        last_delta_(0), last_value_(value), lead_(0), trail_(0) {}
+
+    /// \brief     append a sample
+    /// \param[in] ts       time of the sample (in milliseconds)
+    /// \param[in] value    value of the sample
+    void append(uint64_t ts, uint64_t value) {
+        int64_t delta = (int64_t)(ts - last_ts_);
+
+        put_dod_(delta - last_delta_);
+        put_xor_(value ^ last_value_);
+        last_ts_ = ts;
+        last_delta_ = delta;
+        last_value_ = value;
+        num_samples_++;
+    }
+
+    /// \brief    release the unused capacity once no more samples are
+    ///           appended to the chunk
+    void seal(void) {
+        bits_.shrink();
+    }
+
+    /// \brief    return the time of the first sample
+    /// \return   time of the first sample (in milliseconds)
+    uint64_t first_ts(void) const {
+        return first_ts_;
+    }
+
+    /// \brief    return the time of the latest sample
+    /// \return   time of the latest sample (in milliseconds)
+    uint64_t last_ts(void) const {
+        return last_ts_;
+    }
+
+    /// \brief    return the number of samples in the chunk
+    /// \return   number of samples
+    uint32_t num_samples(void) const {
+        return num_samples_;
+    }
+
+    /// \brief    return the memory taken by the chunk
+    /// \return   size in bytes
+    size_t mem_size(void) const {
+        return sizeof(*this) + bits_.mem_size();
+    }
+
+    /// \brief     decode the samples from the oldest to the latest
+    /// \param[in] walk_cb    callback invoked with the time and value of
+    ///                       every sample, decoding stops if it returns true
+    template <typename CB>
+    void walk(CB walk_cb) const {
+        uint64_t pos = 0, ts = first_ts_, value = first_value_;
+        int64_t delta = 0;
+        uint32_t lead = 0, trail = 0;
+
+        if (walk_cb(ts, value)) {
+            return;
+        }
+        for (uint32_t i = 1; i < num_samples_; i++) {
+            delta += get_dod_(&pos);
+            ts += delta;
+            if (bits_.get(&pos, 1)) {
+                if (bits_.get(&pos, 1)) {
+                    // new window of meaningful bits
+                    lead = bits_.get(&pos, 6);
+                    trail = 64 - lead - (bits_.get(&pos, 6) + 1);
+                }
+                value ^= bits_.get(&pos, 64 - lead - trail) << trail;
+            }
+            if (walk_cb(ts, value)) {
+                return;
+            }
+        }
+    }
+
+private:
+    /// \brief     encode a delta of delta of timestamps
+    /// \param[in] dod    delta of delta
+    void put_dod_(int64_t dod) {
+        if (dod == 0) {
+            bits_.put(0x0, 1);
+        } else if ((dod >= -64) && (dod <= 63)) {
+            bits_.put(0x2, 2);
+            bits_.put(dod, 7);
+        } else if ((dod >= -256) && (dod <= 255)) {
+            bits_.put(0x6, 3);
+            bits_.put(dod, 9);
+        } else if ((dod >= -2048) && (dod <= 2047)) {
+            bits_.put(0xE, 4);
+            bits_.put(dod, 12);
+        } else {
+            bits_.put(0xF, 4);
+            bits_.put(dod, 64);
+        }
+    }
+
+    /// \brief         decode a delta of delta of timestamps
+    /// \param[in,out] pos    position of the encoded delta of delta
+    /// \return        delta of delta
+    int64_t get_dod_(uint64_t *pos) const {
+        uint32_t nbits;
+
+        if (bits_.get(pos, 1) == 0) {
+            return 0;
+        } else if (bits_.get(pos, 1) == 0) {
+            nbits = 7;
+        } else if (bits_.get(pos, 1) == 0) {
+            nbits = 9;
+        } else if (bits_.get(pos, 1) == 0) {
+            nbits = 12;
+        } else {
+            return (int64_t)bits_.get(pos, 64);
+        }
+        // sign extend
+        return ((int64_t)(bits_.get(pos, nbits) << (64 - nbits))) >>
+                   (64 - nbits);
+    }
+
+    /// \brief     encode the XOR of a value with the previous value
+    /// \param[in] xor_val    XOR of the values
+    void put_xor_(uint64_t xor_val) {
+        uint32_t lead, trail;
+
+        if (xor_val == 0) {
+            bits_.put(0x0, 1);
+            return;
+        }
+        lead = __builtin_clzll(xor_val);
+        trail = __builtin_ctzll(xor_val);
+        if (((lead_ + trail_) != 0) && (lead >= lead_) && (trail >= trail_)) {
+            // meaningful bits fit in the previous window
+            bits_.put(0x2, 2);
+            bits_.put(xor_val >> trail_, 64 - lead_ - trail_);
+            return;
+        }
+        bits_.put(0x3, 2);
+        bits_.put(lead, 6);
+        bits_.put(64 - lead - trail - 1, 6);
+        bits_.put(xor_val >> trail, 64 - lead - trail);
+        lead_ = lead;
+        trail_ = trail;
+    }
+
+private:
+    /// time of the first sample (in milliseconds)
+    uint64_t first_ts_;
+    /// value of the first sample
+    uint64_t first_value_;
+    /// no. of samples in the chunk
+    uint32_t num_samples_;
+    /// time of the latest sample (in milliseconds)
+    uint64_t last_ts_;
+    /// difference between the times of the last two samples
+    int64_t last_delta_;
+    /// value of the latest sample
+    uint64_t last_value_;
+    /// leading and trailing zeros of the current window of meaningful bits,
+    /// both 0 until the first window is encoded
+    uint32_t lead_;
+    uint32_t trail_;
+    /// encoded samples after the first one
+    gpu_watch_bits bits_;
+};
+
+/// \@}
+
+}    // namespace aga
+
+#endif    // __AGA_GPU_WATCH_CHUNK_HPP__
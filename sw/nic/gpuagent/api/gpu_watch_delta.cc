@@ -0,0 +1,163 @@
+
+/*
+Copyright (c) Advanced Micro Devices, Inc. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+//----------------------------------------------------------------------------
+///
+/// \file
+/// GPU watch delta implementation
+///
+//----------------------------------------------------------------------------
+
+#include <cmath>
+#include "nic/gpuagent/api/gpu_watch_delta.hpp"
+
+namespace aga {
+
+/// \defgroup AGA_GPU_WATCH_DELTA - GPU watch delta functionality
+/// \ingroup AGA_GPU_WATCH
+/// \@{
+
+bool
+gpu_watch_delta::changed_(const sent_value_t& sent,
+                          const aga_gpu_watch_attr_t& attr, double deadband) {
+    uint64_t diff;
+
+    if (sent.type != attr.value.type) {
+        return true;
+    }
+    switch (attr.value.type) {
+    case AGA_GPU_WATCH_ATTR_VALUE_TYPE_LONG:
+        diff = (attr.value.long_val > sent.long_val) ?
+                   (attr.value.long_val - sent.long_val) :
+                   (sent.long_val - attr.value.long_val);
+        return (diff != 0) && ((double)diff > deadband);
+    case AGA_GPU_WATCH_ATTR_VALUE_TYPE_FLOAT:
+        return (attr.value.float_val != sent.float_val) &&
+                   (std::fabs(attr.value.float_val - sent.float_val) >
+                        deadband);
+    case AGA_GPU_WATCH_ATTR_VALUE_TYPE_STRING:
+        return attr.value.str_val != sent.str_val;
+    case AGA_GPU_WATCH_ATTR_VALUE_TYPE_NONE:
+        // aggregated attribute, publish if any of its statistics moved past
+        // the deadband
+        if (attr.agg.size() != sent.agg.size()) {
+            return true;
+        }
+        for (size_t i = 0; i < attr.agg.size(); i++) {
+            if (attr.agg[i].stat != sent.agg[i].stat) {
+                return true;
+            }
+            if ((attr.agg[i].value != sent.agg[i].value) &&
+                (std::fabs(attr.agg[i].value - sent.agg[i].value) >
+                     deadband)) {
+                return true;
+            }
+        }
+        return false;
+    default:
+        return true;
+    }
+}
+
+void
+gpu_watch_delta::remember_(sent_value_t *sent,
+                           const aga_gpu_watch_attr_t& attr) {
+    sent->type = attr.value.type;
+    switch (attr.value.type) {
+    case AGA_GPU_WATCH_ATTR_VALUE_TYPE_FLOAT:
+        sent->float_val = attr.value.float_val;
+        break;
+    case AGA_GPU_WATCH_ATTR_VALUE_TYPE_LONG:
+        sent->long_val = attr.value.long_val;
+        break;
+    case AGA_GPU_WATCH_ATTR_VALUE_TYPE_STRING:
+        // assignments reuse the storage of the previous values
+        sent->str_val = attr.value.str_val;
+        break;
+    case AGA_GPU_WATCH_ATTR_VALUE_TYPE_NONE:
+        sent->agg = attr.agg;
+        break;
+    default:
+        break;
+    }
+}
+
+gpu_watch_delta_result_t
+gpu_watch_delta::filter(const aga_gpu_watch_info_t& info, uint64_t now,
+                        uint32_t keyframe_interval, const double *deadband,
+                        aga_gpu_watch_info_t *delta) {
+    uint32_t num_gpu = 0, num_attrs;
+    const aga_gpu_watch_stats_t& stats = info.stats;
+
+    if ((last_keyframe_ == 0) ||
+        (now >= (last_keyframe_ + keyframe_interval)) ||
+        (num_attrs_ != info.spec.num_attrs) ||
+        (sent_.size() != ((size_t)stats.num_gpu * info.spec.num_attrs))) {
+        // time to resync the subscriber, publish everything
+        num_attrs_ = info.spec.num_attrs;
+        sent_.resize((size_t)stats.num_gpu * num_attrs_);
+        for (uint32_t g = 0; g < stats.num_gpu; g++) {
+            for (uint32_t a = 0; a < stats.gpu_watch_attr[g].num_attrs; a++) {
+                remember_(&sent_[(g * num_attrs_) + a],
+                          stats.gpu_watch_attr[g].attr[a]);
+            }
+        }
+        last_keyframe_ = now;
+        return GPU_WATCH_DELTA_KEYFRAME;
+    }
+    for (uint32_t g = 0; g < stats.num_gpu; g++) {
+        const auto& gpu_attrs = stats.gpu_watch_attr[g];
+
+        num_attrs = 0;
+        for (uint32_t a = 0; a < gpu_attrs.num_attrs; a++) {
+            const auto& attr = gpu_attrs.attr[a];
+            auto& sent = sent_[(g * num_attrs_) + a];
+
+            if (!changed_(sent, attr, deadband[attr.id])) {
+                continue;
+            }
+            if (num_attrs == 0) {
+                // first change on this GPU
+                if (delta->stats.gpu_watch_attr.size() <= num_gpu) {
+                    delta->stats.gpu_watch_attr.resize(num_gpu + 1);
+                }
+                delta->stats.gpu_watch_attr[num_gpu].gpu = gpu_attrs.gpu;
+            }
+            auto& delta_attrs = delta->stats.gpu_watch_attr[num_gpu].attr;
+            if (delta_attrs.size() <= num_attrs) {
+                delta_attrs.resize(num_attrs + 1);
+            }
+            delta_attrs[num_attrs++] = attr;
+            remember_(&sent, attr);
+        }
+        if (num_attrs) {
+            delta->stats.gpu_watch_attr[num_gpu++].num_attrs = num_attrs;
+        }
+    }
+    if (num_gpu == 0) {
+        return GPU_WATCH_DELTA_NONE;
+    }
+    delta->spec.key = info.spec.key;
+    delta->status = info.status;
+    delta->stats.num_gpu = num_gpu;
+    return GPU_WATCH_DELTA_CHANGES;
+}
+
+/// \@}
+
+}    // namespace aga
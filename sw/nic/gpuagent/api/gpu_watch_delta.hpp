@@ -0,0 +1,125 @@
+
+/*
+Copyright (c) Advanced Micro Devices, Inc. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+//----------------------------------------------------------------------------
+///
+/// \file
+/// change only publishing of GPU watch attributes to subscribers
+///
+//----------------------------------------------------------------------------
+
+#ifndef __AGA_GPU_WATCH_DELTA_HPP__
+#define __AGA_GPU_WATCH_DELTA_HPP__
+
+#include <string>
+#include <vector>
+#include "nic/sdk/include/sdk/base.hpp"
+#include "nic/gpuagent/api/include/aga_gpu_watch.hpp"
+
+/// \defgroup AGA_GPU_WATCH_DELTA - GPU watch delta functionality
+/// \ingroup AGA
+/// @{
+
+namespace aga {
+
+/// \brief    result of filtering a GPU watch update for a subscriber
+typedef enum gpu_watch_delta_result_e {
+    /// nothing changed, nothing to publish
+    GPU_WATCH_DELTA_NONE     = 0,
+    /// publish the update as is
+    GPU_WATCH_DELTA_KEYFRAME = 1,
+    /// publish only the attributes that changed
+    GPU_WATCH_DELTA_CHANGES  = 2,
+} gpu_watch_delta_result_t;
+
+/// \brief    values of a GPU watch last published to a subscriber, used to
+///           send only the attributes that changed since
+/// \remark   owned and used by the watcher thread only
+class gpu_watch_delta {
+public:
+    /// \brief constructor
+    gpu_watch_delta() : last_keyframe_(0), num_attrs_(0) {}
+
+    /// \brief destructor
+    ~gpu_watch_delta() {}
+
+    /// \brief      figure out what needs to be published to the subscriber
+    ///             and remember it as published
+    /// \param[in]  info                 latest GPU watch information
+    /// \param[in]  now                  current time (in milliseconds)
+    /// \param[in]  keyframe_interval    interval at which everything is
+    ///                                  published (in milliseconds)
+    /// \param[in]  deadband             per attribute deadbands, indexed by
+    ///                                  attribute id
+    /// \param[out] delta                GPUs and attributes that changed,
+    ///                                  filled only if changes are to be
+    ///                                  published; its storage is reused
+    ///                                  across calls
+    /// \return     what needs to be published
+    gpu_watch_delta_result_t filter(const aga_gpu_watch_info_t& info,
+                                    uint64_t now, uint32_t keyframe_interval,
+                                    const double *deadband,
+                                    aga_gpu_watch_info_t *delta);
+
+private:
+    /// \brief    value of an attribute last published
+    typedef struct sent_value_s {
+        /// type of the value, AGA_GPU_WATCH_ATTR_VALUE_TYPE_NONE if the
+        /// watch is aggregated
+        aga_gpu_watch_attr_value_type_t type;
+        union {
+            float float_val;
+            uint64_t long_val;
+        };
+        /// value of string attributes
+        std::string str_val;
+        /// statistics of aggregated attributes
+        std::vector<aga_gpu_watch_agg_value_t> agg;
+    } sent_value_t;
+
+    /// \brief     check if an attribute moved past its deadband since it
+    ///            was last published
+    /// \param[in] sent        value last published
+    /// \param[in] attr        latest attribute
+    /// \param[in] deadband    deadband of the attribute
+    /// \return    true if the attribute needs to be published
+    static bool changed_(const sent_value_t& sent,
+                         const aga_gpu_watch_attr_t& attr, double deadband);
+
+    /// \brief     remember an attribute as published
+    /// \param[out] sent    value last published
+    /// \param[in]  attr    attribute published
+    static void remember_(sent_value_t *sent,
+                          const aga_gpu_watch_attr_t& attr);
+
+private:
+    /// last time everything was published (in milliseconds)
+    uint64_t last_keyframe_;
+    /// no. of attributes per GPU when last published
+    uint32_t num_attrs_;
+    /// values last published indexed by (GPU index * num_attrs_ + attr index)
+    std::vector<sent_value_t> sent_;
+};
+
+/// \@}
+
+}    // namespace aga
+
+using aga::gpu_watch_delta;
+
+#endif    // __AGA_GPU_WATCH_DELTA_HPP__
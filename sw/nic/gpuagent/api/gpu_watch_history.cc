@@ -0,0 +1,224 @@
+
+/*
+Copyright (c) Advanced Micro Devices, Inc. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+//----------------------------------------------------------------------------
+///
+/// \file
+/// GPU watch history implementation
+///
+//----------------------------------------------------------------------------
+
+#include <algorithm>
+#include "nic/sdk/include/sdk/timestamp.hpp"
+#include "nic/gpuagent/api/gpu_watch_history.hpp"
+#include "nic/gpuagent/api/gpu_watch_snapshot.hpp"
+
+namespace aga {
+
+/// \defgroup AGA_GPU_WATCH_HISTORY - GPU watch history functionality
+/// \ingroup AGA_GPU_WATCH
+/// \@{
+
+/// global singleton GPU watch history instance
+gpu_watch_history g_gpu_watch_history;
+
+void
+gpu_watch_series::push(uint32_t chunk_samples, uint64_t ts, uint64_t value) {
+    if (chunks_.empty() || (chunks_.back().num_samples() >= chunk_samples)) {
+        if (!chunks_.empty()) {
+            chunks_.back().seal();
+        }
+        chunks_.emplace_back(ts, value);
+    } else {
+        chunks_.back().append(ts, value);
+    }
+    num_samples_++;
+}
+
+void
+gpu_watch_series::expire(uint64_t oldest) {
+    while (!chunks_.empty() && (chunks_.front().last_ts() < oldest)) {
+        num_samples_ -= chunks_.front().num_samples();
+        chunks_.pop_front();
+    }
+}
+
+gpu_watch_history::gpu_watch_history() :
+    last_sweep_(0), num_encoded_(0), encode_ns_(0), num_decoded_(0), decode_ns_(0) {
+    depth_ = AGA_GPU_WATCH_HISTORY_RETENTION_DEFAULT * TIME_MSECS_PER_SEC /
+                 AGA_GPU_WATCH_HISTORY_INTERVAL;
+    for (uint32_t i = 0; i < AGA_MAX_GPU; i++) {
+        SDK_SPINLOCK_INIT(&gpu_[i].slock, PTHREAD_PROCESS_PRIVATE);
+    }
+}
+
+gpu_watch_history::~gpu_watch_history() {
+    for (uint32_t i = 0; i < AGA_MAX_GPU; i++) {
+        SDK_SPINLOCK_DESTROY(&gpu_[i].slock);
+    }
+}
+
+void
+gpu_watch_history::init(uint32_t retention) {
+    if (retention == 0) {
+        retention = AGA_GPU_WATCH_HISTORY_RETENTION_DEFAULT;
+    }
+    depth_ = retention * TIME_MSECS_PER_SEC / AGA_GPU_WATCH_HISTORY_INTERVAL;
+}
+
+void
+gpu_watch_history::record(uint32_t gpu_id,
+                          const aga_gpu_watch_fields_t& fields,
+                          const aga_gpu_watch_attr_set_t& attrs, uint64_t ts) {
+    uint64_t ns, oldest;
+    uint32_t chunk_samples;
+    timespec_t start_ts, end_ts, diff_ts;
+    uint32_t num_attrs = 0, num_encoded = 0;
+    gpu_history_t *gpu = &gpu_[gpu_id];
+    aga_gpu_watch_attr_id_t attr_ids[AGA_GPU_WATCH_ATTRS_MAX];
+    uint64_t values[AGA_GPU_WATCH_ATTRS_MAX];
+
+    for (uint32_t a = (AGA_GPU_WATCH_ATTR_ID_INVALID + 1);
+         a < AGA_GPU_WATCH_ATTRS_MAX; a++) {
+        if (attrs.test(a) &&
+            (gpu_watch_field_get(fields, (aga_gpu_watch_attr_id_t)a,
+                                 &values[num_attrs]) == SDK_RET_OK)) {
+            attr_ids[num_attrs++] = (aga_gpu_watch_attr_id_t)a;
+        }
+    }
+    if (num_attrs == 0) {
+        return;
+    }
+    // short retention windows use smaller chunks so that dropping a chunk
+    // doesn't drop most of the history
+    chunk_samples = std::min(depth_,
+                             (uint32_t)AGA_GPU_WATCH_HISTORY_CHUNK_SAMPLES);
+    oldest = oldest_(ts);
+    SDK_SPINLOCK_LOCK(&gpu->slock);
+    // only the first sample of an attribute in every history interval is
+    // remembered, leave the rest out of the encoder statistics too
+    for (uint32_t i = 0; i < num_attrs; i++) {
+        if (!gpu->series[attr_ids[i]].sampled(ts)) {
+            attr_ids[num_encoded] = attr_ids[i];
+            values[num_encoded++] = values[i];
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &start_ts);
+    for (uint32_t i = 0; i < num_encoded; i++) {
+        gpu->series[attr_ids[i]].push(chunk_samples, ts, values[i]);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end_ts);
+    for (uint32_t i = 0; i < num_encoded; i++) {
+        gpu->series[attr_ids[i]].expire(oldest);
+    }
+    SDK_SPINLOCK_UNLOCK(&gpu->slock);
+    if (num_encoded == 0) {
+        return;
+    }
+    diff_ts = sdk::timestamp_diff(&end_ts, &start_ts);
+    sdk::timestamp_to_nsecs(&diff_ts, &ns);
+    num_encoded_.fetch_add(num_encoded, std::memory_order_relaxed);
+    encode_ns_.fetch_add(ns, std::memory_order_relaxed);
+}
+
+void
+gpu_watch_history::read(uint32_t gpu_id, aga_gpu_watch_attr_id_t attr_id,
+                        uint64_t start, uint64_t end, uint32_t resolution,
+                        aga_gpu_watch_series_t *series) {
+    gpu_history_t *gpu = &gpu_[gpu_id];
+    aga_gpu_watch_sample_t sample;
+    uint64_t last_window = 0, num_decoded = 0, ns;
+    timespec_t start_ts, end_ts, diff_ts, now_ts;
+
+    // samples that fell out of the retention window but are not swept yet
+    // are never read
+    clock_gettime(CLOCK_REALTIME, &now_ts);
+    sdk::timestamp_to_nsecs(&now_ts, &ns);
+    start = std::max(start, oldest_(ns / TIME_NSECS_PER_MSEC));
+    clock_gettime(CLOCK_MONOTONIC, &start_ts);
+    SDK_SPINLOCK_LOCK(&gpu->slock);
+    gpu->series[attr_id].walk(start, end, [&](uint64_t ts, uint64_t value) {
+        num_decoded++;
+        sample.timestamp.tv_sec = ts / TIME_MSECS_PER_SEC;
+        sample.timestamp.tv_nsec =
+            (ts % TIME_MSECS_PER_SEC) * TIME_NSECS_PER_MSEC;
+        sample.value = value;
+        if (resolution && !series->sample.empty() &&
+            ((ts / resolution) == last_window)) {
+            // keep only the latest sample of the window
+            series->sample.back() = sample;
+            return;
+        }
+        last_window = resolution ? (ts / resolution) : 0;
+        series->sample.push_back(sample);
+    });
+    SDK_SPINLOCK_UNLOCK(&gpu->slock);
+    clock_gettime(CLOCK_MONOTONIC, &end_ts);
+    diff_ts = sdk::timestamp_diff(&end_ts, &start_ts);
+    sdk::timestamp_to_nsecs(&diff_ts, &ns);
+    num_decoded_.fetch_add(num_decoded, std::memory_order_relaxed);
+    decode_ns_.fetch_add(ns, std::memory_order_relaxed);
+}
+
+void
+gpu_watch_history::sweep(uint64_t now) {
+    uint64_t oldest;
+    gpu_history_t *gpu;
+
+    if ((now - last_sweep_) < AGA_GPU_WATCH_HISTORY_SWEEP_INTERVAL) {
+        return;
+    }
+    last_sweep_ = now;
+    oldest = oldest_(now);
+    for (uint32_t g = 0; g < AGA_MAX_GPU; g++) {
+        gpu = &gpu_[g];
+        SDK_SPINLOCK_LOCK(&gpu->slock);
+        for (uint32_t a = 0; a < AGA_GPU_WATCH_ATTRS_MAX; a++) {
+            gpu->series[a].expire(oldest);
+        }
+        SDK_SPINLOCK_UNLOCK(&gpu->slock);
+    }
+}
+
+void
+gpu_watch_history::stats(gpu_watch_history_stats_t *stats) {
+    gpu_history_t *gpu;
+
+    *stats = {};
+    for (uint32_t g = 0; g < AGA_MAX_GPU; g++) {
+        gpu = &gpu_[g];
+        SDK_SPINLOCK_LOCK(&gpu->slock);
+        for (uint32_t a = 0; a < AGA_GPU_WATCH_ATTRS_MAX; a++) {
+            if (gpu->series[a].num_samples() == 0) {
+                continue;
+            }
+            stats->num_series++;
+            stats->num_samples += gpu->series[a].num_samples();
+            stats->num_bytes += gpu->series[a].mem_size();
+        }
+        SDK_SPINLOCK_UNLOCK(&gpu->slock);
+    }
+    stats->num_encoded = num_encoded_.load(std::memory_order_relaxed);
+    stats->encode_ns = encode_ns_.load(std::memory_order_relaxed);
+    stats->num_decoded = num_decoded_.load(std::memory_order_relaxed);
+    stats->decode_ns = decode_ns_.load(std::memory_order_relaxed);
+}
+
+/// \@}
+
+}    // namespace aga
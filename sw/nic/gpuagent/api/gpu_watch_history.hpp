@@ -0,0 +1,263 @@
+
+/*
+Copyright (c) Advanced Micro Devices, Inc. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+//----------------------------------------------------------------------------
+///
+/// \file
+/// GPU watch history remembered by the watcher for time range queries
+///
+//----------------------------------------------------------------------------
+
+#ifndef __AGA_GPU_WATCH_HISTORY_HPP__
+#define __AGA_GPU_WATCH_HISTORY_HPP__
+
+#include <atomic>
+#include <deque>
+#include "nic/sdk/include/sdk/base.hpp"
+#include "nic/sdk/include/sdk/lock.hpp"
+#include "nic/gpuagent/api/include/aga_gpu_watch.hpp"
+#include "nic/gpuagent/api/internal/aga_gpu_watch.hpp"
+#include "nic/gpuagent/api/gpu_watch_sched.hpp"
+#include "nic/gpuagent/api/gpu_watch_chunk.hpp"
+
+/// \defgroup AGA_GPU_WATCH_HISTORY - GPU watch history functionality
+/// \ingroup AGA
+/// @{
+
+/// finest granularity of the GPU watch history (in milliseconds), only the
+/// first sample of an attribute in every such interval is remembered
+#define AGA_GPU_WATCH_HISTORY_INTERVAL         1000
+/// max. no. of samples compressed together in a chunk
+#define AGA_GPU_WATCH_HISTORY_CHUNK_SAMPLES    120
+/// interval at which the series that are no longer fed are checked for
+/// samples older than the retention window (in milliseconds)
+#define AGA_GPU_WATCH_HISTORY_SWEEP_INTERVAL   60000
+
+namespace aga {
+
+/// \brief    series of samples of one attribute of a GPU, kept as a list of
+///           compressed chunks; once all the samples of the oldest chunk
+///           fall out of the retention window the chunk is dropped as a whole
+/// \remark   chunks are allocated as the samples come in, so the attributes
+///           that are never watched don't take any memory
+class gpu_watch_series {
+public:
+    /// \brief constructor
+    gpu_watch_series() : num_samples_(0) {}
+
+    /// \brief destructor
+    ~gpu_watch_series() {}
+
+    /// \brief     check if a sample is already remembered in the history
+    ///            interval of the given time, only the first one is
+    /// \param[in] ts    time of the sample (in milliseconds since epoch)
+    /// \return    true if the sample is to be discarded, false otherwise
+    bool sampled(uint64_t ts) const {
+        return !chunks_.empty() &&
+               ((ts / AGA_GPU_WATCH_HISTORY_INTERVAL) ==
+                    (chunks_.back().last_ts() /
+                         AGA_GPU_WATCH_HISTORY_INTERVAL));
+    }
+
+    /// \brief     add a sample to the series
+    /// \param[in] chunk_samples    max. no. of samples in a chunk
+    /// \param[in] ts               time when the attribute was sampled
+    ///                             (in milliseconds since epoch)
+    /// \param[in] value            attribute value
+    void push(uint32_t chunk_samples, uint64_t ts, uint64_t value);
+
+    /// \brief     drop the chunks whose samples are all older than the given
+    ///            time
+    /// \param[in] oldest    time of the oldest sample to be kept
+    ///                      (in milliseconds since epoch)
+    void expire(uint64_t oldest);
+
+    /// \brief    walk the samples in the series from the oldest to the latest
+    /// \param[in] start      only samples taken at or after this are walked
+    /// \param[in] end        only samples taken at or before this are walked
+    /// \param[in] walk_cb    callback invoked with the time and value of every
+    ///                       sample
+    template <typename CB>
+    void walk(uint64_t start, uint64_t end, CB walk_cb) const {
+        bool done = false;
+
+        for (const auto& chunk : chunks_) {
+            if (chunk.last_ts() < start) {
+                continue;
+            }
+            if (done || (chunk.first_ts() > end)) {
+                break;
+            }
+            chunk.walk([&](uint64_t ts, uint64_t value) {
+                if (ts < start) {
+                    return false;
+                }
+                if (ts > end) {
+                    done = true;
+                    return true;
+                }
+                walk_cb(ts, value);
+                return false;
+            });
+        }
+    }
+
+    /// \brief    return the number of samples in the series
+    /// \return   number of samples
+    uint64_t num_samples(void) const {
+        return num_samples_;
+    }
+
+    /// \brief    return the memory taken by the samples
+    /// \return   size in bytes
+    size_t mem_size(void) const {
+        size_t size = 0;
+
+        for (const auto& chunk : chunks_) {
+            size += chunk.mem_size();
+        }
+        return size;
+    }
+
+private:
+    /// compressed chunks from the oldest to the latest
+    std::deque<gpu_watch_chunk> chunks_;
+    /// no. of samples in all the chunks
+    uint64_t num_samples_;
+};
+
+/// \brief    GPU watch history statistics
+typedef struct gpu_watch_history_stats_s {
+    /// no. of attributes with samples remembered, across all the GPUs
+    uint32_t num_series;
+    /// no. of samples remembered
+    uint64_t num_samples;
+    /// memory taken by the remembered samples (in bytes)
+    uint64_t num_bytes;
+    /// no. of samples encoded so far and the time spent on it, samples
+    /// discarded as they fall in an interval already sampled aren't counted
+    uint64_t num_encoded;
+    uint64_t encode_ns;
+    /// no. of samples decoded so far and the time spent on it
+    uint64_t num_decoded;
+    uint64_t decode_ns;
+} gpu_watch_history_stats_t;
+
+/// \brief    history of all the watched attributes of all the GPUs, fed by
+///           the watcher with the values it samples in every tick
+/// \remark
+///   - watcher workers sample different GPUs in parallel, so every GPU's
+///     history has its own lock that the writer takes once per tick and
+///     readers take while copying out the samples of interest
+///   - history is sized by the retention window at init time and the
+///     samples are kept compressed, see gpu_watch_chunk
+class gpu_watch_history {
+public:
+    /// \brief constructor
+    gpu_watch_history();
+
+    /// \brief destructor
+    ~gpu_watch_history();
+
+    /// \brief     initialize the history
+    /// \param[in] retention    retention window (in seconds), 0 picks the
+    ///                         default
+    void init(uint32_t retention);
+
+    /// \brief    return the retention window
+    /// \return   retention window (in milliseconds)
+    uint32_t retention(void) const {
+        return depth_ * AGA_GPU_WATCH_HISTORY_INTERVAL;
+    }
+
+    /// \brief     remember the attributes sampled on a GPU
+    /// \param[in] gpu_id    GPU id (aka. index)
+    /// \param[in] fields    watch fields of the GPU
+    /// \param[in] attrs     attributes that were sampled
+    /// \param[in] ts        time when the attributes were sampled
+    ///                      (in milliseconds since epoch)
+    void record(uint32_t gpu_id, const aga_gpu_watch_fields_t& fields,
+                const aga_gpu_watch_attr_set_t& attrs, uint64_t ts);
+
+    /// \brief      read the remembered samples of an attribute of a GPU
+    /// \param[in]  gpu_id        GPU id (aka. index)
+    /// \param[in]  attr_id       watch attribute identifier
+    /// \param[in]  start         only samples taken at or after this are read
+    ///                           (in milliseconds since epoch)
+    /// \param[in]  end           only samples taken at or before this are
+    ///                           read (in milliseconds since epoch)
+    /// \param[in]  resolution    if non-zero, only the latest sample in every
+    ///                           window of this size (in milliseconds) is
+    ///                           read
+    /// \param[out] series        series to append the samples to
+    void read(uint32_t gpu_id, aga_gpu_watch_attr_id_t attr_id,
+              uint64_t start, uint64_t end, uint32_t resolution,
+              aga_gpu_watch_series_t *series);
+
+    /// \brief     drop the samples older than the retention window from the
+    ///            series that are no longer being recorded, at most once every
+    ///            sweep interval
+    /// \param[in] now    current time (in milliseconds since epoch)
+    void sweep(uint64_t now);
+
+    /// \brief      return the history statistics
+    /// \param[out] stats    statistics
+    void stats(gpu_watch_history_stats_t *stats);
+
+private:
+    /// \brief    history of a GPU
+    typedef struct gpu_history_s {
+        /// lock protecting the series of the GPU
+        sdk_spinlock_t slock;
+        /// series of every attribute indexed by attribute id
+        gpu_watch_series series[AGA_GPU_WATCH_ATTRS_MAX];
+    } gpu_history_t;
+
+    /// \brief     return the time of the oldest sample in the retention
+    ///            window
+    /// \param[in] now    current time (in milliseconds since epoch)
+    /// \return    time of the oldest sample (in milliseconds since epoch)
+    uint64_t oldest_(uint64_t now) const {
+        return (now > retention()) ? (now - retention()) : 0;
+    }
+
+private:
+    /// no. of samples remembered per attribute
+    uint32_t depth_;
+    /// last time the series were swept (in milliseconds since epoch)
+    uint64_t last_sweep_;
+    /// history of every GPU indexed by GPU id
+    gpu_history_t gpu_[AGA_MAX_GPU];
+    /// no. of samples encoded so far and the time spent on it
+    std::atomic<uint64_t> num_encoded_;
+    std::atomic<uint64_t> encode_ns_;
+    /// no. of samples decoded so far and the time spent on it
+    std::atomic<uint64_t> num_decoded_;
+    std::atomic<uint64_t> decode_ns_;
+};
+
+/// global singleton GPU watch history instance
+extern gpu_watch_history g_gpu_watch_history;
+
+/// \@}
+
+}    // namespace aga
+
+using aga::gpu_watch_history;
+
+#endif    // __AGA_GPU_WATCH_HISTORY_HPP__
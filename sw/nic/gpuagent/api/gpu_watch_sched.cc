@@ -0,0 +1,212 @@
+
+/*
+Copyright (c) Advanced Micro Devices, Inc. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+//----------------------------------------------------------------------------
+///
+/// \file
+/// GPU watch sampling scheduler implementation
+///
+//----------------------------------------------------------------------------
+
+#include <numeric>
+#include "nic/sdk/include/sdk/timestamp.hpp"
+#include "nic/gpuagent/api/gpu_watch_sched.hpp"
+
+namespace aga {
+
+/// \defgroup AGA_GPU_WATCH_SCHED - GPU watch sampling scheduler
+/// \ingroup AGA_GPU_WATCH
+/// \@{
+
+/// global singleton GPU watch sampling scheduler instance
+gpu_watch_sched g_gpu_watch_sched;
+
+gpu_watch_sched::gpu_watch_sched() {
+    SDK_SPINLOCK_INIT(&slock_, PTHREAD_PROCESS_PRIVATE);
+    memset(interval_, 0, sizeof(interval_));
+    memset(last_sampled_, 0, sizeof(last_sampled_));
+    memset(lease_expiry_, 0, sizeof(lease_expiry_));
+    tick_ = 0;
+}
+
+gpu_watch_sched::~gpu_watch_sched() {
+    SDK_SPINLOCK_DESTROY(&slock_);
+}
+
+void
+gpu_watch_sched::attr_demand_update_(uint32_t gpu, uint32_t attr,
+                                     uint32_t interval, bool add) {
+    auto& refcnts = demand_[(gpu * AGA_GPU_WATCH_ATTRS_MAX) + attr];
+
+    if (add) {
+        refcnts[interval]++;
+    } else {
+        auto it = refcnts.find(interval);
+        if ((it != refcnts.end()) && (--it->second == 0)) {
+            refcnts.erase(it);
+        }
+    }
+    // intervals are ordered, so the first one is the fastest
+    interval_[gpu][attr] = refcnts.empty() ? 0 : refcnts.begin()->first;
+    if (refcnts.empty()) {
+        demand_.erase((gpu * AGA_GPU_WATCH_ATTRS_MAX) + attr);
+    }
+}
+
+void
+gpu_watch_sched::interval_update_(uint32_t interval, bool add) {
+    if (add) {
+        intervals_[interval]++;
+    } else {
+        auto it = intervals_.find(interval);
+        if ((it != intervals_.end()) && (--it->second == 0)) {
+            intervals_.erase(it);
+        }
+    }
+    // wake up often enough to land on every interval demanded
+    tick_ = 0;
+    for (auto it = intervals_.begin(); it != intervals_.end(); it++) {
+        tick_ = std::gcd(tick_, it->first);
+    }
+}
+
+void
+gpu_watch_sched::demand_update_(const watch_demand_t& demand, bool add) {
+    for (auto gpu_it = demand.gpu_ids.begin();
+         gpu_it != demand.gpu_ids.end(); gpu_it++) {
+        for (auto attr_it = demand.attrs.begin();
+             attr_it != demand.attrs.end(); attr_it++) {
+            attr_demand_update_(*gpu_it, *attr_it, demand.interval, add);
+        }
+    }
+    interval_update_(demand.interval, add);
+}
+
+void
+gpu_watch_sched::watch_add(const aga_obj_key_t& key,
+                           const std::vector<uint32_t>& gpu_ids,
+                           const aga_gpu_watch_attr_id_t *attrs,
+                           uint16_t num_attrs, uint32_t interval) {
+    watch_demand_t demand;
+
+    demand.gpu_ids = gpu_ids;
+    demand.attrs.assign(attrs, attrs + num_attrs);
+    demand.interval = interval;
+    demand.last_notified = 0;
+    SDK_SPINLOCK_LOCK(&slock_);
+    auto it = watches_.find(key);
+    if (it != watches_.end()) {
+        demand_update_(it->second, false);
+        watches_.erase(it);
+    }
+    demand_update_(demand, true);
+    watches_[key] = demand;
+    SDK_SPINLOCK_UNLOCK(&slock_);
+}
+
+void
+gpu_watch_sched::watch_del(const aga_obj_key_t& key) {
+    SDK_SPINLOCK_LOCK(&slock_);
+    auto it = watches_.find(key);
+    if (it != watches_.end()) {
+        demand_update_(it->second, false);
+        watches_.erase(it);
+    }
+    SDK_SPINLOCK_UNLOCK(&slock_);
+}
+
+void
+gpu_watch_sched::lease(uint32_t gpu_id, const aga_gpu_watch_attr_id_t *attrs,
+                       uint16_t num_attrs, uint32_t ttl) {
+    uint32_t attr;
+    timespec_t now_ts;
+    uint64_t now_ns, expiry;
+
+    clock_gettime(CLOCK_MONOTONIC, &now_ts);
+    sdk::timestamp_to_nsecs(&now_ts, &now_ns);
+    expiry = (now_ns / TIME_NSECS_PER_MSEC) + ttl;
+    SDK_SPINLOCK_LOCK(&slock_);
+    for (uint16_t i = 0; i < num_attrs; i++) {
+        attr = attrs[i];
+        if (lease_expiry_[gpu_id][attr] == 0) {
+            // new lease, each leased attribute holds its own demand
+            attr_demand_update_(gpu_id, attr, AGA_GPU_WATCH_LEASE_INTERVAL,
+                                true);
+            interval_update_(AGA_GPU_WATCH_LEASE_INTERVAL, true);
+        }
+        if (expiry > lease_expiry_[gpu_id][attr]) {
+            lease_expiry_[gpu_id][attr] = expiry;
+        }
+    }
+    SDK_SPINLOCK_UNLOCK(&slock_);
+}
+
+uint32_t
+gpu_watch_sched::tick_interval(void) {
+    uint32_t tick;
+
+    SDK_SPINLOCK_LOCK(&slock_);
+    tick = tick_;
+    SDK_SPINLOCK_UNLOCK(&slock_);
+    return tick;
+}
+
+void
+gpu_watch_sched::due_attrs(uint64_t now, uint32_t num_gpu,
+                           aga_gpu_watch_attr_set_t *due) {
+    SDK_SPINLOCK_LOCK(&slock_);
+    for (uint32_t gpu = 0; gpu < num_gpu; gpu++) {
+        due[gpu].reset();
+        for (uint32_t attr = 0; attr < AGA_GPU_WATCH_ATTRS_MAX; attr++) {
+            if (lease_expiry_[gpu][attr] &&
+                (now >= lease_expiry_[gpu][attr])) {
+                // no one read the attribute for a while, stop sampling it
+                // unless a watch needs it
+                lease_expiry_[gpu][attr] = 0;
+                attr_demand_update_(gpu, attr, AGA_GPU_WATCH_LEASE_INTERVAL,
+                                    false);
+                interval_update_(AGA_GPU_WATCH_LEASE_INTERVAL, false);
+            }
+            if (interval_[gpu][attr] &&
+                due_(now, last_sampled_[gpu][attr], interval_[gpu][attr])) {
+                due[gpu].set(attr);
+                last_sampled_[gpu][attr] = now;
+            }
+        }
+    }
+    SDK_SPINLOCK_UNLOCK(&slock_);
+}
+
+bool
+gpu_watch_sched::watch_due(const aga_obj_key_t& key, uint64_t now) {
+    bool due = false;
+
+    SDK_SPINLOCK_LOCK(&slock_);
+    auto it = watches_.find(key);
+    if ((it != watches_.end()) &&
+        due_(now, it->second.last_notified, it->second.interval)) {
+        it->second.last_notified = now;
+        due = true;
+    }
+    SDK_SPINLOCK_UNLOCK(&slock_);
+    return due;
+}
+
+/// \@}
+
+}    // namespace aga
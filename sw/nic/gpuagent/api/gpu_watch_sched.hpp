@@ -0,0 +1,187 @@
+
+/*
+Copyright (c) Advanced Micro Devices, Inc. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+//----------------------------------------------------------------------------
+///
+/// \file
+/// GPU watch sampling scheduler, tracks how often each attribute of each GPU
+/// needs to be sampled based on the sampling intervals of all the live watches
+///
+//----------------------------------------------------------------------------
+
+#ifndef __AGA_GPU_WATCH_SCHED_HPP__
+#define __AGA_GPU_WATCH_SCHED_HPP__
+
+#include <bitset>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include "nic/sdk/include/sdk/base.hpp"
+#include "nic/sdk/include/sdk/lock.hpp"
+#include "nic/gpuagent/api/include/aga_gpu_watch.hpp"
+
+/// \defgroup AGA_GPU_WATCH_SCHED - GPU watch sampling scheduler
+/// \ingroup AGA
+/// @{
+
+/// interval at which leased attributes are sampled (in milliseconds)
+#define AGA_GPU_WATCH_LEASE_INTERVAL    1000
+
+namespace aga {
+
+/// \brief    set of GPU watch attributes, indexed by attribute id
+typedef std::bitset<AGA_GPU_WATCH_ATTRS_MAX> aga_gpu_watch_attr_set_t;
+
+/// \brief    GPU watch sampling scheduler, every watch registers the GPUs
+///           and attributes it is interested in along with its sampling
+///           interval, and readers that aren't watches (GPU stats, history
+///           queries) lease the attributes they read for a while; each
+///           attribute of a GPU is then sampled at the fastest interval
+///           anyone needs and not sampled at all if no one needs it
+/// \remark   watches are added/deleted from the API thread while the watcher
+///           thread queries the schedule, so all operations are serialized
+///           with a spinlock
+class gpu_watch_sched {
+public:
+    /// \brief constructor
+    gpu_watch_sched();
+
+    /// \brief destructor
+    ~gpu_watch_sched();
+
+    /// \brief     register the sampling demand of a watch
+    /// \param[in] key          key of the watch
+    /// \param[in] gpu_ids      ids of the GPUs watched
+    /// \param[in] attrs        attributes watched
+    /// \param[in] num_attrs    no. of attributes watched
+    /// \param[in] interval     sampling interval (in milliseconds)
+    void watch_add(const aga_obj_key_t& key,
+                   const std::vector<uint32_t>& gpu_ids,
+                   const aga_gpu_watch_attr_id_t *attrs, uint16_t num_attrs,
+                   uint32_t interval);
+
+    /// \brief     unregister the sampling demand of a watch
+    /// \param[in] key    key of the watch
+    void watch_del(const aga_obj_key_t& key);
+
+    /// \brief     keep sampling attributes of a GPU at the lease interval
+    ///            until the lease expires, renewing the lease if it is held
+    ///            already
+    /// \param[in] gpu_id       GPU id (aka. index)
+    /// \param[in] attrs        attributes needed
+    /// \param[in] num_attrs    no. of attributes needed
+    /// \param[in] ttl          how long to keep sampling (in milliseconds)
+    /// \remark    attributes leased for the first time are sampled from the
+    ///            next tick on, until then readers see the last sampled
+    ///            values
+    void lease(uint32_t gpu_id, const aga_gpu_watch_attr_id_t *attrs,
+               uint16_t num_attrs, uint32_t ttl);
+
+    /// \brief    return the interval the watcher needs to wake up at to
+    ///           honor all the registered sampling intervals
+    /// \return   tick interval (in milliseconds), 0 if nothing is registered
+    uint32_t tick_interval(void);
+
+    /// \brief      compute the attributes that are due for sampling on each
+    ///             GPU and mark them as sampled, dropping expired leases
+    /// \param[in]  now        current time (in milliseconds)
+    /// \param[in]  num_gpu    no. of GPUs
+    /// \param[out] due        per GPU set of attributes to be sampled
+    void due_attrs(uint64_t now, uint32_t num_gpu,
+                   aga_gpu_watch_attr_set_t *due);
+
+    /// \brief     check if a watch is due for publishing to its subscribers
+    ///            and if so, mark it as published
+    /// \param[in] key    key of the watch
+    /// \param[in] now    current time (in milliseconds)
+    /// \return    true if the watch is due, false otherwise
+    bool watch_due(const aga_obj_key_t& key, uint64_t now);
+
+private:
+    /// \brief    sampling demand of a watch
+    typedef struct watch_demand_s {
+        /// ids of the GPUs watched
+        std::vector<uint32_t> gpu_ids;
+        /// attributes watched
+        std::vector<aga_gpu_watch_attr_id_t> attrs;
+        /// sampling interval (in milliseconds)
+        uint32_t interval;
+        /// last time the watch was published (in milliseconds)
+        uint64_t last_notified;
+    } watch_demand_t;
+
+    /// \brief     add or remove the demand of a watch to/from the per GPU,
+    ///            per attribute interval refcounts
+    /// \param[in] demand    sampling demand of the watch
+    /// \param[in] add       true to add the demand, false to remove it
+    void demand_update_(const watch_demand_t& demand, bool add);
+
+    /// \brief     add or remove a sampling interval demanded for an
+    ///            attribute of a GPU
+    /// \param[in] gpu         GPU id
+    /// \param[in] attr        attribute id
+    /// \param[in] interval    sampling interval (in milliseconds)
+    /// \param[in] add         true to add the demand, false to remove it
+    void attr_demand_update_(uint32_t gpu, uint32_t attr, uint32_t interval,
+                             bool add);
+
+    /// \brief     add or remove a sampling interval to/from the intervals
+    ///            the watcher needs to wake up for
+    /// \param[in] interval    sampling interval (in milliseconds)
+    /// \param[in] add         true to add the interval, false to remove it
+    void interval_update_(uint32_t interval, bool add);
+
+    /// \brief    return true if a sample or publish last done at the given
+    ///           time is due again at the given interval
+    bool due_(uint64_t now, uint64_t last, uint32_t interval) const {
+        // tolerate timer jitter of upto half a tick
+        return (last == 0) || ((now + (tick_ >> 1)) >= (last + interval));
+    }
+
+private:
+    /// lock to serialize API and watcher threads
+    sdk_spinlock_t slock_;
+    /// sampling demand of each watch
+    std::unordered_map<aga_obj_key_t, watch_demand_t,
+                       aga_obj_key_hash> watches_;
+    /// refcount of each sampling interval demanded, per GPU attribute,
+    /// keyed by (GPU id, attribute id)
+    std::unordered_map<uint32_t, std::map<uint32_t, uint32_t>> demand_;
+    /// refcount of each sampling interval across all watches
+    std::map<uint32_t, uint32_t> intervals_;
+    /// fastest sampling interval demanded per GPU attribute, 0 if none
+    uint32_t interval_[AGA_MAX_GPU][AGA_GPU_WATCH_ATTRS_MAX];
+    /// last time each GPU attribute was sampled (in milliseconds)
+    uint64_t last_sampled_[AGA_MAX_GPU][AGA_GPU_WATCH_ATTRS_MAX];
+    /// time each GPU attribute lease expires (in milliseconds), 0 if the
+    /// attribute is not leased
+    uint64_t lease_expiry_[AGA_MAX_GPU][AGA_GPU_WATCH_ATTRS_MAX];
+    /// current tick interval (in milliseconds)
+    uint32_t tick_;
+};
+
+/// global singleton GPU watch sampling scheduler instance
+extern gpu_watch_sched g_gpu_watch_sched;
+
+/// \@}
+
+}    // namespace aga
+
+using aga::gpu_watch_sched;
+
+#endif    // __AGA_GPU_WATCH_SCHED_HPP__
@@ -0,0 +1,296 @@
+
+/*
+Copyright (c) Advanced Micro Devices, Inc. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+//----------------------------------------------------------------------------
+///
+/// \file
+/// GPU watch snapshot implementation
+///
+//----------------------------------------------------------------------------
+
+#include <algorithm>
+#include "nic/gpuagent/api/gpu_watch_snapshot.hpp"
+
+namespace aga {
+
+/// \defgroup AGA_GPU_WATCH_SNAPSHOT - GPU watch snapshot functionality
+/// \ingroup AGA_GPU_WATCH
+/// \@{
+
+/// global singleton GPU watch snapshot instance
+gpu_watch_snapshot g_gpu_watch_snapshot;
+
+gpu_watch_snapshot::gpu_watch_snapshot() {
+    memset(bufs_, 0, sizeof(bufs_));
+    for (uint32_t i = 0; i < AGA_GPU_WATCH_SNAPSHOT_NUM_BUFS; i++) {
+        readers_[i].store(0);
+    }
+    published_.store(0);
+}
+
+aga_gpu_watch_db_t *
+gpu_watch_snapshot::writer_begin(uint32_t num_gpu) {
+    uint32_t published = published_.load();
+
+    // pick a buffer that is neither published nor pinned by any reader
+    for (uint32_t i = 0; i < AGA_GPU_WATCH_SNAPSHOT_NUM_BUFS; i++) {
+        if ((i != published) && (readers_[i].load() == 0)) {
+            // start off with the latest published values, so the fields not
+            // sampled in this round carry their last sampled values
+            memcpy(bufs_[i].watch_info, bufs_[published].watch_info,
+                   sizeof(aga_gpu_watch_fields_t) *
+                       std::min(num_gpu, (uint32_t)AGA_MAX_GPU));
+            return &bufs_[i];
+        }
+    }
+    return NULL;
+}
+
+void
+gpu_watch_snapshot::writer_publish(aga_gpu_watch_db_t *watch_db) {
+    published_.store(buf_idx_(watch_db));
+}
+
+const aga_gpu_watch_db_t *
+gpu_watch_snapshot::reader_get(void) {
+    uint32_t idx;
+
+    while (true) {
+        idx = published_.load();
+        readers_[idx].fetch_add(1);
+        // if the writer published another buffer before we pinned this one,
+        // writer may be filling it already, so retry with the latest one
+        if (likely(idx == published_.load())) {
+            break;
+        }
+        readers_[idx].fetch_sub(1);
+    }
+    return &bufs_[idx];
+}
+
+void
+gpu_watch_snapshot::reader_put(const aga_gpu_watch_db_t *watch_db) {
+    readers_[buf_idx_(watch_db)].fetch_sub(1);
+}
+
+sdk_ret_t
+gpu_watch_field_get (const aga_gpu_watch_fields_t& fields,
+                     aga_gpu_watch_attr_id_t attr_id, uint64_t *value)
+{
+    switch (attr_id) {
+    case AGA_GPU_WATCH_ATTR_ID_GPU_CLOCK:
+        *value = fields.gpu_clock;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_MEM_CLOCK:
+        *value = fields.memory_clock;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_GPU_TEMP:
+        *value = fields.gpu_temperature;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_MEMORY_TEMP:
+        *value = fields.memory_temperature;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_POWER_USAGE:
+        *value = fields.power_usage;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_PCIE_TX:
+        *value = fields.pcie_tx_usage;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_PCIE_RX:
+        *value = fields.pcie_rx_usage;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_PCIE_BANDWIDTH:
+        *value = fields.pcie_bandwidth;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_GPU_UTIL:
+        *value = fields.gpu_util;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_GPU_MEMORY_USAGE:
+        *value = fields.gpu_memory_usage;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_CORRECT_TOTAL:
+        *value = fields.total_correctable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_UNCORRECT_TOTAL:
+        *value = fields.total_uncorrectable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_SDMA_CE:
+        *value = fields.sdma_correctable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_SDMA_UE:
+        *value = fields.sdma_uncorrectable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_GFX_CE:
+        *value = fields.gfx_correctable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_GFX_UE:
+        *value = fields.gfx_uncorrectable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_MMHUB_CE:
+        *value = fields.mmhub_correctable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_MMHUB_UE:
+        *value = fields.mmhub_uncorrectable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_ATHUB_CE:
+        *value = fields.athub_correctable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_ATHUB_UE:
+        *value = fields.athub_uncorrectable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_PCIE_BIF_CE:
+        *value = fields.bif_correctable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_PCIE_BIF_UE:
+        *value = fields.bif_uncorrectable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_HDP_CE:
+        *value = fields.hdp_correctable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_HDP_UE:
+        *value = fields.hdp_uncorrectable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_XGMI_WAFL_CE:
+        *value = fields.xgmi_wafl_correctable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_XGMI_WAFL_UE:
+        *value = fields.xgmi_wafl_uncorrectable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_DF_CE:
+        *value = fields.df_correctable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_DF_UE:
+        *value = fields.df_uncorrectable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_SMN_CE:
+        *value = fields.smn_correctable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_SMN_UE:
+        *value = fields.smn_uncorrectable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_SEM_CE:
+        *value = fields.sem_correctable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_SEM_UE:
+        *value = fields.sem_uncorrectable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_MP0_CE:
+        *value = fields.mp0_correctable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_MP0_UE:
+        *value = fields.mp0_uncorrectable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_MP1_CE:
+        *value = fields.mp1_correctable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_MP1_UE:
+        *value = fields.mp1_uncorrectable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_FUSE_CE:
+        *value = fields.fuse_correctable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_FUSE_UE:
+        *value = fields.fuse_uncorrectable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_UMC_CE:
+        *value = fields.umc_correctable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_UMC_UE:
+        *value = fields.umc_uncorrectable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_MCA_CE:
+        *value = fields.mca_correctable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_MCA_UE:
+        *value = fields.mca_uncorrectable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_VCN_CE:
+        *value = fields.vcn_correctable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_VCN_UE:
+        *value = fields.vcn_uncorrectable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_JPEG_CE:
+        *value = fields.jpeg_correctable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_JPEG_UE:
+        *value = fields.jpeg_uncorrectable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_IH_CE:
+        *value = fields.ih_correctable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_IH_UE:
+        *value = fields.ih_uncorrectable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_MPIO_CE:
+        *value = fields.mpio_correctable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_ECC_MPIO_UE:
+        *value = fields.mpio_uncorrectable_errors;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_XGMI_0_NOP_TX:
+        *value = fields.xgmi_neighbor0_tx_nops;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_XGMI_0_REQ_TX:
+        *value = fields.xgmi_neighbor0_tx_requests;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_XGMI_0_RESP_TX:
+        *value = fields.xgmi_neighbor0_tx_responses;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_XGMI_0_BEATS_TX:
+        *value = fields.xgmi_neighbor0_tx_beats;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_XGMI_1_NOP_TX:
+        *value = fields.xgmi_neighbor1_tx_nops;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_XGMI_1_REQ_TX:
+        *value = fields.xgmi_neighbor1_tx_requests;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_XGMI_1_RESP_TX:
+        *value = fields.xgmi_neighbor1_tx_responses;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_XGMI_1_BEATS_TX:
+        *value = fields.xgmi_neighbor1_tx_beats;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_XGMI_0_THRPUT:
+        *value = fields.xgmi_neighbor0_tx_throughput;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_XGMI_1_THRPUT:
+        *value = fields.xgmi_neighbor1_tx_throughput;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_XGMI_2_THRPUT:
+        *value = fields.xgmi_neighbor2_tx_throughput;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_XGMI_3_THRPUT:
+        *value = fields.xgmi_neighbor3_tx_throughput;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_XGMI_4_THRPUT:
+        *value = fields.xgmi_neighbor4_tx_throughput;
+        break;
+    case AGA_GPU_WATCH_ATTR_ID_XGMI_5_THRPUT:
+        *value = fields.xgmi_neighbor5_tx_throughput;
+        break;
+    default:
+        return SDK_RET_INVALID_ARG;
+    }
+    return SDK_RET_OK;
+}
+
+/// \@}
+
+}    // namespace aga
@@ -0,0 +1,137 @@
+
+/*
+Copyright (c) Advanced Micro Devices, Inc. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+//----------------------------------------------------------------------------
+///
+/// \file
+/// GPU watch snapshot published by the watcher and read by the API layer
+///
+//----------------------------------------------------------------------------
+
+#ifndef __AGA_GPU_WATCH_SNAPSHOT_HPP__
+#define __AGA_GPU_WATCH_SNAPSHOT_HPP__
+
+#include <atomic>
+#include "nic/sdk/include/sdk/base.hpp"
+#include "nic/gpuagent/api/internal/aga_gpu_watch.hpp"
+
+/// \defgroup AGA_GPU_WATCH_SNAPSHOT - GPU watch snapshot functionality
+/// \ingroup AGA
+/// @{
+
+/// number of watch db buffers, one published, one being filled by the
+/// watcher and one spare for readers that are still on the previous snapshot
+#define AGA_GPU_WATCH_SNAPSHOT_NUM_BUFS    3
+
+namespace aga {
+
+/// \brief    triple buffered GPU watch db, watcher (single writer) fills a
+///           buffer that is neither published nor being read and publishes
+///           it with a pointer swap; readers pin the published buffer for
+///           the duration of their read without taking any locks
+class gpu_watch_snapshot {
+public:
+    /// \brief constructor
+    gpu_watch_snapshot();
+
+    /// \brief destructor
+    ~gpu_watch_snapshot() {}
+
+    /// \brief     get a buffer that the writer can fill in, pre-populated
+    ///            with the contents of the latest published buffer
+    /// \param[in] num_gpu    no. of GPUs, fields of the GPUs beyond are
+    ///                       never filled so are not carried over
+    /// \return    pointer to the buffer or NULL if all the buffers are in use
+    aga_gpu_watch_db_t *writer_begin(uint32_t num_gpu);
+
+    /// \brief     publish the buffer filled by the writer
+    /// \param[in] watch_db    buffer returned by writer_begin()
+    void writer_publish(aga_gpu_watch_db_t *watch_db);
+
+    /// \brief    pin and return the latest published buffer
+    /// \return   pointer to the latest watch db, must be released with
+    ///           reader_put() once done
+    const aga_gpu_watch_db_t *reader_get(void);
+
+    /// \brief     release the buffer pinned by reader_get()
+    /// \param[in] watch_db    buffer returned by reader_get()
+    void reader_put(const aga_gpu_watch_db_t *watch_db);
+
+private:
+    /// \brief     return the index of the given buffer
+    /// \param[in] watch_db    pointer to one of the buffers
+    /// \return    index of the buffer
+    uint32_t buf_idx_(const aga_gpu_watch_db_t *watch_db) const {
+        return watch_db - bufs_;
+    }
+
+private:
+    /// watch db buffers
+    aga_gpu_watch_db_t bufs_[AGA_GPU_WATCH_SNAPSHOT_NUM_BUFS];
+    /// no. of readers currently using each of the buffers
+    std::atomic<uint32_t> readers_[AGA_GPU_WATCH_SNAPSHOT_NUM_BUFS];
+    /// index of the currently published buffer
+    std::atomic<uint32_t> published_;
+};
+
+/// global singleton GPU watch snapshot instance
+extern gpu_watch_snapshot g_gpu_watch_snapshot;
+
+/// \brief      read the watch field backing the given attribute
+/// \param[in]  fields     watch fields of a GPU
+/// \param[in]  attr_id    watch attribute identifier
+/// \param[out] value      value of the watch field
+/// \return     SDK_RET_OK on success, SDK_RET_INVALID_ARG if the attribute
+///             is unknown
+sdk_ret_t gpu_watch_field_get(const aga_gpu_watch_fields_t& fields,
+                              aga_gpu_watch_attr_id_t attr_id,
+                              uint64_t *value);
+
+/// \brief    RAII helper to pin the latest GPU watch snapshot
+class gpu_watch_snapshot_guard {
+public:
+    /// \brief constructor
+    gpu_watch_snapshot_guard() {
+        watch_db_ = g_gpu_watch_snapshot.reader_get();
+    }
+
+    /// \brief destructor
+    ~gpu_watch_snapshot_guard() {
+        g_gpu_watch_snapshot.reader_put(watch_db_);
+    }
+
+    /// \brief     return the watch fields of the given GPU
+    /// \param[in] gpu_id    GPU id (aka. index)
+    /// \return    pointer to the watch fields
+    const aga_gpu_watch_fields_t *watch_fields(uint32_t gpu_id) const {
+        return &watch_db_->watch_info[gpu_id];
+    }
+
+private:
+    /// pinned watch db
+    const aga_gpu_watch_db_t *watch_db_;
+};
+
+/// \@}
+
+}    // namespace aga
+
+using aga::gpu_watch_snapshot;
+using aga::gpu_watch_snapshot_guard;
+
+#endif    // __AGA_GPU_WATCH_SNAPSHOT_HPP__
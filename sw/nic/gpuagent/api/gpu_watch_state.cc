@@ -44,14 +44,10 @@ sdk_ret_t
 gpu_watch_state::insert(gpu_watch_entry *entry) {
     sdk_ret_t ret;
 
-    // take lock before inserting entry
-    std::lock_guard<std::mutex> lock(gpu_watch_key_lock_);
-    auto it = gpu_watch_key_db_.find(entry->key_);
-    if (it != gpu_watch_key_db_.end()) {
+    if (!gpu_watch_key_db_.insert(entry->key_, entry)) {
         AGA_STATE_CNTR_INSERT_ERR_INC();
         ret = SDK_RET_ENTRY_EXISTS;
     } else {
-        gpu_watch_key_db_[entry->key_] = entry;
         AGA_STATE_CNTR_INSERT_OK_INC();
         AGA_STATE_CNTR_NUM_ELEMS_INC();
         ret = SDK_RET_OK;
@@ -61,21 +57,16 @@ gpu_watch_state::insert(gpu_watch_entry *entry) {
 
 gpu_watch_entry *
 gpu_watch_state::remove(gpu_watch_entry *entry) {
-    void *rv;
+    gpu_watch_entry *rv;
 
-    // take lock before removing entry
-    std::lock_guard<std::mutex> lock(gpu_watch_key_lock_);
-    auto it = gpu_watch_key_db_.find(entry->key_);
-    if (it == gpu_watch_key_db_.end()) {
+    if (!gpu_watch_key_db_.erase(entry->key_, &rv)) {
         AGA_STATE_CNTR_REMOVE_ERR_INC();
         rv = NULL;
     } else {
-        rv = it->second;
-        gpu_watch_key_db_.erase(entry->key_);
         AGA_STATE_CNTR_REMOVE_OK_INC();
         AGA_STATE_CNTR_NUM_ELEMS_DEC();
     }
-    return (gpu_watch_entry *)rv;
+    return rv;
 }
 
 void
@@ -85,28 +76,19 @@ gpu_watch_state::free(gpu_watch_entry *entry) {
 
 gpu_watch_entry *
 gpu_watch_state::find(aga_obj_key_t *key) const {
-    // take lock before searching for gpu watch entries
-    std::lock_guard<std::mutex> lock(gpu_watch_key_lock_);
-    auto it = gpu_watch_key_db_.find(*key);
-    if (it != gpu_watch_key_db_.end()) {
-        return it->second;
+    gpu_watch_entry *entry;
+
+    if (gpu_watch_key_db_.find(*key, &entry)) {
+        return entry;
     }
     return NULL;
 }
 
 sdk_ret_t
 gpu_watch_state::walk(state_walk_cb_t walk_cb, void *ctxt) {
-    bool stop;
-
-    // take lock before walking gpu watch entries
-    std::lock_guard<std::mutex> lock(gpu_watch_key_lock_);
-    for (auto iter = gpu_watch_key_db_.begin(); iter != gpu_watch_key_db_.end();
-         ++iter) {
-        stop = walk_cb(iter->second, ctxt);
-        if (stop) {
-            break;
-        }
-    }
+    gpu_watch_key_db_.walk([walk_cb, ctxt](gpu_watch_entry *entry) {
+        return walk_cb(entry, ctxt);
+    });
     return SDK_RET_OK;
 }
 
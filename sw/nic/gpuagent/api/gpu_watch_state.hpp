@@ -28,6 +28,7 @@ limitations under the License.
 
 #include "nic/gpuagent/api/gpu_watch.hpp"
 #include "nic/gpuagent/core/state_base.hpp"
+#include "nic/gpuagent/core/rcu_db.hpp"
 #include "nic/gpuagent/api/aga_state.hpp"
 
 /// \defgroup AGA_GPU_WATCH_STATE - GPU state functionality
@@ -37,8 +38,8 @@ limitations under the License.
 namespace aga {
 
 /// \brief gpu watch entry map with uuid as the key
-typedef std::unordered_map<aga_obj_key_t, gpu_watch_entry *,
-                           aga_obj_key_hash> gpu_watch_key_db_t;
+typedef rcu_db<aga_obj_key_t, gpu_watch_entry *,
+               aga_obj_key_hash> gpu_watch_key_db_t;
 
 /// \brief state maintained for GPUs
 class gpu_watch_state : public state_base {
@@ -86,10 +87,9 @@ private:
     friend class gpu_watch_entry;
 
 private:
-    /// map to store GPU watch objects keyed by uuid
+    /// map to store GPU watch objects keyed by uuid; read without any locks
+    /// from gRPC and watcher threads while the API thread updates it
     gpu_watch_key_db_t gpu_watch_key_db_;
-    /// mutex to be used when adding/deleting/walking GPU watch key db
-    mutable std::mutex gpu_watch_key_lock_;
 };
 
 /// \brief   return gpu watch object given the key
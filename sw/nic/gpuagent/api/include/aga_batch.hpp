@@ -0,0 +1,73 @@
+
+/*
+Copyright (c) Advanced Micro Devices, Inc. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+//----------------------------------------------------------------------------
+///
+/// \file
+/// API batching related definitions and APIs
+///
+//----------------------------------------------------------------------------
+
+#ifndef __API_INCLUDE_AGA_BATCH_HPP__
+#define __API_INCLUDE_AGA_BATCH_HPP__
+
+#include "nic/sdk/include/sdk/base.hpp"
+
+/// \brief batch context, an opaque handle to a batch of API calls
+typedef uint64_t aga_batch_ctxt_t;
+
+/// invalid batch context, APIs issued with this context are processed
+/// individually
+#define AGA_BATCH_CTXT_INVALID        ((aga_batch_ctxt_t)0)
+
+/// \brief async batch response callback type
+/// \param[in] status    status/result of the batch processing
+/// \param[in] cookie    cookie passed in aga_batch_params_t
+typedef void (*aga_batch_rsp_cb_t)(sdk_ret_t status, const void *cookie);
+
+/// \brief batch parameters
+typedef struct aga_batch_params_s {
+    /// process the batch asynchronously
+    bool async;
+    /// callback invoked once the batch is processed, if async is true
+    aga_batch_rsp_cb_t response_cb;
+    /// opaque cookie passed back in the response callback
+    void *cookie;
+} aga_batch_params_t;
+
+/// \brief     start a new batch of API calls; APIs issued with the returned
+///            batch context are accumulated and processed, in order, only
+///            when the batch is committed
+/// \param[in] params    batch parameters
+/// \return    batch context or AGA_BATCH_CTXT_INVALID in case of failure
+aga_batch_ctxt_t aga_batch_start(_In_ aga_batch_params_t *params);
+
+/// \brief     commit the batch; all the APIs in the batch are processed in one
+///            go and either all of them take effect or none of them do.
+///            batch context is released after this call and can't be used
+///            anymore irrespective of the outcome
+/// \param[in] bctxt    batch context
+/// \return    #SDK_RET_OK on success, failure status code on error
+sdk_ret_t aga_batch_commit(_In_ aga_batch_ctxt_t bctxt);
+
+/// \brief     discard an uncommitted batch along with all the APIs in it
+/// \param[in] bctxt    batch context
+/// \return    #SDK_RET_OK on success, failure status code on error
+sdk_ret_t aga_batch_destroy(_In_ aga_batch_ctxt_t bctxt);
+
+#endif    // __API_INCLUDE_AGA_BATCH_HPP__
@@ -96,8 +96,23 @@ typedef struct aga_event_filter_ctxt_s {
     aga_obj_key_t gpu[AGA_MAX_GPU];
 } aga_event_filter_ctxt_t;
 
+/// \brief    event history query
+/// NOTE:
+/// events not matching all the specified criteria are skipped
+typedef struct aga_event_query_s {
+    /// only events with sequence number greater than this are returned
+    uint64_t since_seq;
+    /// if non-zero, only events that happened at or after this are returned
+    timespec_t start_time;
+    /// if non-zero, only events that happened at or before this are returned
+    timespec_t end_time;
+} aga_event_query_t;
+
 /// \brief    event record
 typedef struct aga_event_s {
+    /// sequence number of the event, assigned in the order events are
+    /// reported across all GPUs and starting from 1
+    uint64_t seq;
     /// unique event identifier
     aga_event_id_t id;
     /// event category
@@ -120,6 +135,11 @@ typedef struct aga_event_s {
 typedef sdk_ret_t (*aga_event_cb_t)(const aga_event_t *event,
                                     void *client_ctxt);
 
+/// \brief    callback invoked once the backend stops notifying a client
+///           stream, backend doesn't access the stream after this
+/// \param[in] stream    opaque stream context passed in subscribe request
+typedef void (*aga_event_close_cb_t)(void *stream);
+
 /// \brief event subscribe request from a gRPC client
 typedef struct aga_event_subscribe_req_s {
     /// number of events
@@ -138,6 +158,12 @@ typedef struct aga_event_subscribe_req_s {
     void *stream;
     /// callback API to notify event the client stream
     aga_event_cb_t notify_cb;
+    /// callback API to release the client stream
+    aga_event_close_cb_t close_cb;
+    /// if non-zero, events of interest still in the event history with
+    /// sequence number greater than or equal to this are replayed to the
+    /// client before any new event is notified
+    uint64_t resume_seq;
 } aga_event_subscribe_req_t;
 
 /// \brief event generation request
@@ -154,14 +180,19 @@ typedef struct aga_event_gen_req_s {
 
 typedef void (*aga_event_read_cb_t)(const aga_event_t *event, void *ctxt);
 
-/// \brief    read all event information
-/// \param[in]  cb      callback function
-/// \param[in]  ctxt    opaque context passed to cb
+/// \brief    read all the events in the event history of all GPUs, events of
+///           a GPU are passed to the callback in the order they happened
+/// \param[in]  cb       callback function
+/// \param[in]  ctxt     opaque context passed to cb
+/// \param[in]  query    if not NULL, only events matching the query are read
 /// \return #SDK_RET_OK on success, failure status code on error
 sdk_ret_t aga_event_read_all(_In_ aga_event_read_cb_t gpu_read_cb,
-                             _In_ void *ctxt);
+                             _In_ void *ctxt,
+                             _In_ const aga_event_query_t *query = NULL);
 
-/// \brief    event subscribe
+/// \brief    event subscribe, returns once the subscriber is registered with
+///           the backend; close_cb is invoked on the stream when the backend
+///           finds the client unreachable
 /// \param[in] req    pointer to event subscribe request
 /// \return #SDK_RET_OK on success, failure status code on error
 sdk_ret_t aga_event_subscribe(_In_ aga_event_subscribe_req_t *req);
@@ -25,12 +25,14 @@ limitations under the License.
 
 #include "nic/sdk/include/sdk/base.hpp"
 #include "nic/gpuagent/api/include/base.hpp"
+#include "nic/gpuagent/api/include/aga_batch.hpp"
 #include "nic/gpuagent/api/smi/smi.hpp"
 
 #define AGA_GPU_MAX_CLOCK_FREQUENCY            6
 #define AGA_GPU_MAX_HBM                        4
 #define AGA_GPU_MAX_FIRMWARE_VERSION           85
-#define AGA_GPU_MAX_KFD_PID                    8
+// KFD itself allows no more than 512 processes
+#define AGA_GPU_MAX_KFD_PID                    512
 #define AGA_GPU_MAX_VOLTAGE_CURVE_POINT        4
 #define AGA_GPU_MIN_OVERDRIVE_LEVEL            0
 #define AGA_GPU_MAX_OVERDRIVE_LEVEL            20
@@ -685,6 +687,9 @@ typedef struct aga_gpu_stats_s {
     aga_gpu_xgmi_link_stats_t xgmi_link_stats[AGA_GPU_MAX_XGMI_LINKS];
     /// GPU violation statistics
     aga_gpu_violation_stats_t violation_stats;
+    /// time taken by the watcher to collect stats of this GPU in its last
+    /// sampling interval (in micro seconds)
+    uint64_t watch_collection_latency;
 } aga_gpu_stats_t;
 
 /// GPU info
@@ -766,22 +771,31 @@ typedef struct aga_gpu_memory_partition_info_s {
 
 /// \brief     create gpu
 /// \param[in] spec config specification
+/// \param[in] bctxt batch context, if API is to be processed as part of a
+///                  batch
 /// \return    #SDK_RET_OK on success, failure status code on error
-sdk_ret_t aga_gpu_create(_In_ aga_gpu_spec_t *spec);
+sdk_ret_t aga_gpu_create(_In_ aga_gpu_spec_t *spec,
+                         _In_ aga_batch_ctxt_t bctxt = AGA_BATCH_CTXT_INVALID);
 
 /// \brief      read gpu
 /// \param[in]  key  key of the gpu object
 /// \param[out] info information
+/// \param[in]  live true to read everything from the GPU instead of serving
+///                  the cached spec and status
 /// \return     #SDK_RET_OK on success, failure status code on error
-sdk_ret_t aga_gpu_read(_In_ aga_obj_key_t *key, _Out_ aga_gpu_info_t *info);
+sdk_ret_t aga_gpu_read(_In_ aga_obj_key_t *key, _Out_ aga_gpu_info_t *info,
+                       _In_ bool live = false);
 
 typedef void (*gpu_read_cb_t)(aga_gpu_info_t *info, void *ctxt);
 
 /// \brief    read all gpu information
 /// \param[in]  cb      callback function
 /// \param[in]  ctxt    opaque context passed to cb
+/// \param[in]  live    true to read everything from the GPUs instead of
+///                     serving the cached spec and status
 /// \return #SDK_RET_OK on success, failure status code on error
-sdk_ret_t aga_gpu_read_all(_In_ gpu_read_cb_t gpu_read_cb, _In_ void *ctxt);
+sdk_ret_t aga_gpu_read_all(_In_ gpu_read_cb_t gpu_read_cb, _In_ void *ctxt,
+                           _In_ bool live = false);
 
 /// \brief      function to get compute partition info of a given physical gpu
 ///             which has been partitioned
@@ -859,12 +873,18 @@ sdk_ret_t aga_gpu_read_topology_all(device_topology_read_cb_t gpu_read_cb,
 
 /// \brief     update gpu
 /// \param[in] spec specification
+/// \param[in] bctxt batch context, if API is to be processed as part of a
+///                  batch
 /// \return    #SDK_RET_OK on success, failure status code on error
-sdk_ret_t aga_gpu_update(_In_ aga_gpu_spec_t *spec);
+sdk_ret_t aga_gpu_update(_In_ aga_gpu_spec_t *spec,
+                         _In_ aga_batch_ctxt_t bctxt = AGA_BATCH_CTXT_INVALID);
 
 /// \brief     delete gpu object
 /// \param[in] key key
+/// \param[in] bctxt batch context, if API is to be processed as part of a
+///                  batch
 /// \return    #SDK_RET_OK on success, failure status code on error
-sdk_ret_t aga_gpu_delete(_In_ aga_obj_key_t *key);
+sdk_ret_t aga_gpu_delete(_In_ aga_obj_key_t *key,
+                         _In_ aga_batch_ctxt_t bctxt = AGA_BATCH_CTXT_INVALID);
 
 #endif    /// __API_INCLUDE_AGA_GPU_HPP__
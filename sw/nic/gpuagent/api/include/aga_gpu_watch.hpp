@@ -26,14 +26,34 @@ limitations under the License.
 #ifndef __API_INCLUDE_AGA_GPU_WATCH_HPP__
 #define __API_INCLUDE_AGA_GPU_WATCH_HPP__
 
+#include <string>
+#include <vector>
 #include "nic/sdk/include/sdk/timestamp.hpp"
 #include "nic/gpuagent/api/include/base.hpp"
+#include "nic/gpuagent/api/include/aga_batch.hpp"
 
 /// max. number of GPU watch objects
 #define AGA_MAX_GPU_WATCH                 128
 /// max. string length of string watch attribute
 #define AGA_MAX_WATCH_ATTR_STR            256
 #define AGA_MAX_GPU_WATCH_CLIENT_STR      128
+/// finest GPU watch sampling interval supported (in milliseconds), sampling
+/// intervals must be a multiple of this
+#define AGA_GPU_WATCH_SAMPLING_INTERVAL_MIN        100
+/// max. GPU watch sampling interval supported (in milliseconds)
+#define AGA_GPU_WATCH_SAMPLING_INTERVAL_MAX        3600000
+/// GPU watch sampling interval used if none is configured (in milliseconds)
+#define AGA_GPU_WATCH_SAMPLING_INTERVAL_DEFAULT    5000
+/// GPU watch history retention window used if none is configured
+/// (in seconds)
+#define AGA_GPU_WATCH_HISTORY_RETENTION_DEFAULT    600
+/// max. GPU watch history retention window supported (in seconds)
+#define AGA_GPU_WATCH_HISTORY_RETENTION_MAX        86400
+/// max. GPU watch aggregation window supported (in milliseconds)
+#define AGA_GPU_WATCH_AGG_WINDOW_MAX               3600000
+/// interval at which change only subscribers are sent all the attributes
+/// if none is configured (in milliseconds)
+#define AGA_GPU_WATCH_KEYFRAME_INTERVAL_DEFAULT    60000
 
 /// \brief    GPU attributes that are watchable
 typedef enum aga_gpu_watch_attr_id_e {
@@ -105,6 +125,20 @@ typedef enum aga_gpu_watch_attr_id_e {
     AGA_GPU_WATCH_ATTRS_MAX                   = 65,
 } aga_gpu_watch_attr_id_t;
 
+/// \brief    statistics computed over the samples of a GPU watch attribute in
+///           every aggregation window
+typedef enum aga_gpu_watch_agg_stat_e {
+    AGA_GPU_WATCH_AGG_STAT_NONE = 0,
+    AGA_GPU_WATCH_AGG_STAT_MIN  = 1,
+    AGA_GPU_WATCH_AGG_STAT_MAX  = 2,
+    AGA_GPU_WATCH_AGG_STAT_AVG  = 3,
+    AGA_GPU_WATCH_AGG_STAT_P50  = 4,
+    AGA_GPU_WATCH_AGG_STAT_P90  = 5,
+    AGA_GPU_WATCH_AGG_STAT_P95  = 6,
+    AGA_GPU_WATCH_AGG_STAT_P99  = 7,
+    AGA_GPU_WATCH_AGG_STATS_MAX = 8,
+} aga_gpu_watch_agg_stat_t;
+
 /// \brief    GPU watch attribute value type
 typedef enum aga_gpu_watch_attr_value_type_e {
     AGA_GPU_WATCH_ATTR_VALUE_TYPE_NONE   = 0,
@@ -124,20 +158,36 @@ typedef struct aga_gpu_watch_attr_value_s {
     union {
         float float_val;
         uint64_t long_val;
-        char str_val[AGA_MAX_WATCH_ATTR_STR + 1];
     };
+    /// string attribute value (upto AGA_MAX_WATCH_ATTR_STR characters),
+    /// kept out of line so numeric attributes don't pay for it
+    std::string str_val;
 } aga_gpu_watch_attr_value_t;
 
+/// \brief    statistic of a GPU watch attribute over an aggregation window
+typedef struct aga_gpu_watch_agg_value_s {
+    /// statistic
+    aga_gpu_watch_agg_stat_t stat;
+    /// value of the statistic
+    double value;
+} aga_gpu_watch_agg_value_t;
+
 /// \brief    watch GPU attribute record
 typedef struct aga_gpu_watch_attr_s {
     /// watch GPU attribute identifier
     aga_gpu_watch_attr_id_t id;
-    /// timestamp indicating when the attribute read
+    /// wall clock time when the attribute was sampled
     timespec_t timestamp;
-    /// uuid of the GPU device
-    aga_obj_key_t gpu;
-    /// attribute value
+    /// monotonic time when the attribute was sampled (in nanoseconds), not
+    /// affected by wall clock adjustments so suitable for computing rates
+    uint64_t capture_ns;
+    /// time taken to collect the sample (in micro seconds)
+    uint64_t collection_latency;
+    /// attribute value, not set if the watch is aggregated
     aga_gpu_watch_attr_value_t value;
+    /// statistics of the attribute over the last aggregation window, in the
+    /// order of the watch spec, empty if the watch is not aggregated
+    std::vector<aga_gpu_watch_agg_value_t> agg;
 } aga_gpu_watch_attr_t;
 
 /// \brief    GPU watch attributes
@@ -146,7 +196,8 @@ typedef struct aga_gpu_watch_attrs_s {
     aga_obj_key_t gpu;
     /// list of GPU watch attributes
     uint16_t num_attrs;
-    aga_gpu_watch_attr_t attr[AGA_GPU_WATCH_ATTRS_MAX];
+    /// attributes in the order of the watch spec, num_attrs entries
+    std::vector<aga_gpu_watch_attr_t> attr;
 } aga_gpu_watch_attrs_t;
 
 /// \brief GPU watch specification
@@ -159,6 +210,18 @@ typedef struct aga_gpu_watch_spec_s {
     /// list of attributes to be monitor
     uint16_t num_attrs;
     aga_gpu_watch_attr_id_t attr_id[AGA_GPU_WATCH_ATTRS_MAX];
+    /// interval at which the attributes are sampled and published to the
+    /// subscribers (in milliseconds), 0 picks the default interval
+    uint32_t sampling_interval;
+    /// if non-zero, samples are aggregated over windows of this size
+    /// (in milliseconds) and only the statistics of each window are
+    /// published to the subscribers; must be a multiple of the sampling
+    /// interval
+    uint32_t agg_window;
+    /// statistics computed over every aggregation window, min/max/avg if
+    /// none is specified
+    uint8_t num_agg_stats;
+    aga_gpu_watch_agg_stat_t agg_stat[AGA_GPU_WATCH_AGG_STATS_MAX];
 } aga_gpu_watch_spec_t;
 
 /// \brief GPU watch operational information
@@ -168,10 +231,13 @@ typedef struct aga_gpu_watch_status_s {
 } aga_gpu_watch_status_t;
 
 /// \brief GPU watch statistics
+/// \remark sized to the GPUs and attributes in the watch spec, so reusing
+///         the same instance across reads reuses its storage as well
 typedef struct aga_gpu_watch_stats_s {
     /// number of GPUs being monitored
     uint8_t num_gpu;
-    aga_gpu_watch_attrs_t gpu_watch_attr[AGA_MAX_GPU];
+    /// attributes of each GPU being monitored, num_gpu entries
+    std::vector<aga_gpu_watch_attrs_t> gpu_watch_attr;
 } aga_gpu_watch_stats_t;
 
 /// \brief GPU watch info
@@ -181,9 +247,35 @@ typedef struct aga_gpu_watch_info_s {
     aga_gpu_watch_stats_t stats;
 } aga_gpu_watch_info_t;
 
-typedef sdk_ret_t (*aga_gpu_watch_cb_t)(_In_ const aga_gpu_watch_info_t *info,
+/// \brief    callback invoked to free an encoded GPU watch update
+/// \param[in] encoded    encoded update
+typedef void (*aga_gpu_watch_encoded_free_cb_t)(_In_ void *encoded);
+
+/// \brief    GPU watch update handed to all subscribers of a GPU watch
+/// \remark   the first subscriber that needs the update in wire format
+///           encodes it and caches it here, remaining subscribers of the
+///           same watch reuse it instead of encoding it again; change only
+///           updates are built and encoded per subscriber
+typedef struct aga_gpu_watch_update_s {
+    /// GPU watch information
+    const aga_gpu_watch_info_t *info;
+    /// true if info carries only the GPUs and attributes that changed since
+    /// the last update sent to the subscriber, false if it is complete
+    bool delta;
+    /// opaque encoded update, NULL until a subscriber encodes it
+    void *encoded;
+    /// callback to free the encoded update once all subscribers are done
+    aga_gpu_watch_encoded_free_cb_t encoded_free_cb;
+} aga_gpu_watch_update_t;
+
+typedef sdk_ret_t (*aga_gpu_watch_cb_t)(_In_ aga_gpu_watch_update_t *update,
                                         _Out_ void *ctxt);
 
+/// \brief    callback invoked once the backend stops publishing to a client
+///           stream, backend doesn't access the stream after this
+/// \param[in] stream    opaque stream context passed in subscribe request
+typedef void (*aga_gpu_watch_close_cb_t)(_In_ void *stream);
+
 /// \brief    GPU watch subscribe request from a gRPC client
 typedef struct aga_gpu_watch_subscribe_req_s {
     /// number of gpu-watch ids
@@ -198,17 +290,73 @@ typedef struct aga_gpu_watch_subscribe_req_s {
     void *stream;
     /// callback API to write gpu watch info to the client stream
     aga_gpu_watch_cb_t write_cb;
+    /// callback API to release the client stream
+    aga_gpu_watch_close_cb_t close_cb;
+    /// if true, only the attributes that changed since they were last sent
+    /// to this subscriber are published
+    bool changes_only;
+    /// interval at which change only subscribers are sent all the attributes
+    /// anyway to resync (in milliseconds), 0 picks the default
+    uint32_t keyframe_interval;
+    /// changes of an attribute upto this much since the value last sent are
+    /// not published to change only subscribers, indexed by attribute id
+    double deadband[AGA_GPU_WATCH_ATTRS_MAX];
 } aga_gpu_watch_subscribe_req_t;
 
+/// \brief    GPU watch history query
+/// NOTE:
+/// only the attributes sampled for some GPU watch are remembered
+typedef struct aga_gpu_watch_history_query_s {
+    /// list of GPUs of interest, all GPUs if none is specified
+    uint8_t num_gpu;
+    aga_obj_key_t gpu[AGA_MAX_GPU];
+    /// list of attributes of interest
+    uint16_t num_attrs;
+    aga_gpu_watch_attr_id_t attr_id[AGA_GPU_WATCH_ATTRS_MAX];
+    /// if non-zero, only samples taken at or after this are returned
+    timespec_t start_time;
+    /// if non-zero, only samples taken at or before this are returned
+    timespec_t end_time;
+    /// if non-zero, only the latest sample in every window of this size
+    /// (in milliseconds, windows are aligned to the epoch) is returned
+    uint32_t resolution;
+} aga_gpu_watch_history_query_t;
+
+/// \brief    GPU watch attribute sample
+typedef struct aga_gpu_watch_sample_s {
+    /// time when the attribute was sampled
+    timespec_t timestamp;
+    /// attribute value
+    uint64_t value;
+} aga_gpu_watch_sample_t;
+
+/// \brief    remembered samples of an attribute of a GPU
+typedef struct aga_gpu_watch_series_s {
+    /// uuid of GPU
+    aga_obj_key_t gpu;
+    /// watch GPU attribute identifier
+    aga_gpu_watch_attr_id_t id;
+    /// samples from the oldest to the latest
+    std::vector<aga_gpu_watch_sample_t> sample;
+} aga_gpu_watch_series_t;
+
 /// \brief     create gpu watch object
 /// \param[in] spec config specification
+/// \param[in] bctxt batch context, if API is to be processed as part of a
+///                  batch
 /// \return    #SDK_RET_OK on success, failure status code on error
-sdk_ret_t aga_gpu_watch_create(_In_ aga_gpu_watch_spec_t *spec);
+sdk_ret_t aga_gpu_watch_create(_In_ aga_gpu_watch_spec_t *spec,
+                               _In_ aga_batch_ctxt_t bctxt =
+                                        AGA_BATCH_CTXT_INVALID);
 
 /// \brief     delete gpu watch object
 /// \param[in] key key
+/// \param[in] bctxt batch context, if API is to be processed as part of a
+///                  batch
 /// \return    #SDK_RET_OK on success, failure status code on error
-sdk_ret_t aga_gpu_watch_delete(_In_ aga_obj_key_t *key);
+sdk_ret_t aga_gpu_watch_delete(_In_ aga_obj_key_t *key,
+                               _In_ aga_batch_ctxt_t bctxt =
+                                        AGA_BATCH_CTXT_INVALID);
 
 /// \brief      read gpu watch
 /// \param[in]  key  key of the gpu object
@@ -227,7 +375,21 @@ typedef void (*gpu_watch_read_cb_t)(void *ctxt,
 sdk_ret_t aga_gpu_watch_read_all(_In_ gpu_watch_read_cb_t gpu_watch_read_cb,
                                  _In_ void *ctxt);
 
-/// \brief    gpu watch subscribe
+typedef void (*gpu_watch_history_read_cb_t)(
+                   void *ctxt, const aga_gpu_watch_series_t *series);
+
+/// \brief    read the remembered samples of GPU watch attributes
+/// \param[in]  query    GPU watch history query
+/// \param[in]  cb       callback invoked once per GPU and attribute
+/// \param[in]  ctxt     opaque context passed to cb
+/// \return #SDK_RET_OK on success, failure status code on error
+sdk_ret_t aga_gpu_watch_history_read(
+              _In_ const aga_gpu_watch_history_query_t *query,
+              _In_ gpu_watch_history_read_cb_t cb, _In_ void *ctxt);
+
+/// \brief    gpu watch subscribe, returns once the subscriber is registered
+///           with the backend; close_cb is invoked on the stream when the
+///           backend finds the client unreachable
 /// \param[in] req    pointer to gpu watch subscribe request
 /// \return #SDK_RET_OK on success, failure status code on error
 sdk_ret_t aga_gpu_watch_subscribe(aga_gpu_watch_subscribe_req_t *req);
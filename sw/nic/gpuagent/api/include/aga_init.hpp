@@ -31,6 +31,12 @@ limitations under the License.
 
 /// \brief    initialization parameters
 typedef struct aga_api_init_params_s {
+    /// max. age of cached smi data served to API readers (in milliseconds),
+    /// 0 picks the default
+    uint32_t smi_cache_ttl;
+    /// how far back GPU watch attribute samples are remembered (in seconds),
+    /// 0 picks the default
+    uint32_t gpu_watch_history_retention;
 } aga_api_init_params_t;
 
 /// \brief    initialization routine for API layer
@@ -75,8 +75,6 @@ typedef enum aga_task_e {
     AGA_TASK_NONE = 0,
     /// GPU reset task
     AGA_TASK_GPU_RESET,
-    /// update GPU stats
-    AGA_TASK_GPU_WATCH_DB_UPDATE,
     /// gpu watch subscribe add task
     AGA_TASK_GPU_WATCH_SUBSCRIBE_ADD,
     /// gpu watch subscribe delete task
@@ -93,8 +91,6 @@ typedef struct aga_task_spec_s {
     union {
         /// GPU reset task
         aga_gpu_reset_task_spec_t gpu_reset_task_spec;
-        /// GPU update watch db task
-        aga_gpu_watch_db_t watch_db;
         /// gpu watch subscribe add/del tasks
         aga_gpu_watch_subscriber_spec_t subscriber_spec;
     };
@@ -47,6 +47,8 @@ limitations under the License.
 #define AGA_MAX_SOCKET                  16
 // max. processors per num node (socket)
 #define AGA_MAX_PROCESSORS_PER_SOCKET   32
+// size of a cache line on the host
+#define AGA_CACHE_LINE_SIZE             64
 
 // error codes for objects
 // NOTE:
@@ -22,10 +22,12 @@ limitations under the License.
 
 #include "nic/sdk/include/sdk/base.hpp"
 #include "nic/sdk/include/sdk/assert.hpp"
+#include "nic/sdk/lib/periodic/periodic.hpp"
 #include "nic/gpuagent/core/trace.hpp"
 #include "nic/gpuagent/core/api_thread.hpp"
 #include "nic/gpuagent/api/include/aga_init.hpp"
 #include "nic/gpuagent/api/aga_state.hpp"
+#include "nic/gpuagent/api/gpu_watch_history.hpp"
 #include "nic/gpuagent/api/smi/smi_api.hpp"
 
 sdk_ret_t
@@ -33,15 +35,27 @@ aga_api_init (aga_api_init_params_t *init_params)
 {
     sdk_ret_t ret;
 
+    // initialize memory pools of the API processing framework
+    ret = aga::api_mem_init();
+    SDK_ASSERT(ret() == SDK_RET_OK);
     // initialize the internal state
     ret = aga::g_aga_state.init();
     SDK_ASSERT(ret() == SDK_RET_OK);
+    // spawn the periodic thread that reclaims deleted objects
+    ret = sdk::lib::spawn_periodic_event_thread(NULL);
+    SDK_ASSERT(ret() == SDK_RET_OK);
+    // wait for the periodic thread to be ready
+    while (!sdk::lib::periodic_thread_is_ready()) {
+        sched_yield();
+    }
     // spawn the API thread
     aga::spawn_api_thread(&aga::g_aga_state);
     // wait for the API thread to be ready
     while (!aga::is_api_thread_ready()) {
         sched_yield();
     }
+    // size the GPU watch history before the watcher starts feeding it
+    aga::g_gpu_watch_history.init(init_params->gpu_watch_history_retention);
     // initialize rocm-smi library
     ret = aga::smi_init(init_params);
     if (unlikely(ret != SDK_RET_OK)) {
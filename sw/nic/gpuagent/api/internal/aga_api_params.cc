@@ -34,10 +34,13 @@ limitations under the License.
 namespace aga {
 
 api_params_base *
-api_params_base::factory(void) {
+api_params_base::factory(obj_id_t obj_id, api_op_t api_op) {
     void *mem;
 
-    mem = g_aga_state.aga_api_params_alloc();
+    mem = g_aga_state.aga_api_params_alloc(obj_id, api_op);
+    if (unlikely(mem == NULL)) {
+        return NULL;
+    }
     new (mem) aga_api_params();
     return (api_params_base *)mem;
 }
@@ -52,7 +55,7 @@ api_params_base::destroy(obj_id_t obj_id, api_op_t api_op,
         default:
             break;
     }
-    g_aga_state.aga_api_params_free(api_params);
+    g_aga_state.aga_api_params_free(obj_id, api_op, api_params);
 }
 
 const aga_obj_key_t&
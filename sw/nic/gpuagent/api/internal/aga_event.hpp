@@ -35,21 +35,26 @@ using std::vector;
 typedef struct aga_event_client_ctxt_s {
     /// client IP address and port
     std::string client;
-    /// client_inactive is set to true by the backend thread when
-    /// gRPC client is no longer active
-    bool client_inactive;
-    /// condition variable the front end gRPC thread is going to wait on
-    pthread_cond_t cond;
-    /// mutex lock to keep the gRPC thread alive
-    pthread_mutex_t lock;
     /// opaque context sent from gRPC thread to backend
     /// NOTE:
     /// gRPC response stream to periodically publish events to
     void *stream;
     /// callback API to notify event to the client stream
     aga_event_cb_t notify_cb;
+    /// callback API to release the client stream
+    aga_event_close_cb_t close_cb;
 } aga_event_client_ctxt_t;
 
+/// \brief    release the client context once the backend is done with it
+/// \param[in] client_ctxt    client context to be released
+static inline void
+aga_event_client_ctxt_release (aga_event_client_ctxt_t *client_ctxt)
+{
+    // let the front end finish the stream
+    client_ctxt->close_cb(client_ctxt->stream);
+    delete client_ctxt;
+}
+
 /// \brief event subscribe info
 typedef struct aga_event_subscribe_args_s {
     /// gRPC client context
@@ -58,6 +63,8 @@ typedef struct aga_event_subscribe_args_s {
     vector<aga_event_id_t> events;
     /// GPU id list;
     vector<uint8_t> gpu_ids;
+    /// if non-zero, sequence number of the first event to be replayed
+    uint64_t resume_seq;
 } aga_event_subscribe_args_t;
 
 typedef struct aga_event_gen_args_s {
@@ -27,8 +27,10 @@ limitations under the License.
 #define __INTERNAL_AGA_GPU_WATCH_HPP__
 
 #include <vector>
+#include <unordered_map>
 #include "nic/gpuagent/api/include/base.hpp"
 #include "nic/gpuagent/api/include/aga_gpu_watch.hpp"
+#include "nic/gpuagent/api/gpu_watch_delta.hpp"
 
 using std::vector;
 
@@ -165,6 +167,20 @@ typedef struct aga_gpu_watch_fields_s {
     uint64_t xgmi_neighbor4_tx_throughput;
     /// transmit throughput to XGMI neighbor 5 (in Bytes per second)
     uint64_t xgmi_neighbor5_tx_throughput;
+    /// time taken by the latest collection of the watch fields
+    /// (in micro seconds)
+    uint64_t collection_latency;
+    /// monotonic and wall clock time when the latest collection started
+    /// (in nanoseconds)
+    uint64_t capture_mono_ns;
+    uint64_t capture_wall_ns;
+    /// monotonic time when each attribute was last sampled, attributes
+    /// sampled at longer intervals carry older values (in nanoseconds),
+    /// indexed by attribute id
+    uint64_t attr_capture_ns[AGA_GPU_WATCH_ATTRS_MAX];
+    /// time taken by the collection each attribute was last sampled in
+    /// (in micro seconds), indexed by attribute id
+    uint64_t attr_collection_latency[AGA_GPU_WATCH_ATTRS_MAX];
 } aga_gpu_watch_fields_t;
 
 typedef struct aga_gpu_watch_db_s {
@@ -175,21 +191,36 @@ typedef struct aga_gpu_watch_db_s {
 typedef struct aga_gpu_watch_client_ctxt_s {
     /// client IP address and port
     std::string client;
-    /// client_inactive is set to true by the backend thread when
-    /// gRPC client is no longer active
-    bool client_inactive;
-    /// condition variable the front end gRPC thread is going to wait on
-    pthread_cond_t cond;
-    /// mutex lock to keep the gRPC thread alive
-    pthread_mutex_t lock;
     /// opaque context sent from gRPC thread to backend
     /// NOTE:
     /// gRPC response stream to periodically publish watch attributes to
     void *stream;
     /// callback API to write gpu watch info to the client stream
     aga_gpu_watch_cb_t write_cb;
+    /// callback API to release the client stream
+    aga_gpu_watch_close_cb_t close_cb;
+    /// if true, only the attributes that changed are published
+    bool changes_only;
+    /// interval at which all the attributes are published anyway
+    /// (in milliseconds)
+    uint32_t keyframe_interval;
+    /// per attribute deadbands, indexed by attribute id
+    double deadband[AGA_GPU_WATCH_ATTRS_MAX];
+    /// values last published to the client, per GPU watch
+    std::unordered_map<aga_obj_key_t, gpu_watch_delta,
+                       aga_obj_key_hash> delta;
 } aga_gpu_watch_client_ctxt_t;
 
+/// \brief    release the client context once the backend is done with it
+/// \param[in] client_ctxt    client context to be released
+static inline void
+aga_gpu_watch_client_ctxt_release (aga_gpu_watch_client_ctxt_t *client_ctxt)
+{
+    // let the front end finish the stream
+    client_ctxt->close_cb(client_ctxt->stream);
+    delete client_ctxt;
+}
+
 /// \brief    GPU watch subscribe request from a gRPC client
 typedef struct aga_gpu_watch_subscribe_args_s {
     /// gRPC client context
@@ -23,21 +23,34 @@ limitations under the License.
 ///
 //----------------------------------------------------------------------------
 
+#include <atomic>
 #include "nic/sdk/include/sdk/base.hpp"
+#include "nic/sdk/lib/periodic/periodic.hpp"
 #include "nic/gpuagent/core/trace.hpp"
+#include "nic/gpuagent/core/rcu_db.hpp"
 #include "nic/gpuagent/api/mem.hpp"
 #include "nic/gpuagent/api/gpu.hpp"
 #include "nic/gpuagent/api/gpu_watch.hpp"
 
 namespace aga {
 
-/// \brief callback invoked by the delay delete function to release an object
+/// number of objects waiting in the timer wheel to be reclaimed
+static std::atomic<uint64_t> g_delay_delete_num_pending(0);
+/// number of objects reclaimed so far
+static std::atomic<uint64_t> g_delay_delete_num_reclaimed(0);
+/// number of objects that couldn't be scheduled for reclamation
+static std::atomic<uint64_t> g_delay_delete_num_fails(0);
+
+/// \brief callback invoked by the timer wheel to release an object
+/// \param[in]    timer      timer wheel entry of this object
 /// \param[in]    obj_id     object identifier
 /// \param[in]    elem       element to free
-static inline void
-delay_delete_cb (uint32_t obj_id, void *elem)
+/// \remark all the objects whose delay expired in a timer wheel slice are
+///         released together in one tick of the periodic thread
+void
+delay_delete_cb (void *timer, uint32_t obj_id, void *elem)
 {
-    AGA_TRACE_VERBOSE("obj {}, elem {}", obj_id, elem);
+    AGA_TRACE_VERBOSE("Deleting object {} type {}", elem, obj_id);
     switch (obj_id) {
     case AGA_OBJ_ID_GPU:
         gpu_entry::destroy((gpu_entry *)elem);
@@ -49,23 +62,11 @@ delay_delete_cb (uint32_t obj_id, void *elem)
         AGA_TRACE_ERR("Unknown object {}", obj_id);
         SDK_ASSERT(FALSE);
     }
+    g_delay_delete_num_pending--;
+    g_delay_delete_num_reclaimed++;
     return;
 }
 
-/// \brief entry function for delay delete thread
-/// \param[in] obj_id           object identifier
-/// \param[in] elem             element to free
-/// \param[in] timeout_secs     delay in secs
-static void
-delay_delete_thread_entry (uint32_t obj_id, void *elem, uint64_t timeout_secs)
-{
-    // sleep for specific delay secs
-    sleep(timeout_secs);
-    AGA_TRACE_VERBOSE("Deleting object {} type {}", elem, obj_id);
-    // delete the object
-    delay_delete_cb(obj_id, elem);
-}
-
 /// \brief function to delete element after delay
 /// \param[in] obj_id           object identifier
 /// \param[in] elem             element to free
@@ -74,15 +75,70 @@ delay_delete_thread_entry (uint32_t obj_id, void *elem, uint64_t timeout_secs)
 sdk_ret_t
 delay_delete (uint32_t obj_id, void *elem, uint64_t timeout_secs)
 {
+    void *timer;
+
     if (obj_id >= AGA_OBJ_ID_MAX) {
         AGA_TRACE_ERR("Unexpected object {}", obj_id);
         return SDK_RET_INVALID_ARG;
     }
     AGA_TRACE_VERBOSE("Scheduling object {} type {} for delay delete, "
                       "after {} seconds", elem, obj_id, timeout_secs);
-    // start a thread to handle delay delete
-    std::thread(delay_delete_thread_entry, obj_id, elem, timeout_secs).detach();
+    // count the object as pending before the periodic thread can reclaim it
+    g_delay_delete_num_pending++;
+    // park the object in the periodic thread's timer wheel
+    timer = sdk::lib::timer_schedule(obj_id,
+                                     timeout_secs * TIME_MSECS_PER_SEC, elem,
+                                     delay_delete_cb, false);
+    if (unlikely(timer == NULL)) {
+        g_delay_delete_num_pending--;
+        g_delay_delete_num_fails++;
+        AGA_TRACE_ERR("Failed to schedule object {} type {} for delay delete",
+                      elem, obj_id);
+        return SDK_RET_OOM;
+    }
+    return SDK_RET_OK;
+}
+
+/// \brief callback invoked by the timer wheel to release a superseded rcu db
+///        version
+/// \param[in]    timer      timer wheel entry of this version
+/// \param[in]    timer_id   unused
+/// \param[in]    elem       version to free
+static void
+delay_delete_rcu_db_version_cb_ (void *timer, uint32_t timer_id, void *elem)
+{
+    AGA_TRACE_VERBOSE("Deleting rcu db version {}", elem);
+    delete (rcu_db_version *)elem;
+    g_delay_delete_num_pending--;
+    g_delay_delete_num_reclaimed++;
+}
+
+sdk_ret_t
+delay_delete (rcu_db_version *version, uint64_t timeout_secs)
+{
+    void *timer;
+
+    g_delay_delete_num_pending++;
+    timer = sdk::lib::timer_schedule(AGA_OBJ_ID_NONE,
+                                     timeout_secs * TIME_MSECS_PER_SEC,
+                                     version, delay_delete_rcu_db_version_cb_,
+                                     false);
+    if (unlikely(timer == NULL)) {
+        g_delay_delete_num_pending--;
+        g_delay_delete_num_fails++;
+        AGA_TRACE_ERR("Failed to schedule rcu db version {} for delay delete",
+                      (void *)version);
+        return SDK_RET_OOM;
+    }
     return SDK_RET_OK;
 }
 
+void
+delay_delete_stats_get (delay_delete_stats_t *stats)
+{
+    stats->num_pending = g_delay_delete_num_pending;
+    stats->num_reclaimed = g_delay_delete_num_reclaimed;
+    stats->num_fails = g_delay_delete_num_fails;
+}
+
 }    // namespace aga
@@ -42,6 +42,9 @@ namespace aga {
 /// \return #SDK_RET_OK on success, failure status code on error
 ///
 /// \remark
+///   - elements are parked in the timer wheel of the periodic thread and are
+///     released in batches as the wheel ticks, so the actual delay is rounded
+///     up to the wheel's slice interval
 ///   - currently delay delete timeout is AGA_DELAY_DELETE_MSECS, it is
 ///     expected that other thread(s) using (a pointer to) this object should
 ///     be done using this object within this timeout or else this memory can
@@ -50,6 +53,32 @@ namespace aga {
 sdk_ret_t delay_delete(uint32_t obj_id, void *elem,
                        uint64_t timeout_secs = AGA_DELAY_DELETE_SECS);
 
+class rcu_db_version;
+
+/// \brief     delay delete a superseded version of an rcu db, readers that
+///            loaded the version before it was superseded may still be
+///            using it
+/// \param[in] version         superseded version
+/// \param[in] timeout_secs    optional timeout in seconds to delay delete the
+///                            version
+/// \return #SDK_RET_OK on success, failure status code on error
+sdk_ret_t delay_delete(rcu_db_version *version,
+                       uint64_t timeout_secs = AGA_DELAY_DELETE_SECS);
+
+/// \brief delay delete statistics
+typedef struct delay_delete_stats_s {
+    /// number of objects waiting to be reclaimed
+    uint64_t num_pending;
+    /// number of objects reclaimed so far
+    uint64_t num_reclaimed;
+    /// number of objects that failed to be scheduled for reclamation
+    uint64_t num_fails;
+} delay_delete_stats_t;
+
+/// \brief return the delay delete statistics
+/// \param[out] stats    delay delete statistics
+void delay_delete_stats_get(delay_delete_stats_t *stats);
+
 }    // namespace aga
 
 #endif    // __AGA_CORE_MEM_HPP__
@@ -120,4 +120,10 @@ event_get (void)
     return &event_ntfn_data;
 }
 
+size_t
+event_size_get (void)
+{
+    return sizeof(amdsmi_evt_notification_data_t);
+}
+
 }    // namespace aga
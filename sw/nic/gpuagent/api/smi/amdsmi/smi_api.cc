@@ -28,6 +28,7 @@ limitations under the License.
 #include "nic/gpuagent/api/smi/smi_api.hpp"
 #include "nic/gpuagent/api/smi/smi_state.hpp"
 #include "nic/gpuagent/api/smi/amdsmi/smi_utils.hpp"
+#include "nic/gpuagent/api/smi/amdsmi/smi_cache.hpp"
 
 // TODO:
 // not using aga_ here for proper naming !!!
@@ -40,6 +41,7 @@ namespace aga {
 typedef struct gpu_topo_walk_ctxt_s {
     uint32_t count;
     gpu_entry *gpu;
+    const gpu_topo_matrix_t *matrix;
     aga_device_topology_info_t *info;
 } gpu_topo_walk_ctxt_t;
 
@@ -416,74 +418,110 @@ gpu_get_sku_from_vbios_ (char *sku, char *vbios)
 
 /// \brief    fill list of pids using the given GPU
 /// \param[in] gpu_handle    GPU handle
+/// \param[in] gpu_id        GPU id
 /// \param[out] status    operational status to be filled
 /// \return SDK_RET_OK or error code in case of failure
 static sdk_ret_t
 smi_fill_gpu_kfd_pid_status_ (aga_gpu_handle_t gpu_handle,
                               uint32_t gpu_id, aga_gpu_status_t *status)
 {
+    uint32_t num_pid;
     amdsmi_status_t amdsmi_ret;
-    uint32_t gpu_list[AGA_MAX_GPU];
-    amdsmi_process_info_t *pid_info;
-    uint32_t value_32, num_pid = 0, num_gpus = AGA_MAX_GPU;
+    smi_kfd_pid_index_ptr_t index;
 
-    // kernel fusion driver pids
-    amdsmi_ret = amdsmi_get_gpu_compute_process_info(NULL, &value_32);
+    // processes of all the GPUs are looked up once per cache interval
+    amdsmi_ret = g_smi_cache.kfd_pid_index(&index);
     if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
-        AGA_TRACE_ERR("Failed to get KFD pid count, err {}", amdsmi_ret);
+        AGA_TRACE_ERR("Failed to get KFD pid info, err {}", amdsmi_ret);
         return amdsmi_ret_to_sdk_ret(amdsmi_ret);
-    } else {
-        // if pid count is non zero, get the pid info
-        if (value_32) {
-            pid_info =
-                (amdsmi_process_info_t *)malloc(sizeof(amdsmi_process_info_t) *
-                                                value_32);
-            if (pid_info == NULL) {
-                AGA_TRACE_ERR("Failed to allocate KFD pid buffer, GPU {}");
-                return SDK_RET_OOM;
-            }
-            amdsmi_ret = amdsmi_get_gpu_compute_process_info(pid_info,
-                                                             &value_32);
-            if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
-                free(pid_info);
-                AGA_TRACE_ERR("Failed to get KFD pid info, err {}", amdsmi_ret);
-                return amdsmi_ret_to_sdk_ret(amdsmi_ret);
-            }
-            // loop thru pids, get the list of GPUs using each pid and
-            // update per GPU kfd process list
-            for (uint32_t i = 0; i < value_32; i++) {
-                num_gpus = AGA_MAX_GPU;
-                amdsmi_ret =
-                    amdsmi_get_gpu_compute_process_gpus(pid_info[i].process_id,
-                                                        gpu_list, &num_gpus);
-                if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
-                    AGA_TRACE_ERR("Failed to get GPU list of pid {}, err {}",
-                                  pid_info[i].process_id, amdsmi_ret);
-                    continue;
-                }
-                for (uint32_t j = 0; j < num_gpus; j++) {
-                    if (gpu_list[j] == gpu_id) {
-                        if (num_pid == (AGA_GPU_MAX_KFD_PID - 1)) {
-                            AGA_TRACE_DEBUG("Reached max KFD processes {} "
-                                            "using the GPU {}, pid {} is "
-                                            "ignored", AGA_GPU_MAX_KFD_PID,
-                                            gpu_handle, pid_info[i].process_id);
-                            break;
-                        }
-                        status->kfd_process_id[num_pid++] =
-                            pid_info[i].process_id;
-                        break;
-                    }
-                }
-            }
-            status->num_kfd_process_id = num_pid;
-            // free pid_info memory
-            free(pid_info);
-        }
     }
+    const std::vector<uint32_t>& pids = index->pids[gpu_id];
+    num_pid = pids.size();
+    if (unlikely(num_pid > AGA_GPU_MAX_KFD_PID)) {
+        AGA_TRACE_DEBUG("Reached max KFD processes {} using the GPU {}, "
+                        "{} pids are ignored", AGA_GPU_MAX_KFD_PID,
+                        gpu_handle, num_pid - AGA_GPU_MAX_KFD_PID);
+        num_pid = AGA_GPU_MAX_KFD_PID;
+    }
+    memcpy(status->kfd_process_id, pids.data(), num_pid * sizeof(uint32_t));
+    status->num_kfd_process_id = num_pid;
     return SDK_RET_OK;
 }
 
+/// \brief    fill the clock status available from GPU metrics
+/// \param[out] status          operational status to be filled
+/// \param[in]  metrics_info    GPU metrics
+/// \return none
+static void
+smi_fill_clock_metrics_status_ (aga_gpu_status_t *status,
+                                amdsmi_gpu_metrics_t *metrics_info)
+{
+    uint32_t clk_cnt = 0;
+    aga_gpu_clock_status_t *clock_status;
+
+    // gfx clocks
+    for (uint32_t i = 0; i < AMDSMI_MAX_NUM_GFX_CLKS; i++) {
+        clock_status = &status->clock_status[clk_cnt];
+        clock_status->clock_type = AGA_GPU_CLOCK_TYPE_SYSTEM;
+        clock_status->frequency = metrics_info->current_gfxclks[i];
+        clock_status->locked =
+            metrics_info->gfxclk_lock_status & (1 << i);
+        clock_status->deep_sleep =
+            (clock_status->frequency < AMDSMI_DEEP_SLEEP_THRESHOLD);
+        clk_cnt++;
+    }
+    // memory clock
+    clock_status = &status->clock_status[clk_cnt];
+    clock_status->clock_type = AGA_GPU_CLOCK_TYPE_MEMORY;
+    clock_status->frequency = metrics_info->current_uclk;
+    // locked is N/A for memory clock
+    clock_status->deep_sleep =
+        (clock_status->frequency < AMDSMI_DEEP_SLEEP_THRESHOLD);
+    clk_cnt++;
+    // video clocks
+    for (uint32_t i = 0; i < AMDSMI_MAX_NUM_CLKS; i++) {
+        clock_status = &status->clock_status[clk_cnt];
+        clock_status->clock_type = AGA_GPU_CLOCK_TYPE_VIDEO;
+        clock_status->frequency = metrics_info->current_vclk0s[i];
+        // locked is N/A for video clocks
+        clock_status->deep_sleep =
+            (clock_status->frequency < AMDSMI_DEEP_SLEEP_THRESHOLD);
+        clk_cnt++;
+    }
+    // data clocks
+    for (uint32_t i = 0; i < AMDSMI_MAX_NUM_CLKS; i++) {
+        clock_status = &status->clock_status[clk_cnt];
+        clock_status->clock_type = AGA_GPU_CLOCK_TYPE_DATA;
+        clock_status->frequency = metrics_info->current_dclk0s[i];
+        // locked is N/A for data clocks
+        clock_status->deep_sleep =
+            (clock_status->frequency < AMDSMI_DEEP_SLEEP_THRESHOLD);
+        clk_cnt++;
+    }
+}
+
+/// \brief    fill the operational status derived from GPU metrics
+/// \param[out] status          operational status to be filled
+/// \param[in]  metrics_info    GPU metrics
+/// \return none
+static void
+smi_fill_metrics_status_ (aga_gpu_status_t *status,
+                          amdsmi_gpu_metrics_t *metrics_info)
+{
+    // fill the clock status with metrics info
+    smi_fill_clock_metrics_status_(status, metrics_info);
+    // fill firmware timestamp
+    status->fw_timestamp = metrics_info->firmware_timestamp;
+    if (metrics_info->throttle_status !=
+        std::numeric_limits<uint32_t>::max()) {
+        status->throttling_status =
+            metrics_info->throttle_status ? AGA_GPU_THROTTLING_STATUS_ON :
+                                            AGA_GPU_THROTTLING_STATUS_OFF;
+    }
+    status->xgmi_status.width = metrics_info->xgmi_link_width;
+    status->xgmi_status.speed = metrics_info->xgmi_link_speed;
+}
+
 /// \brief    fill status of clocks
 /// \param[in] gpu_handle    GPU handle
 /// \param[out] status    operational status to be filled
@@ -500,45 +538,7 @@ smi_fill_clock_status_ (aga_gpu_handle_t gpu_handle,
 
     // fill up information available from metrics info
     if (metrics_info) {
-        // gfx clocks
-        for (uint32_t i = 0; i < AMDSMI_MAX_NUM_GFX_CLKS; i++) {
-            clock_status = &status->clock_status[clk_cnt];
-            clock_status->clock_type = AGA_GPU_CLOCK_TYPE_SYSTEM;
-            clock_status->frequency = metrics_info->current_gfxclks[i];
-            clock_status->locked =
-                metrics_info->gfxclk_lock_status & (1 << i);
-            clock_status->deep_sleep =
-                (clock_status->frequency < AMDSMI_DEEP_SLEEP_THRESHOLD);
-            clk_cnt++;
-        }
-        // memory clock
-        clock_status = &status->clock_status[clk_cnt];
-        clock_status->clock_type = AGA_GPU_CLOCK_TYPE_MEMORY;
-        clock_status->frequency = metrics_info->current_uclk;
-        // locked is N/A for memory clock
-        clock_status->deep_sleep =
-            (clock_status->frequency < AMDSMI_DEEP_SLEEP_THRESHOLD);
-        clk_cnt++;
-        // video clocks
-        for (uint32_t i = 0; i < AMDSMI_MAX_NUM_CLKS; i++) {
-            clock_status = &status->clock_status[clk_cnt];
-            clock_status->clock_type = AGA_GPU_CLOCK_TYPE_VIDEO;
-            clock_status->frequency = metrics_info->current_vclk0s[i];
-            // locked is N/A for video clocks
-            clock_status->deep_sleep =
-                (clock_status->frequency < AMDSMI_DEEP_SLEEP_THRESHOLD);
-            clk_cnt++;
-        }
-        // data clocks
-        for (uint32_t i = 0; i < AMDSMI_MAX_NUM_CLKS; i++) {
-            clock_status = &status->clock_status[clk_cnt];
-            clock_status->clock_type = AGA_GPU_CLOCK_TYPE_DATA;
-            clock_status->frequency = metrics_info->current_dclk0s[i];
-            // locked is N/A for data clocks
-            clock_status->deep_sleep =
-                (clock_status->frequency < AMDSMI_DEEP_SLEEP_THRESHOLD);
-            clk_cnt++;
-        }
+        smi_fill_clock_metrics_status_(status, metrics_info);
     }
     // get additional clock status information from amdsmi_get_clock_info
     clk_cnt = 0;
@@ -670,14 +670,14 @@ smi_fill_clock_status_ (aga_gpu_handle_t gpu_handle,
 /// \return SDK_RET_OK or error code in case of failure
 static sdk_ret_t
 smi_fill_pcie_status_ (aga_gpu_handle_t gpu_handle,
-                       aga_gpu_status_t *status)
+                       aga_gpu_status_t *status, bool refresh)
 {
     uint64_t value_64;
     amdsmi_pcie_info_t info;
     amdsmi_status_t amdsmi_ret;
     aga_gpu_pcie_status_t *pcie_status = &status->pcie_status;
 
-    amdsmi_ret = amdsmi_get_pcie_info(gpu_handle, &info);
+    amdsmi_ret = g_smi_cache.pcie_info(gpu_handle, &info, refresh);
     if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
         AGA_TRACE_ERR("Failed to get PCIe info for GPU {}, err {}",
                       gpu_handle, amdsmi_ret);
@@ -817,28 +817,19 @@ smi_gpu_fill_status (aga_gpu_handle_t gpu_handle, uint32_t gpu_id,
         AGA_TRACE_ERR("Failed to get memory vendor for GPU {}, err {}",
                       gpu_handle, amdsmi_ret);
     }
-    amdsmi_ret = amdsmi_get_gpu_metrics_info(gpu_handle, &metrics_info);
+    amdsmi_ret = g_smi_cache.gpu_metrics(gpu_handle, &metrics_info, true);
     if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
         AGA_TRACE_ERR("Failed to get GPU metrics info for GPU {}, err {}",
                       gpu_handle, amdsmi_ret);
         // fill the clock status without metrics info
         smi_fill_clock_status_(gpu_handle, status, NULL);
     } else {
-        // fill the clock status with metrics info
+        // fill the clock status, firmware timestamp etc. with metrics info
         smi_fill_clock_status_(gpu_handle, status, &metrics_info);
-        // fill firmware timestamp
-        status->fw_timestamp = metrics_info.firmware_timestamp;
-        if (metrics_info.throttle_status !=
-            std::numeric_limits<uint32_t>::max()) {
-            status->throttling_status =
-                metrics_info.throttle_status ? AGA_GPU_THROTTLING_STATUS_ON :
-                                               AGA_GPU_THROTTLING_STATUS_OFF;
-        }
-        status->xgmi_status.width = metrics_info.xgmi_link_width;
-        status->xgmi_status.speed = metrics_info.xgmi_link_speed;
+        smi_fill_metrics_status_(status, &metrics_info);
     }
     // fill the PCIe status
-    smi_fill_pcie_status_(gpu_handle, status);
+    smi_fill_pcie_status_(gpu_handle, status, true);
     // fill VRAM status
     smi_fill_vram_status_(gpu_handle, &status->vram_status);
     // fill the xgmi error count
@@ -873,6 +864,47 @@ smi_gpu_fill_status (aga_gpu_handle_t gpu_handle, uint32_t gpu_id,
     return SDK_RET_OK;
 }
 
+sdk_ret_t
+smi_gpu_fill_dynamic_status (aga_gpu_handle_t gpu_handle, uint32_t gpu_id,
+                             aga_gpu_status_t *status)
+{
+    amdsmi_status_t amdsmi_ret;
+    amdsmi_xgmi_status_t xgmi_st;
+    amdsmi_pcie_info_t pcie_info = {};
+    amdsmi_gpu_metrics_t metrics_info = {};
+
+    amdsmi_ret = g_smi_cache.gpu_metrics(gpu_handle, &metrics_info);
+    if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
+        AGA_TRACE_ERR("Failed to get GPU metrics info for GPU {}, err {}",
+                      gpu_handle, amdsmi_ret);
+    } else {
+        smi_fill_metrics_status_(status, &metrics_info);
+    }
+    // current PCIe link state
+    amdsmi_ret = g_smi_cache.pcie_info(gpu_handle, &pcie_info);
+    if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
+        AGA_TRACE_ERR("Failed to get PCIe info for GPU {}, err {}",
+                      gpu_handle, amdsmi_ret);
+    } else {
+        status->pcie_status.width = pcie_info.pcie_metric.pcie_width;
+        status->pcie_status.speed = pcie_info.pcie_metric.pcie_speed/1000;
+        status->pcie_status.bandwidth = pcie_info.pcie_metric.pcie_bandwidth;
+    }
+    // fill the xgmi error count
+    amdsmi_ret = amdsmi_gpu_xgmi_error_status(gpu_handle, &xgmi_st);
+    if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
+        AGA_TRACE_ERR("Failed to get xgmi error status for GPU {}, err {}",
+                      gpu_handle, amdsmi_ret);
+    } else {
+        status->xgmi_status.error_status = smi_to_aga_gpu_xgmi_error(xgmi_st);
+    }
+    // processes come and go, so the pid list is refreshed along with the
+    // other runtime data
+    status->num_kfd_process_id = 0;
+    smi_fill_gpu_kfd_pid_status_(gpu_handle, gpu_id, status);
+    return SDK_RET_OK;
+}
+
 /// \brief function to get number of bad pages for GPU
 /// \param[in]  gpu             GPU object
 /// \param[out] num_bad_pages   number of bad pages
@@ -1009,14 +1041,13 @@ smi_fill_vram_usage_ (aga_gpu_handle_t gpu_handle,
 sdk_ret_t
 smi_gpu_fill_stats (aga_gpu_handle_t gpu_handle,
                     aga_gpu_handle_t first_partition_handle,
-                    aga_gpu_stats_t *stats)
+                    aga_gpu_stats_t *stats, bool live)
 {
     sdk_ret_t ret;
     int64_t temperature;
     uint32_t partition_id;
-    uint64_t power, value_64;
-    float counter_resolution;
     amdsmi_status_t amdsmi_ret;
+    smi_energy_count_t energy = {};
     amdsmi_pcie_info_t pcie_info = {};
     amdsmi_power_info_t power_info = {};
     amdsmi_engine_usage_t usage_info = {};
@@ -1029,7 +1060,7 @@ smi_gpu_fill_stats (aga_gpu_handle_t gpu_handle,
     }
 
     // fill the power and voltage info
-    amdsmi_ret = amdsmi_get_power_info(gpu_handle, &power_info);
+    amdsmi_ret = g_smi_cache.power_info(gpu_handle, &power_info, live);
     if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
         AGA_TRACE_ERR("Failed to get power information for GPU {}, err {}",
                       gpu_handle, amdsmi_ret);
@@ -1041,7 +1072,7 @@ smi_gpu_fill_stats (aga_gpu_handle_t gpu_handle,
         stats->voltage.memory_voltage = power_info.mem_voltage;
     }
     // fill the GPU usage
-    amdsmi_ret = amdsmi_get_gpu_activity(gpu_handle, &usage_info);
+    amdsmi_ret = g_smi_cache.gpu_activity(gpu_handle, &usage_info, live);
     if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
         AGA_TRACE_ERR("Failed to get GPU activity for GPU {}, err {}",
                       gpu_handle, amdsmi_ret);
@@ -1050,8 +1081,8 @@ smi_gpu_fill_stats (aga_gpu_handle_t gpu_handle,
         stats->usage.mm_activity = usage_info.mm_activity;
     }
     // get gfx, vcn and jpeg usage from first gpu partition
-    amdsmi_ret = amdsmi_get_gpu_metrics_info(first_partition_handle,
-                                             &metrics_info);
+    amdsmi_ret = g_smi_cache.gpu_metrics(first_partition_handle,
+                                         &metrics_info, live);
     if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
         AGA_TRACE_ERR("Failed to get GPU metrics info for GPU {}, err {}",
                       first_partition_handle, amdsmi_ret);
@@ -1072,7 +1103,7 @@ smi_gpu_fill_stats (aga_gpu_handle_t gpu_handle,
     // fill VRAM usage
     smi_fill_vram_usage_(gpu_handle, &stats->vram_usage);
     // fill additional statistics from gpu metrics
-    amdsmi_ret = amdsmi_get_gpu_metrics_info(gpu_handle, &metrics_info);
+    amdsmi_ret = g_smi_cache.gpu_metrics(gpu_handle, &metrics_info, live);
     if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
         AGA_TRACE_ERR("Failed to get GPU metrics info for GPU {}, err {}",
                       gpu_handle, amdsmi_ret);
@@ -1102,7 +1133,7 @@ smi_gpu_fill_stats (aga_gpu_handle_t gpu_handle,
 
     }
     // fill the PCIe stats
-    amdsmi_ret = amdsmi_get_pcie_info(gpu_handle, &pcie_info);
+    amdsmi_ret = g_smi_cache.pcie_info(gpu_handle, &pcie_info, live);
     if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
         AGA_TRACE_ERR("Failed to get PCIe info for GPU {}, err {}",
                       gpu_handle, amdsmi_ret);
@@ -1119,18 +1150,18 @@ smi_gpu_fill_stats (aga_gpu_handle_t gpu_handle,
             pcie_info.pcie_metric.pcie_nak_received_count;
     }
     // fill the energy consumed
-    amdsmi_ret = amdsmi_get_energy_count(gpu_handle, &power,
-                                         &counter_resolution, &value_64);
+    amdsmi_ret = g_smi_cache.energy_count(gpu_handle, &energy, live);
     if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
         AGA_TRACE_ERR("Failed to get energy consumed for GPU {}, err {}",
                       gpu_handle, amdsmi_ret);
     } else {
-        stats->energy_consumed = power * counter_resolution;
+        stats->energy_consumed = energy.energy * energy.resolution;
     }
     // fill the edge temperature
-    amdsmi_ret = amdsmi_get_temp_metric(gpu_handle,
-                                        AMDSMI_TEMPERATURE_TYPE_EDGE,
-                                        AMDSMI_TEMP_CURRENT, &temperature);
+    amdsmi_ret = g_smi_cache.temp_metric(gpu_handle,
+                                         AMDSMI_TEMPERATURE_TYPE_EDGE,
+                                         AMDSMI_TEMP_CURRENT, &temperature,
+                                         live);
     if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
         AGA_TRACE_ERR("Failed to get edge temperature for GPU {}, err {}",
                       gpu_handle, amdsmi_ret);
@@ -1138,9 +1169,10 @@ smi_gpu_fill_stats (aga_gpu_handle_t gpu_handle,
         stats->temperature.edge_temperature = (float)temperature;
     }
     // fill the junction temperature
-    amdsmi_ret = amdsmi_get_temp_metric(gpu_handle,
-                                        AMDSMI_TEMPERATURE_TYPE_JUNCTION,
-                                        AMDSMI_TEMP_CURRENT, &temperature);
+    amdsmi_ret = g_smi_cache.temp_metric(gpu_handle,
+                                         AMDSMI_TEMPERATURE_TYPE_JUNCTION,
+                                         AMDSMI_TEMP_CURRENT, &temperature,
+                                         live);
     if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
         AGA_TRACE_ERR("Failed to get junction temperature for GPU {}, err {}",
                       gpu_handle, amdsmi_ret);
@@ -1148,9 +1180,10 @@ smi_gpu_fill_stats (aga_gpu_handle_t gpu_handle,
         stats->temperature.junction_temperature = (float)temperature;
     }
     // fill the memory temperature
-    amdsmi_ret = amdsmi_get_temp_metric(gpu_handle,
-                                        AMDSMI_TEMPERATURE_TYPE_VRAM,
-                                        AMDSMI_TEMP_CURRENT, &temperature);
+    amdsmi_ret = g_smi_cache.temp_metric(gpu_handle,
+                                         AMDSMI_TEMPERATURE_TYPE_VRAM,
+                                         AMDSMI_TEMP_CURRENT, &temperature,
+                                         live);
     if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
         AGA_TRACE_ERR("Failed to get VRAM temperature for GPU {}, err {}",
                       gpu_handle, amdsmi_ret);
@@ -1158,9 +1191,10 @@ smi_gpu_fill_stats (aga_gpu_handle_t gpu_handle,
         stats->temperature.memory_temperature = (float)temperature;
     }
     // fill the HBM0 temperature
-    amdsmi_ret = amdsmi_get_temp_metric(gpu_handle,
-                                        AMDSMI_TEMPERATURE_TYPE_HBM_0,
-                                        AMDSMI_TEMP_CURRENT, &temperature);
+    amdsmi_ret = g_smi_cache.temp_metric(gpu_handle,
+                                         AMDSMI_TEMPERATURE_TYPE_HBM_0,
+                                         AMDSMI_TEMP_CURRENT, &temperature,
+                                         live);
     if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
         AGA_TRACE_ERR("Failed to get HBM0 temperature for GPU {}, err {}",
                       gpu_handle, amdsmi_ret);
@@ -1168,9 +1202,10 @@ smi_gpu_fill_stats (aga_gpu_handle_t gpu_handle,
         stats->temperature.hbm_temperature[0] = (float)temperature;
     }
     // fill the HBM1 temperature
-    amdsmi_ret = amdsmi_get_temp_metric(gpu_handle,
-                                        AMDSMI_TEMPERATURE_TYPE_HBM_1,
-                                        AMDSMI_TEMP_CURRENT, &temperature);
+    amdsmi_ret = g_smi_cache.temp_metric(gpu_handle,
+                                         AMDSMI_TEMPERATURE_TYPE_HBM_1,
+                                         AMDSMI_TEMP_CURRENT, &temperature,
+                                         live);
     if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
         AGA_TRACE_ERR("Failed to get HBM1 temperature for GPU {}, err {}",
                       gpu_handle, amdsmi_ret);
@@ -1178,9 +1213,10 @@ smi_gpu_fill_stats (aga_gpu_handle_t gpu_handle,
         stats->temperature.hbm_temperature[1] = (float)temperature;
     }
     // fill the HBM2 temperature
-    amdsmi_ret = amdsmi_get_temp_metric(gpu_handle,
-                                        AMDSMI_TEMPERATURE_TYPE_HBM_2,
-                                        AMDSMI_TEMP_CURRENT, &temperature);
+    amdsmi_ret = g_smi_cache.temp_metric(gpu_handle,
+                                         AMDSMI_TEMPERATURE_TYPE_HBM_2,
+                                         AMDSMI_TEMP_CURRENT, &temperature,
+                                         live);
     if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
         AGA_TRACE_ERR("Failed to get HBM2 temperature for GPU {}, err {}",
                       gpu_handle, amdsmi_ret);
@@ -1188,9 +1224,10 @@ smi_gpu_fill_stats (aga_gpu_handle_t gpu_handle,
         stats->temperature.hbm_temperature[2] = (float)temperature;
     }
     // fill the HBM3 temperature
-    amdsmi_ret = amdsmi_get_temp_metric(gpu_handle,
-                                        AMDSMI_TEMPERATURE_TYPE_HBM_3,
-                                        AMDSMI_TEMP_CURRENT, &temperature);
+    amdsmi_ret = g_smi_cache.temp_metric(gpu_handle,
+                                         AMDSMI_TEMPERATURE_TYPE_HBM_3,
+                                         AMDSMI_TEMP_CURRENT, &temperature,
+                                         live);
     if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
         AGA_TRACE_ERR("Failed to get HBM3 temperature for GPU {}, err {}",
                       gpu_handle, amdsmi_ret);
@@ -1201,9 +1238,18 @@ smi_gpu_fill_stats (aga_gpu_handle_t gpu_handle,
 }
 
 sdk_ret_t
-smi_event_read_all (aga_event_read_cb_t cb, void *ctxt)
+smi_gpu_watch_fields_read (uint32_t gpu_id,
+                           const aga_gpu_watch_attr_set_t& attrs,
+                           aga_gpu_watch_fields_t *fields)
+{
+    return g_smi_state.gpu_watch_fields_read(gpu_id, attrs, fields);
+}
+
+sdk_ret_t
+smi_event_read_all (aga_event_read_cb_t cb, void *ctxt,
+                    const aga_event_query_t *query)
 {
-    return g_smi_state.event_read(cb, ctxt);
+    return g_smi_state.event_read(cb, ctxt, query);
 }
 
 sdk_ret_t
@@ -1379,6 +1425,9 @@ smi_gpu_update (aga_gpu_handle_t gpu_handle, aga_gpu_spec_t *spec,
             AGA_TRACE_ERR("Failed to set GPU compute partition type to {}, "
                           "GPU {}, err {}", spec->compute_partition_type,
                           gpu_handle, amdsmi_ret);
+        } else {
+            // links between the GPUs may change with the partitions
+            g_smi_state.topo_invalidate();
         }
         return (amdsmi_ret_to_sdk_ret(amdsmi_ret));
     }
@@ -1393,6 +1442,9 @@ smi_gpu_update (aga_gpu_handle_t gpu_handle, aga_gpu_spec_t *spec,
             AGA_TRACE_ERR("Failed to set GPU memory partition type to {}, "
                           "GPU {}, err {}", spec->memory_partition_type,
                           gpu_handle, amdsmi_ret);
+        } else {
+            // links between the GPUs may change with the partitions
+            g_smi_state.topo_invalidate();
         }
         return (amdsmi_ret_to_sdk_ret(amdsmi_ret));
     }
@@ -1489,10 +1541,10 @@ static inline bool
 gpu_topo_walk_cb (void *obj, void *ctxt)
 {
     gpu_entry *gpu1, *gpu2;
-    amdsmi_status_t amdsmi_ret;
     static std::string name = "GPU";
     gpu_topo_walk_ctxt_t *walk_ctxt;
     aga_device_topology_info_t *info;
+    const gpu_topo_link_t *link;
 
     gpu2 = (gpu_entry *)obj;
     walk_ctxt = (gpu_topo_walk_ctxt_t *)ctxt;
@@ -1500,55 +1552,50 @@ gpu_topo_walk_cb (void *obj, void *ctxt)
     info = walk_ctxt->info;
 
     if (gpu1->handle() != gpu2->handle()) {
+        link = &walk_ctxt->matrix->link[gpu1->id()][gpu2->id()];
         info->peer_device[walk_ctxt->count].peer_device.type =
             AGA_DEVICE_TYPE_GPU;
         strcpy(info->peer_device[walk_ctxt->count].peer_device.name,
                (name + std::to_string(gpu1->id())).c_str());
-        amdsmi_ret =
-            amdsmi_topo_get_link_type(gpu1->handle(), gpu2->handle(),
-                &info->peer_device[walk_ctxt->count].num_hops,
-                (amdsmi_io_link_type_t *)
-                     &info->peer_device[walk_ctxt->count].connection.type);
-        if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
-            AGA_TRACE_ERR("Failed to get link type between gpus {} and {}, "
-                          "err {}", gpu1->handle(), gpu2->handle(), amdsmi_ret);
-            // in case of error set num hops to 0xffff and IO link type to
-            // none
-            info->peer_device[walk_ctxt->count].num_hops = 0xffff;
-            info->peer_device[walk_ctxt->count].connection.type =
-                AGA_IO_LINK_TYPE_NONE;
-        }
-        amdsmi_ret = amdsmi_topo_get_link_weight(gpu1->handle(), gpu2->handle(),
-                         &info->peer_device[walk_ctxt->count].link_weight);
-        if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
-            AGA_TRACE_ERR("Failed to get weight for link between gpus {}"
-                          "and {}, err {}", gpu1->handle(), gpu2->handle(),
-                          amdsmi_ret);
-            // in case of error set link weight to 0xffff
-            info->peer_device[walk_ctxt->count].link_weight = 0xffff;
-        }
+        info->peer_device[walk_ctxt->count].num_hops = link->num_hops;
+        info->peer_device[walk_ctxt->count].connection.type = link->type;
+        info->peer_device[walk_ctxt->count].link_weight = link->weight;
         info->peer_device[walk_ctxt->count].valid = true;
         walk_ctxt->count++;
     }
     return false;
 }
 
+sdk_ret_t
+smi_gpu_topology_init (void)
+{
+    return g_smi_state.topo_build();
+}
+
 sdk_ret_t
 smi_gpu_fill_device_topology (aga_gpu_handle_t gpu_handle,
                               aga_device_topology_info_t *info)
 {
     gpu_entry *gpu;
     gpu_topo_walk_ctxt_t ctxt;
+    gpu_topo_matrix_ptr_t matrix;
 
     gpu = gpu_db()->find(gpu_handle);
     if (gpu == NULL) {
         AGA_TRACE_ERR("Failed to find GPU {}", gpu_handle);
         return SDK_RET_ENTRY_NOT_FOUND;
     }
+    // links between the GPUs are read from amdsmi only when the cached
+    // topology is (re)built
+    matrix = g_smi_state.topo();
+    if (unlikely(matrix == NULL)) {
+        return SDK_RET_ERR;
+    }
 
     ctxt.count = 0;
     ctxt.info = info;
     ctxt.gpu = gpu;
+    ctxt.matrix = matrix.get();
 
     // walk gpu db and fill device topology
     gpu_db()->walk_handle_db(gpu_topo_walk_cb, &ctxt);
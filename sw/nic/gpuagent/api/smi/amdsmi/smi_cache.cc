@@ -0,0 +1,203 @@
+
+/*
+Copyright (c) Advanced Micro Devices, Inc. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+//----------------------------------------------------------------------------
+///
+/// \file
+/// amdsmi read cache implementation
+///
+//----------------------------------------------------------------------------
+
+#include "nic/sdk/include/sdk/timestamp.hpp"
+#include "nic/gpuagent/api/smi/amdsmi/smi_cache.hpp"
+
+namespace aga {
+
+/// global singleton amdsmi read cache instance
+smi_cache g_smi_cache;
+
+/// \brief    return current time on monotonic clock
+/// \return   current time (in milliseconds)
+static inline uint64_t
+smi_cache_now_ (void)
+{
+    uint64_t now;
+    timespec_t ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    sdk::timestamp_to_nsecs(&ts, &now);
+    return now / TIME_NSECS_PER_MSEC;
+}
+
+smi_cache::~smi_cache() {
+    for (auto it = entries_.begin(); it != entries_.end(); it++) {
+        delete it->second;
+    }
+}
+
+smi_cache::entry_t *
+smi_cache::entry_(amdsmi_processor_handle handle) {
+    entry_t *entry;
+    std::lock_guard<std::mutex> lock(entries_lock_);
+
+    auto it = entries_.find(handle);
+    if (likely(it != entries_.end())) {
+        return it->second;
+    }
+    entry = new entry_t();
+    entries_[handle] = entry;
+    return entry;
+}
+
+template <typename T, typename F>
+amdsmi_status_t
+smi_cache::read_(slot_t<T>& slot, T *data, bool refresh, F read) {
+    uint64_t now;
+    std::lock_guard<std::mutex> lock(slot.lock);
+
+    // readers that waited for the lock while another one refreshed the
+    // slot find it fresh and don't go to the driver again
+    now = smi_cache_now_();
+    if (refresh || (slot.ts == 0) || ((now - slot.ts) >= ttl_)) {
+        slot.status = read(&slot.data);
+        slot.ts = now;
+    }
+    if (slot.status == AMDSMI_STATUS_SUCCESS) {
+        *data = slot.data;
+    }
+    return slot.status;
+}
+
+amdsmi_status_t
+smi_cache::gpu_metrics(amdsmi_processor_handle handle,
+                       amdsmi_gpu_metrics_t *metrics, bool refresh) {
+    return read_(entry_(handle)->gpu_metrics, metrics, refresh,
+                 [handle] (amdsmi_gpu_metrics_t *data) {
+                     return amdsmi_get_gpu_metrics_info(handle, data);
+                 });
+}
+
+amdsmi_status_t
+smi_cache::pcie_info(amdsmi_processor_handle handle,
+                     amdsmi_pcie_info_t *info, bool refresh) {
+    return read_(entry_(handle)->pcie_info, info, refresh,
+                 [handle] (amdsmi_pcie_info_t *data) {
+                     return amdsmi_get_pcie_info(handle, data);
+                 });
+}
+
+amdsmi_status_t
+smi_cache::power_info(amdsmi_processor_handle handle,
+                      amdsmi_power_info_t *info, bool refresh) {
+    return read_(entry_(handle)->power_info, info, refresh,
+                 [handle] (amdsmi_power_info_t *data) {
+                     return amdsmi_get_power_info(handle, data);
+                 });
+}
+
+amdsmi_status_t
+smi_cache::gpu_activity(amdsmi_processor_handle handle,
+                        amdsmi_engine_usage_t *info, bool refresh) {
+    return read_(entry_(handle)->gpu_activity, info, refresh,
+                 [handle] (amdsmi_engine_usage_t *data) {
+                     return amdsmi_get_gpu_activity(handle, data);
+                 });
+}
+
+amdsmi_status_t
+smi_cache::energy_count(amdsmi_processor_handle handle,
+                        smi_energy_count_t *count, bool refresh) {
+    return read_(entry_(handle)->energy_count, count, refresh,
+                 [handle] (smi_energy_count_t *data) {
+                     return amdsmi_get_energy_count(handle, &data->energy,
+                                                    &data->resolution,
+                                                    &data->timestamp);
+                 });
+}
+
+amdsmi_status_t
+smi_cache::temp_metric(amdsmi_processor_handle handle,
+                       amdsmi_temperature_type_t sensor,
+                       amdsmi_temperature_metric_t metric,
+                       int64_t *value, bool refresh) {
+    slot_t<int64_t> *slot;
+    entry_t *entry = entry_(handle);
+
+    // slots are created on first use, under the entry map lock
+    entries_lock_.lock();
+    slot = &entry->temp[(uint32_t(sensor) << 16) | uint32_t(metric)];
+    entries_lock_.unlock();
+    return read_(*slot, value, refresh,
+                 [handle, sensor, metric] (int64_t *data) {
+                     return amdsmi_get_temp_metric(handle, sensor, metric,
+                                                   data);
+                 });
+}
+
+/// \brief      build the index of the KFD processes using each GPU
+/// \param[out] index    KFD process index
+/// \return     amdsmi status of the reads
+static amdsmi_status_t
+smi_kfd_pid_index_read_ (smi_kfd_pid_index_ptr_t *index)
+{
+    uint32_t num_pid = 0, num_gpus;
+    amdsmi_status_t amdsmi_ret;
+    uint32_t gpu_list[AGA_MAX_GPU];
+    std::vector<amdsmi_process_info_t> pid_info;
+    smi_kfd_pid_index_t *new_index;
+
+    // kernel fusion driver pids
+    amdsmi_ret = amdsmi_get_gpu_compute_process_info(NULL, &num_pid);
+    if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
+        return amdsmi_ret;
+    }
+    if (num_pid) {
+        pid_info.resize(num_pid);
+        amdsmi_ret = amdsmi_get_gpu_compute_process_info(pid_info.data(),
+                                                         &num_pid);
+        if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
+            return amdsmi_ret;
+        }
+    }
+    // loop thru pids, get the list of GPUs using each pid and add the pid to
+    // the process list of those GPUs
+    new_index = new smi_kfd_pid_index_t();
+    for (uint32_t i = 0; i < num_pid; i++) {
+        num_gpus = AGA_MAX_GPU;
+        amdsmi_ret = amdsmi_get_gpu_compute_process_gpus(pid_info[i].process_id,
+                                                         gpu_list, &num_gpus);
+        if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
+            // process may have exited in the meantime
+            continue;
+        }
+        for (uint32_t j = 0; j < num_gpus; j++) {
+            if (gpu_list[j] < AGA_MAX_GPU) {
+                new_index->pids[gpu_list[j]].push_back(pid_info[i].process_id);
+            }
+        }
+    }
+    index->reset(new_index);
+    return AMDSMI_STATUS_SUCCESS;
+}
+
+amdsmi_status_t
+smi_cache::kfd_pid_index(smi_kfd_pid_index_ptr_t *index, bool refresh) {
+    return read_(kfd_pid_index_, index, refresh, smi_kfd_pid_index_read_);
+}
+
+}    // namespace aga
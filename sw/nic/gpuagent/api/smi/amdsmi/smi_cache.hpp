@@ -0,0 +1,209 @@
+
+/*
+Copyright (c) Advanced Micro Devices, Inc. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+//----------------------------------------------------------------------------
+///
+/// \file
+/// per GPU cache of amdsmi reads shared by the watcher and the API readers
+///
+//----------------------------------------------------------------------------
+
+#ifndef __AGA_API_SMI_CACHE_HPP__
+#define __AGA_API_SMI_CACHE_HPP__
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "nic/third-party/rocm/amd_smi_lib/include/amd_smi/amdsmi.h"
+#include "nic/sdk/include/sdk/base.hpp"
+#include "nic/gpuagent/api/include/base.hpp"
+
+/// default max. age of cached amdsmi data served to readers (in milliseconds)
+#define AGA_SMI_CACHE_TTL_DEFAULT    1000
+
+namespace aga {
+
+/// \defgroup AGA_SMI_CACHE - amdsmi read cache
+/// \ingroup AGA_SMI
+/// @{
+
+/// \brief    energy counter read
+typedef struct smi_energy_count_s {
+    uint64_t energy;
+    float resolution;
+    uint64_t timestamp;
+} smi_energy_count_t;
+
+/// \brief    KFD processes using each of the GPUs
+typedef struct smi_kfd_pid_index_s {
+    /// pids of the KFD processes indexed by GPU id
+    std::vector<uint32_t> pids[AGA_MAX_GPU];
+} smi_kfd_pid_index_t;
+
+/// \brief    KFD process index shared by all the readers, never modified once
+///           built
+typedef std::shared_ptr<const smi_kfd_pid_index_t> smi_kfd_pid_index_ptr_t;
+
+/// \brief    per GPU cache of the (relatively expensive) amdsmi reads that
+///           are needed by more than one consumer; the watcher refreshes the
+///           entries as it samples and API readers are served from the cache
+///           as long as the cached copy is not older than the configured ttl
+/// \remark   each cached read has its own lock, held across the amdsmi call,
+///           so concurrent readers of a stale entry wait for one refresh
+///           instead of each going to the driver
+class smi_cache {
+public:
+    /// \brief constructor
+    smi_cache() {
+        ttl_ = AGA_SMI_CACHE_TTL_DEFAULT;
+    }
+
+    /// \brief destructor
+    ~smi_cache();
+
+    /// \brief     set the max. age of the cached data served to readers
+    /// \param[in] ttl    max. age (in milliseconds)
+    void set_ttl(uint32_t ttl) { ttl_ = ttl; }
+
+    /// \brief      read GPU metrics table
+    /// \param[in]  handle     GPU handle
+    /// \param[out] metrics    GPU metrics
+    /// \param[in]  refresh    true to bypass the cache and refresh it
+    /// \return     amdsmi status of the (possibly cached) read
+    amdsmi_status_t gpu_metrics(amdsmi_processor_handle handle,
+                                amdsmi_gpu_metrics_t *metrics,
+                                bool refresh = false);
+
+    /// \brief      read PCIe info
+    /// \param[in]  handle     GPU handle
+    /// \param[out] info       PCIe info
+    /// \param[in]  refresh    true to bypass the cache and refresh it
+    /// \return     amdsmi status of the (possibly cached) read
+    amdsmi_status_t pcie_info(amdsmi_processor_handle handle,
+                              amdsmi_pcie_info_t *info, bool refresh = false);
+
+    /// \brief      read power info
+    /// \param[in]  handle     GPU handle
+    /// \param[out] info       power info
+    /// \param[in]  refresh    true to bypass the cache and refresh it
+    /// \return     amdsmi status of the (possibly cached) read
+    amdsmi_status_t power_info(amdsmi_processor_handle handle,
+                               amdsmi_power_info_t *info,
+                               bool refresh = false);
+
+    /// \brief      read engine activity
+    /// \param[in]  handle     GPU handle
+    /// \param[out] info       engine activity
+    /// \param[in]  refresh    true to bypass the cache and refresh it
+    /// \return     amdsmi status of the (possibly cached) read
+    amdsmi_status_t gpu_activity(amdsmi_processor_handle handle,
+                                 amdsmi_engine_usage_t *info,
+                                 bool refresh = false);
+
+    /// \brief      read energy counter
+    /// \param[in]  handle     GPU handle
+    /// \param[out] count      energy counter
+    /// \param[in]  refresh    true to bypass the cache and refresh it
+    /// \return     amdsmi status of the (possibly cached) read
+    amdsmi_status_t energy_count(amdsmi_processor_handle handle,
+                                 smi_energy_count_t *count,
+                                 bool refresh = false);
+
+    /// \brief      read temperature metric
+    /// \param[in]  handle     GPU handle
+    /// \param[in]  sensor     temperature sensor
+    /// \param[in]  metric     temperature metric
+    /// \param[out] value      temperature
+    /// \param[in]  refresh    true to bypass the cache and refresh it
+    /// \return     amdsmi status of the (possibly cached) read
+    amdsmi_status_t temp_metric(amdsmi_processor_handle handle,
+                                amdsmi_temperature_type_t sensor,
+                                amdsmi_temperature_metric_t metric,
+                                int64_t *value, bool refresh = false);
+
+    /// \brief      read the system wide index of the KFD processes using each
+    ///             GPU, the index is built with one walk over all the KFD
+    ///             processes and is shared by all the GPUs
+    /// \param[out] index      KFD process index
+    /// \param[in]  refresh    true to bypass the cache and refresh it
+    /// \return     amdsmi status of the (possibly cached) read
+    amdsmi_status_t kfd_pid_index(smi_kfd_pid_index_ptr_t *index,
+                                  bool refresh = false);
+
+private:
+    /// \brief    cached copy of one amdsmi read
+    template <typename T>
+    struct slot_t {
+        /// lock serializing the refreshes of this slot
+        std::mutex lock;
+        /// last time the slot was refreshed (in milliseconds), 0 if never
+        uint64_t ts = 0;
+        /// status of the last read
+        amdsmi_status_t status = AMDSMI_STATUS_SUCCESS;
+        /// data returned by the last read
+        T data = {};
+    };
+
+    /// \brief    all cached reads of a GPU
+    typedef struct entry_s {
+        slot_t<amdsmi_gpu_metrics_t> gpu_metrics;
+        slot_t<amdsmi_pcie_info_t> pcie_info;
+        slot_t<amdsmi_power_info_t> power_info;
+        slot_t<amdsmi_engine_usage_t> gpu_activity;
+        slot_t<smi_energy_count_t> energy_count;
+        /// temperature reads keyed by (sensor, metric)
+        std::unordered_map<uint32_t, slot_t<int64_t>> temp;
+    } entry_t;
+
+    /// \brief     find or create the cache entry of a GPU
+    /// \param[in] handle    GPU handle
+    /// \return    cache entry of the GPU
+    entry_t *entry_(amdsmi_processor_handle handle);
+
+    /// \brief      serve a read from the given slot, refreshing it with the
+    ///             given read function if it is too old
+    /// \param[in]  slot       cache slot
+    /// \param[out] data       data read
+    /// \param[in]  refresh    true to bypass the cache and refresh it
+    /// \param[in]  read       function to read the data from amdsmi
+    /// \return     amdsmi status of the (possibly cached) read
+    template <typename T, typename F>
+    amdsmi_status_t read_(slot_t<T>& slot, T *data, bool refresh, F read);
+
+private:
+    /// lock protecting the entry map
+    std::mutex entries_lock_;
+    /// per GPU cache entries, entries live as long as the agent
+    std::unordered_map<amdsmi_processor_handle, entry_t *> entries_;
+    /// KFD process index of all the GPUs
+    slot_t<smi_kfd_pid_index_ptr_t> kfd_pid_index_;
+    /// max. age of cached data served to readers (in milliseconds)
+    uint32_t ttl_;
+};
+
+/// global singleton amdsmi read cache instance
+extern smi_cache g_smi_cache;
+
+/// \@}
+
+}    // namespace aga
+
+using aga::smi_cache;
+
+#endif    // __AGA_API_SMI_CACHE_HPP__
@@ -20,15 +20,20 @@ limitations under the License.
 ///
 //----------------------------------------------------------------------------
 
+#include <algorithm>
 #include <vector>
 #include "nic/third-party/rocm/amd_smi_lib/include/amd_smi/amdsmi.h"
 #include "nic/gpuagent/core/trace.hpp"
 #include "nic/gpuagent/core/aga_core.hpp"
 #include "nic/gpuagent/core/ipc_msg.hpp"
 #include "nic/gpuagent/api/aga_state.hpp"
+#include "nic/gpuagent/api/gpu_watch_snapshot.hpp"
+#include "nic/gpuagent/api/gpu_watch_history.hpp"
+#include "nic/gpuagent/api/gpu_watch_sched.hpp"
 #include "nic/gpuagent/api/smi/smi_state.hpp"
 #include "nic/gpuagent/api/smi/smi_watch.hpp"
 #include "nic/gpuagent/api/smi/amdsmi/smi_utils.hpp"
+#include "nic/gpuagent/api/smi/amdsmi/smi_cache.hpp"
 
 using std::vector;
 
@@ -37,10 +42,10 @@ using std::vector;
 
 namespace event = sdk::event_thread;
 
-/// initial delay after which event monitoring starts (in seconds)
-#define AGA_SMI_EVENT_MONITOR_START_DELAY    10.0
-/// event monitoring frequency (in seconds)
-#define AGA_SMI_EVENT_MONITOR_INTERVAL       3.0
+/// max. time the event reader waits for GPU events in one go (in msecs)
+#define AGA_SMI_EVENT_READ_TIMEOUT           1000
+/// max. number of events handled by the event monitor in one go
+#define AGA_SMI_EVENT_BATCH_SIZE             128
 /// all amdsmi events of interest
 #define AMDSMI_EVENT_MASK_ALL                  \
             ((1 << AMDSMI_EVT_NOTIF_VMFAULT)          |    \
@@ -53,7 +58,8 @@ namespace event = sdk::event_thread;
 
 /// initial delay after which watch field update starts
 #define AGA_WATCHER_START_DELAY            10.0
-/// watch field frequency (in seconds)
+/// watcher tick interval until the watches ask for sampling and while none
+/// of the watch attributes are in demand (in seconds)
 #define AGA_WATCHER_INTERVAL               1.0
 /// watcher gpu group name
 #define AGA_WATCHER_GPU_GROUP_NAME         "AGA_GPU_GROUP"
@@ -65,17 +71,176 @@ namespace event = sdk::event_thread;
 #define AGA_WATCHER_MAX_KEEP_AGE           60
 /// max samples of a field value
 #define AGA_WATCHER_MAX_KEEP_SAMPLES       10
-/// gpu watch subscriber notify frequency (in seconds)
-#define AGA_WATCHER_GPU_WATCH_UPDATE_FREQ  5
+/// max. no. of worker threads used by the watcher to sample GPUs in parallel
+#define AGA_WATCHER_MAX_WORKERS            8
+/// max. no. of worker threads used to read the GPU topology in parallel
+#define AGA_TOPO_MAX_WORKERS               8
 
 namespace aga {
 
 /// global singleton smi state class instance
 smi_state g_smi_state;
 
+/// current interval of the watch timer (in milliseconds)
+static uint32_t g_watch_timer_interval;
+
 /// vector of all watchable GPU attrs
 static std::vector<aga_gpu_watch_attr_id_t> g_watch_field_list;
 
+/// offset of the field backing each watchable GPU attr in the watch fields
+static size_t g_watch_field_offset[AGA_GPU_WATCH_ATTRS_MAX];
+
+static void
+smi_watch_field_offset_init (void)
+{
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_GPU_CLOCK] =
+        offsetof(aga_gpu_watch_fields_t, gpu_clock);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_MEM_CLOCK] =
+        offsetof(aga_gpu_watch_fields_t, memory_clock);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_GPU_TEMP] =
+        offsetof(aga_gpu_watch_fields_t, gpu_temperature);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_MEMORY_TEMP] =
+        offsetof(aga_gpu_watch_fields_t, memory_temperature);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_POWER_USAGE] =
+        offsetof(aga_gpu_watch_fields_t, power_usage);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_PCIE_TX] =
+        offsetof(aga_gpu_watch_fields_t, pcie_tx_usage);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_PCIE_RX] =
+        offsetof(aga_gpu_watch_fields_t, pcie_rx_usage);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_PCIE_BANDWIDTH] =
+        offsetof(aga_gpu_watch_fields_t, pcie_bandwidth);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_GPU_UTIL] =
+        offsetof(aga_gpu_watch_fields_t, gpu_util);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_GPU_MEMORY_USAGE] =
+        offsetof(aga_gpu_watch_fields_t, gpu_memory_usage);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_CORRECT_TOTAL] =
+        offsetof(aga_gpu_watch_fields_t, total_correctable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_UNCORRECT_TOTAL] =
+        offsetof(aga_gpu_watch_fields_t, total_uncorrectable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_SDMA_CE] =
+        offsetof(aga_gpu_watch_fields_t, sdma_correctable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_SDMA_UE] =
+        offsetof(aga_gpu_watch_fields_t, sdma_uncorrectable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_GFX_CE] =
+        offsetof(aga_gpu_watch_fields_t, gfx_correctable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_GFX_UE] =
+        offsetof(aga_gpu_watch_fields_t, gfx_uncorrectable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_MMHUB_CE] =
+        offsetof(aga_gpu_watch_fields_t, mmhub_correctable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_MMHUB_UE] =
+        offsetof(aga_gpu_watch_fields_t, mmhub_uncorrectable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_ATHUB_CE] =
+        offsetof(aga_gpu_watch_fields_t, athub_correctable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_ATHUB_UE] =
+        offsetof(aga_gpu_watch_fields_t, athub_uncorrectable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_PCIE_BIF_CE] =
+        offsetof(aga_gpu_watch_fields_t, bif_correctable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_PCIE_BIF_UE] =
+        offsetof(aga_gpu_watch_fields_t, bif_uncorrectable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_HDP_CE] =
+        offsetof(aga_gpu_watch_fields_t, hdp_correctable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_HDP_UE] =
+        offsetof(aga_gpu_watch_fields_t, hdp_uncorrectable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_XGMI_WAFL_CE] =
+        offsetof(aga_gpu_watch_fields_t, xgmi_wafl_correctable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_XGMI_WAFL_UE] =
+        offsetof(aga_gpu_watch_fields_t, xgmi_wafl_uncorrectable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_DF_CE] =
+        offsetof(aga_gpu_watch_fields_t, df_correctable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_DF_UE] =
+        offsetof(aga_gpu_watch_fields_t, df_uncorrectable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_SMN_CE] =
+        offsetof(aga_gpu_watch_fields_t, smn_correctable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_SMN_UE] =
+        offsetof(aga_gpu_watch_fields_t, smn_uncorrectable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_SEM_CE] =
+        offsetof(aga_gpu_watch_fields_t, sem_correctable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_SEM_UE] =
+        offsetof(aga_gpu_watch_fields_t, sem_uncorrectable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_MP0_CE] =
+        offsetof(aga_gpu_watch_fields_t, mp0_correctable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_MP0_UE] =
+        offsetof(aga_gpu_watch_fields_t, mp0_uncorrectable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_MP1_CE] =
+        offsetof(aga_gpu_watch_fields_t, mp1_correctable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_MP1_UE] =
+        offsetof(aga_gpu_watch_fields_t, mp1_uncorrectable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_FUSE_CE] =
+        offsetof(aga_gpu_watch_fields_t, fuse_correctable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_FUSE_UE] =
+        offsetof(aga_gpu_watch_fields_t, fuse_uncorrectable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_UMC_CE] =
+        offsetof(aga_gpu_watch_fields_t, umc_correctable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_UMC_UE] =
+        offsetof(aga_gpu_watch_fields_t, umc_uncorrectable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_MCA_CE] =
+        offsetof(aga_gpu_watch_fields_t, mca_correctable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_MCA_UE] =
+        offsetof(aga_gpu_watch_fields_t, mca_uncorrectable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_VCN_CE] =
+        offsetof(aga_gpu_watch_fields_t, vcn_correctable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_VCN_UE] =
+        offsetof(aga_gpu_watch_fields_t, vcn_uncorrectable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_JPEG_CE] =
+        offsetof(aga_gpu_watch_fields_t, jpeg_correctable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_JPEG_UE] =
+        offsetof(aga_gpu_watch_fields_t, jpeg_uncorrectable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_IH_CE] =
+        offsetof(aga_gpu_watch_fields_t, ih_correctable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_IH_UE] =
+        offsetof(aga_gpu_watch_fields_t, ih_uncorrectable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_MPIO_CE] =
+        offsetof(aga_gpu_watch_fields_t, mpio_correctable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_ECC_MPIO_UE] =
+        offsetof(aga_gpu_watch_fields_t, mpio_uncorrectable_errors);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_XGMI_0_NOP_TX] =
+        offsetof(aga_gpu_watch_fields_t, xgmi_neighbor0_tx_nops);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_XGMI_0_REQ_TX] =
+        offsetof(aga_gpu_watch_fields_t, xgmi_neighbor0_tx_requests);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_XGMI_0_RESP_TX] =
+        offsetof(aga_gpu_watch_fields_t, xgmi_neighbor0_tx_responses);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_XGMI_0_BEATS_TX] =
+        offsetof(aga_gpu_watch_fields_t, xgmi_neighbor0_tx_beats);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_XGMI_1_NOP_TX] =
+        offsetof(aga_gpu_watch_fields_t, xgmi_neighbor1_tx_nops);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_XGMI_1_REQ_TX] =
+        offsetof(aga_gpu_watch_fields_t, xgmi_neighbor1_tx_requests);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_XGMI_1_RESP_TX] =
+        offsetof(aga_gpu_watch_fields_t, xgmi_neighbor1_tx_responses);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_XGMI_1_BEATS_TX] =
+        offsetof(aga_gpu_watch_fields_t, xgmi_neighbor1_tx_beats);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_XGMI_0_THRPUT] =
+        offsetof(aga_gpu_watch_fields_t, xgmi_neighbor0_tx_throughput);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_XGMI_1_THRPUT] =
+        offsetof(aga_gpu_watch_fields_t, xgmi_neighbor1_tx_throughput);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_XGMI_2_THRPUT] =
+        offsetof(aga_gpu_watch_fields_t, xgmi_neighbor2_tx_throughput);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_XGMI_3_THRPUT] =
+        offsetof(aga_gpu_watch_fields_t, xgmi_neighbor3_tx_throughput);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_XGMI_4_THRPUT] =
+        offsetof(aga_gpu_watch_fields_t, xgmi_neighbor4_tx_throughput);
+    g_watch_field_offset[AGA_GPU_WATCH_ATTR_ID_XGMI_5_THRPUT] =
+        offsetof(aga_gpu_watch_fields_t, xgmi_neighbor5_tx_throughput);
+}
+
+/// watch attrs that are filled from the GPU metrics table, if available
+static aga_gpu_watch_attr_set_t g_gpu_metrics_attrs;
+/// watch attrs that are filled from the per GPU block ECC counts
+static aga_gpu_watch_attr_set_t g_ecc_attrs;
+
+static void
+smi_watch_field_deps_init (void)
+{
+    g_gpu_metrics_attrs.set(AGA_GPU_WATCH_ATTR_ID_GPU_CLOCK);
+    g_gpu_metrics_attrs.set(AGA_GPU_WATCH_ATTR_ID_MEMORY_TEMP);
+    g_gpu_metrics_attrs.set(AGA_GPU_WATCH_ATTR_ID_POWER_USAGE);
+    g_gpu_metrics_attrs.set(AGA_GPU_WATCH_ATTR_ID_GPU_UTIL);
+    for (uint32_t attr = AGA_GPU_WATCH_ATTR_ID_ECC_CORRECT_TOTAL;
+         attr <= AGA_GPU_WATCH_ATTR_ID_ECC_MPIO_UE; attr++) {
+        g_ecc_attrs.set(attr);
+    }
+}
+
 static void
 smi_watch_field_list_init (void)
 {
@@ -151,17 +316,46 @@ smi_watch_field_list_init (void)
     g_watch_field_list.push_back(AGA_GPU_WATCH_ATTR_ID_XGMI_5_THRPUT);
 }
 
+/// \brief    return the index of the given XGMI counter in the per GPU slot
+/// \param[in] event_type    XGMI counter event type
+/// \return    index of the counter in gpu_slot_t::xgmi_counter
+static inline uint32_t
+xgmi_counter_idx_ (amdsmi_event_type_t event_type)
+{
+    if (event_type <= AMDSMI_EVNT_XGMI_LAST) {
+        return event_type - AMDSMI_EVNT_XGMI_FIRST;
+    }
+    return (AMDSMI_EVNT_XGMI_LAST - AMDSMI_EVNT_XGMI_FIRST + 1) +
+               (event_type - AMDSMI_EVNT_XGMI_DATA_OUT_FIRST);
+}
+
+bool
+smi_state::xgmi_counter_read_(uint32_t gpu_id, amdsmi_event_type_t event_type,
+                              amdsmi_counter_value_t *counter_value) {
+    amdsmi_event_handle_t counter_handle;
+
+    counter_handle =
+        gpu_slot_[gpu_id].xgmi_counter[xgmi_counter_idx_(event_type)];
+    if (counter_handle == 0) {
+        // counter is not created on this GPU
+        return false;
+    }
+    return amdsmi_gpu_read_counter(counter_handle, counter_value) ==
+               AMDSMI_STATUS_SUCCESS;
+}
+
 sdk_ret_t
 smi_state::smi_watcher_update_all_watch_fields_(uint32_t gpu_id,
                amdsmi_processor_handle gpu_handle,
-               aga_gpu_watch_db_t *watch_db) {
+               const aga_gpu_watch_attr_set_t& due, bool refresh,
+               aga_gpu_watch_fields_t *fields) {
     double time_sec;
-    uint64_t counter_key;
     int64_t int64_val = 0;
     amdsmi_error_count_t ec;
     uint64_t uint64_val = 0;
     amdsmi_clk_type_t clk_type;
     amdsmi_status_t amdsmi_ret;
+    bool ecc_due = false;
     bool bulk_get_succeeded = false;
     amdsmi_pcie_info_t pcie_info = { 0 };
     uint64_t total_correctable_count = 0;
@@ -174,18 +368,31 @@ smi_state::smi_watcher_update_all_watch_fields_(uint32_t gpu_id,
     uint64_t pcie_tx = 0, pcie_rx = 0;
     amdsmi_counter_value_t counter_value = { 0 };
 
-    watch_db->watch_info[gpu_id] = { 0 };
+    // reset the fields being sampled now, the rest carry their last sample
+    for (uint32_t attr = 0; attr < AGA_GPU_WATCH_ATTRS_MAX; attr++) {
+        if (due.test(attr)) {
+            *(uint64_t *)((uint8_t *)fields + g_watch_field_offset[attr]) = 0;
+        }
+    }
 
-    // get GPU metrics, which can be used to bulk fill a few fields
-    amdsmi_ret = amdsmi_get_gpu_metrics_info(gpu_handle, &gpu_metrics);
-    if (amdsmi_ret == AMDSMI_STATUS_SUCCESS) {
-        // mark bulk get as succeeded
-        bulk_get_succeeded = true;
+    // get GPU metrics, which can be used to bulk fill a few fields, only if
+    // any of those fields are due; the watcher always reads afresh and
+    // leaves the result in the cache for API readers, which are served from
+    // the cache
+    if ((due & g_gpu_metrics_attrs).any()) {
+        amdsmi_ret = g_smi_cache.gpu_metrics(gpu_handle, &gpu_metrics,
+                                             refresh);
+        if (amdsmi_ret == AMDSMI_STATUS_SUCCESS) {
+            // mark bulk get as succeeded
+            bulk_get_succeeded = true;
+        }
     }
 
-    // get correctable and uncorrectable total error count beforehand
-    for (uint32_t b = AMDSMI_GPU_BLOCK_FIRST; b <= AMDSMI_GPU_BLOCK_LAST;
-         b = b * 2) {
+    // get correctable and uncorrectable total error count beforehand, if
+    // any of the error counts are due
+    ecc_due = (due & g_ecc_attrs).any();
+    for (uint32_t b = AMDSMI_GPU_BLOCK_FIRST;
+         ecc_due && (b <= AMDSMI_GPU_BLOCK_LAST); b = b * 2) {
         // initialize ec to all 0s
         ec = { 0 };
         amdsmi_ret = amdsmi_get_gpu_ecc_count(gpu_handle,
@@ -195,117 +402,117 @@ smi_state::smi_watcher_update_all_watch_fields_(uint32_t gpu_id,
             total_uncorrectable_count += ec.uncorrectable_count;
             switch (b) {
             case AMDSMI_GPU_BLOCK_UMC:
-                watch_db->watch_info[gpu_id].umc_correctable_errors =
+                fields->umc_correctable_errors =
                     ec.correctable_count;
-                watch_db->watch_info[gpu_id].umc_uncorrectable_errors =
+                fields->umc_uncorrectable_errors =
                     ec.uncorrectable_count;
                 break;
             case AMDSMI_GPU_BLOCK_SDMA:
-                watch_db->watch_info[gpu_id].sdma_correctable_errors =
+                fields->sdma_correctable_errors =
                     ec.correctable_count;
-                watch_db->watch_info[gpu_id].sdma_uncorrectable_errors =
+                fields->sdma_uncorrectable_errors =
                     ec.uncorrectable_count;
                 break;
             case AMDSMI_GPU_BLOCK_GFX:
-                watch_db->watch_info[gpu_id].gfx_correctable_errors =
+                fields->gfx_correctable_errors =
                     ec.correctable_count;
-                watch_db->watch_info[gpu_id].gfx_uncorrectable_errors =
+                fields->gfx_uncorrectable_errors =
                     ec.uncorrectable_count;
                 break;
             case AMDSMI_GPU_BLOCK_MMHUB:
-                watch_db->watch_info[gpu_id].mmhub_correctable_errors =
+                fields->mmhub_correctable_errors =
                     ec.correctable_count;
-                watch_db->watch_info[gpu_id].mmhub_uncorrectable_errors =
+                fields->mmhub_uncorrectable_errors =
                     ec.uncorrectable_count;
                 break;
             case AMDSMI_GPU_BLOCK_ATHUB:
-                watch_db->watch_info[gpu_id].athub_correctable_errors =
+                fields->athub_correctable_errors =
                     ec.correctable_count;
-                watch_db->watch_info[gpu_id].athub_uncorrectable_errors =
+                fields->athub_uncorrectable_errors =
                     ec.uncorrectable_count;
                 break;
             case AMDSMI_GPU_BLOCK_PCIE_BIF:
-                watch_db->watch_info[gpu_id].bif_correctable_errors =
+                fields->bif_correctable_errors =
                     ec.correctable_count;
-                watch_db->watch_info[gpu_id].bif_uncorrectable_errors =
+                fields->bif_uncorrectable_errors =
                     ec.uncorrectable_count;
                 break;
             case AMDSMI_GPU_BLOCK_HDP:
-                watch_db->watch_info[gpu_id].hdp_correctable_errors =
+                fields->hdp_correctable_errors =
                     ec.correctable_count;
-                watch_db->watch_info[gpu_id].hdp_uncorrectable_errors =
+                fields->hdp_uncorrectable_errors =
                     ec.uncorrectable_count;
                 break;
             case AMDSMI_GPU_BLOCK_XGMI_WAFL:
-                watch_db->watch_info[gpu_id].xgmi_wafl_correctable_errors =
+                fields->xgmi_wafl_correctable_errors =
                     ec.correctable_count;
-                watch_db->watch_info[gpu_id].xgmi_wafl_uncorrectable_errors =
+                fields->xgmi_wafl_uncorrectable_errors =
                     ec.uncorrectable_count;
                 break;
             case AMDSMI_GPU_BLOCK_DF:
-                watch_db->watch_info[gpu_id].df_correctable_errors =
+                fields->df_correctable_errors =
                     ec.correctable_count;
-                watch_db->watch_info[gpu_id].df_uncorrectable_errors =
+                fields->df_uncorrectable_errors =
                     ec.uncorrectable_count;
                 break;
             case AMDSMI_GPU_BLOCK_SMN:
-                watch_db->watch_info[gpu_id].smn_correctable_errors =
+                fields->smn_correctable_errors =
                     ec.correctable_count;
-                watch_db->watch_info[gpu_id].smn_uncorrectable_errors =
+                fields->smn_uncorrectable_errors =
                     ec.uncorrectable_count;
                 break;
             case AMDSMI_GPU_BLOCK_SEM:
-                watch_db->watch_info[gpu_id].sem_correctable_errors =
+                fields->sem_correctable_errors =
                     ec.correctable_count;
-                watch_db->watch_info[gpu_id].sem_uncorrectable_errors =
+                fields->sem_uncorrectable_errors =
                     ec.uncorrectable_count;
                 break;
             case AMDSMI_GPU_BLOCK_MP0:
-                watch_db->watch_info[gpu_id].mp0_correctable_errors =
+                fields->mp0_correctable_errors =
                     ec.correctable_count;
-                watch_db->watch_info[gpu_id].mp0_uncorrectable_errors =
+                fields->mp0_uncorrectable_errors =
                     ec.uncorrectable_count;
                 break;
             case AMDSMI_GPU_BLOCK_MP1:
-                watch_db->watch_info[gpu_id].mp1_correctable_errors =
+                fields->mp1_correctable_errors =
                     ec.correctable_count;
-                watch_db->watch_info[gpu_id].mp1_uncorrectable_errors =
+                fields->mp1_uncorrectable_errors =
                     ec.uncorrectable_count;
                 break;
             case AMDSMI_GPU_BLOCK_FUSE:
-                watch_db->watch_info[gpu_id].fuse_correctable_errors =
+                fields->fuse_correctable_errors =
                     ec.correctable_count;
-                watch_db->watch_info[gpu_id].fuse_uncorrectable_errors =
+                fields->fuse_uncorrectable_errors =
                     ec.uncorrectable_count;
                 break;
             case AMDSMI_GPU_BLOCK_MCA:
-                watch_db->watch_info[gpu_id].mca_correctable_errors =
+                fields->mca_correctable_errors =
                     ec.correctable_count;
-                watch_db->watch_info[gpu_id].mca_uncorrectable_errors =
+                fields->mca_uncorrectable_errors =
                     ec.uncorrectable_count;
                 break;
             case AMDSMI_GPU_BLOCK_VCN:
-                watch_db->watch_info[gpu_id].vcn_correctable_errors =
+                fields->vcn_correctable_errors =
                     ec.correctable_count;
-                watch_db->watch_info[gpu_id].vcn_uncorrectable_errors =
+                fields->vcn_uncorrectable_errors =
                     ec.uncorrectable_count;
                 break;
             case AMDSMI_GPU_BLOCK_JPEG:
-                watch_db->watch_info[gpu_id].jpeg_correctable_errors =
+                fields->jpeg_correctable_errors =
                     ec.correctable_count;
-                watch_db->watch_info[gpu_id].jpeg_uncorrectable_errors =
+                fields->jpeg_uncorrectable_errors =
                     ec.uncorrectable_count;
                 break;
             case AMDSMI_GPU_BLOCK_IH:
-                watch_db->watch_info[gpu_id].ih_correctable_errors =
+                fields->ih_correctable_errors =
                     ec.correctable_count;
-                watch_db->watch_info[gpu_id].ih_uncorrectable_errors =
+                fields->ih_uncorrectable_errors =
                     ec.uncorrectable_count;
                 break;
             case AMDSMI_GPU_BLOCK_MPIO:
-                watch_db->watch_info[gpu_id].mpio_correctable_errors =
+                fields->mpio_correctable_errors =
                     ec.correctable_count;
-                watch_db->watch_info[gpu_id].mpio_uncorrectable_errors =
+                fields->mpio_uncorrectable_errors =
                     ec.uncorrectable_count;
                 break;
             default:
@@ -314,19 +521,22 @@ smi_state::smi_watcher_update_all_watch_fields_(uint32_t gpu_id,
         }
     }
 
-    // loop through all watch fields
+    // loop through all watch fields that are due for sampling
     for (uint32_t i = 0; i < g_watch_field_list.size(); i++) {
+        if (!due.test(g_watch_field_list[i])) {
+            continue;
+        }
         switch (g_watch_field_list[i]) {
         case AGA_GPU_WATCH_ATTR_ID_GPU_CLOCK:
             if (bulk_get_succeeded) {
                 // GPU clock frequency in MHz
-                watch_db->watch_info[gpu_id].gpu_clock = gpu_metrics.current_gfxclk;
+                fields->gpu_clock = gpu_metrics.current_gfxclk;
             } else {
                 clk_type = AMDSMI_CLK_TYPE_SYS;
                 // get clock frequency
                 amdsmi_ret = amdsmi_get_clk_freq(gpu_handle, clk_type, &freq_info);
                 if (amdsmi_ret == AMDSMI_STATUS_SUCCESS) {
-                    watch_db->watch_info[gpu_id].gpu_clock =
+                    fields->gpu_clock =
                         freq_info.frequency[freq_info.current] / 1000000;
                 }
             }
@@ -336,89 +546,91 @@ smi_state::smi_watcher_update_all_watch_fields_(uint32_t gpu_id,
             // get clock frequency
             amdsmi_ret = amdsmi_get_clk_freq(gpu_handle, clk_type, &freq_info);
             if (amdsmi_ret == AMDSMI_STATUS_SUCCESS) {
-                watch_db->watch_info[gpu_id].memory_clock =
+                fields->memory_clock =
                     freq_info.frequency[freq_info.current] / 1000000;
             }
             break;
         case AGA_GPU_WATCH_ATTR_ID_MEMORY_TEMP:
             if (bulk_get_succeeded) {
                 // GPU memory temperature in celsius
-                watch_db->watch_info[gpu_id].memory_temperature =
+                fields->memory_temperature =
                     gpu_metrics.temperature_mem;
             } else {
                 sensor_type = AMDSMI_TEMPERATURE_TYPE_VRAM;
                 // get GPU memory temperature
-                amdsmi_ret = amdsmi_get_temp_metric(gpu_handle, sensor_type,
-                                 AMDSMI_TEMP_CURRENT, &int64_val);
+                amdsmi_ret = g_smi_cache.temp_metric(gpu_handle, sensor_type,
+                                 AMDSMI_TEMP_CURRENT, &int64_val, refresh);
                 if (amdsmi_ret == AMDSMI_STATUS_SUCCESS) {
-                    watch_db->watch_info[gpu_id].memory_temperature = int64_val;
+                    fields->memory_temperature = int64_val;
                 }
             }
             break;
         case AGA_GPU_WATCH_ATTR_ID_GPU_TEMP:
             sensor_type = AMDSMI_TEMPERATURE_TYPE_EDGE;
             // get GPU temperature
-            amdsmi_ret = amdsmi_get_temp_metric(gpu_handle, sensor_type,
-                             AMDSMI_TEMP_CURRENT, &int64_val);
+            amdsmi_ret = g_smi_cache.temp_metric(gpu_handle, sensor_type,
+                             AMDSMI_TEMP_CURRENT, &int64_val, refresh);
             if (amdsmi_ret == AMDSMI_STATUS_NOT_SUPPORTED) {
                 // fallback to hotspot temperature as some card may not have
                 // edge temperature.
                 sensor_type = AMDSMI_TEMPERATURE_TYPE_JUNCTION;
-                amdsmi_ret = amdsmi_get_temp_metric(gpu_handle, sensor_type,
-                                 AMDSMI_TEMP_CURRENT, &int64_val);
+                amdsmi_ret = g_smi_cache.temp_metric(gpu_handle, sensor_type,
+                                 AMDSMI_TEMP_CURRENT, &int64_val, refresh);
             }
             if (amdsmi_ret == AMDSMI_STATUS_SUCCESS) {
-                watch_db->watch_info[gpu_id].gpu_temperature = int64_val;
+                fields->gpu_temperature = int64_val;
             }
             break;
         case AGA_GPU_WATCH_ATTR_ID_POWER_USAGE:
             if (bulk_get_succeeded) {
                 // GPU power usage
                 if (gpu_metrics.average_socket_power == 65535) {
-                    watch_db->watch_info[gpu_id].power_usage =
+                    fields->power_usage =
                         gpu_metrics.current_socket_power;
                 } else {
-                    watch_db->watch_info[gpu_id].power_usage =
+                    fields->power_usage =
                         gpu_metrics.average_socket_power;
                 }
             }
             // power usage was not read from GPU metrics; use other API to read
-            if (!watch_db->watch_info[gpu_id].power_usage) {
-                amdsmi_ret = amdsmi_get_power_info(gpu_handle, &power_info);
+            if (!fields->power_usage) {
+                amdsmi_ret = g_smi_cache.power_info(gpu_handle, &power_info,
+                                                    refresh);
                 if (amdsmi_ret == AMDSMI_STATUS_SUCCESS) {
                     if (power_info.average_socket_power != 65535) {
-                        watch_db->watch_info[gpu_id].power_usage =
+                        fields->power_usage =
                             power_info.average_socket_power;
                     } else if (power_info.current_socket_power != 65535) {
-                        watch_db->watch_info[gpu_id].power_usage =
+                        fields->power_usage =
                             power_info.current_socket_power;
                     }
                 }
             }
             break;
         case AGA_GPU_WATCH_ATTR_ID_PCIE_TX:
-            watch_db->watch_info[gpu_id].pcie_tx_usage = pcie_tx;
+            fields->pcie_tx_usage = pcie_tx;
             break;
         case AGA_GPU_WATCH_ATTR_ID_PCIE_RX:
-            watch_db->watch_info[gpu_id].pcie_rx_usage = pcie_rx;
+            fields->pcie_rx_usage = pcie_rx;
             break;
         case AGA_GPU_WATCH_ATTR_ID_PCIE_BANDWIDTH:
             // PCIe bandwidth
-            amdsmi_ret = amdsmi_get_pcie_info(gpu_handle, &pcie_info);
+            amdsmi_ret = g_smi_cache.pcie_info(gpu_handle, &pcie_info, refresh);
             if (unlikely(amdsmi_ret == AMDSMI_STATUS_SUCCESS)) {
-                watch_db->watch_info[gpu_id].pcie_bandwidth =
+                fields->pcie_bandwidth =
                     pcie_info.pcie_metric.pcie_bandwidth;
             }
             break;
         case AGA_GPU_WATCH_ATTR_ID_GPU_UTIL:
             if (bulk_get_succeeded) {
                 // GPU utilization
-                watch_db->watch_info[gpu_id].gpu_util =
+                fields->gpu_util =
                     gpu_metrics.average_gfx_activity;
             } else {
-                amdsmi_ret = amdsmi_get_gpu_activity(gpu_handle, &usage_info);
+                amdsmi_ret = g_smi_cache.gpu_activity(gpu_handle, &usage_info,
+                                                      refresh);
                 if (amdsmi_ret == AMDSMI_STATUS_SUCCESS) {
-                    watch_db->watch_info[gpu_id].gpu_util =
+                    fields->gpu_util =
                         usage_info.gfx_activity;
                 }
             }
@@ -429,252 +641,126 @@ smi_state::smi_watcher_update_all_watch_fields_(uint32_t gpu_id,
                                                      &uint64_val);
             if (amdsmi_ret == AMDSMI_STATUS_SUCCESS) {
                 // convert GPU memory usage from bytes to MB
-                watch_db->watch_info[gpu_id].gpu_memory_usage =
+                fields->gpu_memory_usage =
                     uint64_val/1024/1024;
             }
             break;
         case AGA_GPU_WATCH_ATTR_ID_ECC_CORRECT_TOTAL:
-            watch_db->watch_info[gpu_id].total_correctable_errors =
+            fields->total_correctable_errors =
                 total_correctable_count;
             break;
         case AGA_GPU_WATCH_ATTR_ID_ECC_UNCORRECT_TOTAL:
-            watch_db->watch_info[gpu_id].total_uncorrectable_errors =
+            fields->total_uncorrectable_errors =
                 total_uncorrectable_count;
             break;
         case AGA_GPU_WATCH_ATTR_ID_XGMI_0_NOP_TX:
-            {
-                counter_key = reinterpret_cast<uint64_t>(gpu_handle) +
-                                  AMDSMI_EVNT_XGMI_0_NOP_TX;
-                auto it = counter_handle_.find(counter_key);
-                if (it != counter_handle_.end()) {
-                    amdsmi_ret = amdsmi_gpu_read_counter(it->second,
-                                                         &counter_value);
-                    if (amdsmi_ret != AMDSMI_STATUS_SUCCESS) {
-                        break;
-                    }
-                    watch_db->watch_info[gpu_id].xgmi_neighbor0_tx_nops =
-                        counter_value.value;
-                }
+            if (xgmi_counter_read_(gpu_id, AMDSMI_EVNT_XGMI_0_NOP_TX,
+                                   &counter_value)) {
+                fields->xgmi_neighbor0_tx_nops =
+                    counter_value.value;
             }
             break;
         case AGA_GPU_WATCH_ATTR_ID_XGMI_0_REQ_TX:
-            {
-                counter_key = reinterpret_cast<uint64_t>(gpu_handle) +
-                                  AMDSMI_EVNT_XGMI_0_REQUEST_TX;
-                auto it = counter_handle_.find(counter_key);
-                if (it != counter_handle_.end()) {
-                    amdsmi_ret = amdsmi_gpu_read_counter(it->second,
-                                                         &counter_value);
-                    if (amdsmi_ret != AMDSMI_STATUS_SUCCESS) {
-                        break;
-                    }
-                    watch_db->watch_info[gpu_id].xgmi_neighbor0_tx_requests =
-                        counter_value.value;
-                }
+            if (xgmi_counter_read_(gpu_id, AMDSMI_EVNT_XGMI_0_REQUEST_TX,
+                                   &counter_value)) {
+                fields->xgmi_neighbor0_tx_requests =
+                    counter_value.value;
             }
             break;
         case AGA_GPU_WATCH_ATTR_ID_XGMI_0_RESP_TX:
-            {
-                counter_key = reinterpret_cast<uint64_t>(gpu_handle) +
-                                  AMDSMI_EVNT_XGMI_0_RESPONSE_TX;
-                auto it = counter_handle_.find(counter_key);
-                if (it != counter_handle_.end()) {
-                    amdsmi_ret = amdsmi_gpu_read_counter(it->second,
-                                                         &counter_value);
-                    if (amdsmi_ret != AMDSMI_STATUS_SUCCESS) {
-                        break;
-                    }
-                    watch_db->watch_info[gpu_id].xgmi_neighbor0_tx_responses =
-                        counter_value.value;
-                }
+            if (xgmi_counter_read_(gpu_id, AMDSMI_EVNT_XGMI_0_RESPONSE_TX,
+                                   &counter_value)) {
+                fields->xgmi_neighbor0_tx_responses =
+                    counter_value.value;
             }
             break;
         case AGA_GPU_WATCH_ATTR_ID_XGMI_0_BEATS_TX:
-            {
-                counter_key = reinterpret_cast<uint64_t>(gpu_handle) +
-                                  AMDSMI_EVNT_XGMI_0_BEATS_TX;
-                auto it = counter_handle_.find(counter_key);
-                if (it != counter_handle_.end()) {
-                    amdsmi_ret = amdsmi_gpu_read_counter(it->second,
-                                                         &counter_value);
-                    if (amdsmi_ret != AMDSMI_STATUS_SUCCESS) {
-                        break;
-                    }
-                    watch_db->watch_info[gpu_id].xgmi_neighbor0_tx_beats =
-                        counter_value.value;
-                }
+            if (xgmi_counter_read_(gpu_id, AMDSMI_EVNT_XGMI_0_BEATS_TX,
+                                   &counter_value)) {
+                fields->xgmi_neighbor0_tx_beats =
+                    counter_value.value;
             }
             break;
         case AGA_GPU_WATCH_ATTR_ID_XGMI_1_NOP_TX:
-            {
-                counter_key = reinterpret_cast<uint64_t>(gpu_handle) +
-                                  AMDSMI_EVNT_XGMI_1_NOP_TX;
-                auto it = counter_handle_.find(counter_key);
-                if (it != counter_handle_.end()) {
-                    amdsmi_ret = amdsmi_gpu_read_counter(it->second,
-                                                         &counter_value);
-                    if (amdsmi_ret != AMDSMI_STATUS_SUCCESS) {
-                        break;
-                    }
-                    watch_db->watch_info[gpu_id].xgmi_neighbor1_tx_nops =
-                        counter_value.value;
-                }
+            if (xgmi_counter_read_(gpu_id, AMDSMI_EVNT_XGMI_1_NOP_TX,
+                                   &counter_value)) {
+                fields->xgmi_neighbor1_tx_nops =
+                    counter_value.value;
             }
             break;
         case AGA_GPU_WATCH_ATTR_ID_XGMI_1_REQ_TX:
-            {
-                counter_key = reinterpret_cast<uint64_t>(gpu_handle) +
-                                  AMDSMI_EVNT_XGMI_1_REQUEST_TX;
-                auto it = counter_handle_.find(counter_key);
-                if (it != counter_handle_.end()) {
-                    amdsmi_ret = amdsmi_gpu_read_counter(it->second,
-                                                         &counter_value);
-                    if (amdsmi_ret != AMDSMI_STATUS_SUCCESS) {
-                        break;
-                    }
-                    watch_db->watch_info[gpu_id].xgmi_neighbor1_tx_requests =
-                        counter_value.value;
-                }
+            if (xgmi_counter_read_(gpu_id, AMDSMI_EVNT_XGMI_1_REQUEST_TX,
+                                   &counter_value)) {
+                fields->xgmi_neighbor1_tx_requests =
+                    counter_value.value;
             }
             break;
         case AGA_GPU_WATCH_ATTR_ID_XGMI_1_RESP_TX:
-            {
-                counter_key = reinterpret_cast<uint64_t>(gpu_handle) +
-                                  AMDSMI_EVNT_XGMI_1_RESPONSE_TX;
-                auto it = counter_handle_.find(counter_key);
-                if (it != counter_handle_.end()) {
-                    amdsmi_ret = amdsmi_gpu_read_counter(it->second,
-                                                         &counter_value);
-                    if (amdsmi_ret != AMDSMI_STATUS_SUCCESS) {
-                        break;
-                    }
-                    watch_db->watch_info[gpu_id].xgmi_neighbor1_tx_responses =
-                        counter_value.value;
-                }
+            if (xgmi_counter_read_(gpu_id, AMDSMI_EVNT_XGMI_1_RESPONSE_TX,
+                                   &counter_value)) {
+                fields->xgmi_neighbor1_tx_responses =
+                    counter_value.value;
             }
             break;
         case AGA_GPU_WATCH_ATTR_ID_XGMI_1_BEATS_TX:
-            {
-                counter_key = reinterpret_cast<uint64_t>(gpu_handle) +
-                                  AMDSMI_EVNT_XGMI_1_BEATS_TX;
-                auto it = counter_handle_.find(counter_key);
-                if (it != counter_handle_.end()) {
-                    amdsmi_ret = amdsmi_gpu_read_counter(it->second,
-                                                         &counter_value);
-                    if (amdsmi_ret != AMDSMI_STATUS_SUCCESS) {
-                        break;
-                    }
-                    watch_db->watch_info[gpu_id].xgmi_neighbor1_tx_beats =
-                        counter_value.value;
-                }
+            if (xgmi_counter_read_(gpu_id, AMDSMI_EVNT_XGMI_1_BEATS_TX,
+                                   &counter_value)) {
+                fields->xgmi_neighbor1_tx_beats =
+                    counter_value.value;
             }
             break;
         case AGA_GPU_WATCH_ATTR_ID_XGMI_0_THRPUT:
-            {
-                counter_key = reinterpret_cast<uint64_t>(gpu_handle) +
-                                  AMDSMI_EVNT_XGMI_DATA_OUT_0;
-                auto it = counter_handle_.find(counter_key);
-                if (it != counter_handle_.end()) {
-                    amdsmi_ret = amdsmi_gpu_read_counter(it->second,
-                                                         &counter_value);
-                    if (amdsmi_ret != AMDSMI_STATUS_SUCCESS) {
-                        break;
-                    }
-                    time_sec =
-                        (double)(counter_value.time_running) / 1000000000.0;
-                    watch_db->watch_info[gpu_id].xgmi_neighbor0_tx_throughput =
-                        (counter_value.value * 32) / time_sec;
-                }
+            if (xgmi_counter_read_(gpu_id, AMDSMI_EVNT_XGMI_DATA_OUT_0,
+                                   &counter_value)) {
+                time_sec =
+                    (double)(counter_value.time_running) / 1000000000.0;
+                fields->xgmi_neighbor0_tx_throughput =
+                    (counter_value.value * 32) / time_sec;
             }
             break;
         case AGA_GPU_WATCH_ATTR_ID_XGMI_1_THRPUT:
-            {
-                counter_key = reinterpret_cast<uint64_t>(gpu_handle) +
-                                  AMDSMI_EVNT_XGMI_DATA_OUT_1;
-                auto it = counter_handle_.find(counter_key);
-                if (it != counter_handle_.end()) {
-                    amdsmi_ret = amdsmi_gpu_read_counter(it->second,
-                                                         &counter_value);
-                    if (amdsmi_ret != AMDSMI_STATUS_SUCCESS) {
-                        break;
-                    }
-                    time_sec =
-                        (double)(counter_value.time_running) / 1000000000.0;
-                    watch_db->watch_info[gpu_id].xgmi_neighbor1_tx_throughput =
-                        (counter_value.value * 32) / time_sec;
-                }
+            if (xgmi_counter_read_(gpu_id, AMDSMI_EVNT_XGMI_DATA_OUT_1,
+                                   &counter_value)) {
+                time_sec =
+                    (double)(counter_value.time_running) / 1000000000.0;
+                fields->xgmi_neighbor1_tx_throughput =
+                    (counter_value.value * 32) / time_sec;
             }
             break;
         case AGA_GPU_WATCH_ATTR_ID_XGMI_2_THRPUT:
-            {
-                counter_key = reinterpret_cast<uint64_t>(gpu_handle) +
-                                  AMDSMI_EVNT_XGMI_DATA_OUT_2;
-                auto it = counter_handle_.find(counter_key);
-                if (it != counter_handle_.end()) {
-                    amdsmi_ret = amdsmi_gpu_read_counter(it->second,
-                                                         &counter_value);
-                    if (amdsmi_ret != AMDSMI_STATUS_SUCCESS) {
-                        break;
-                    }
-                    time_sec =
-                        (double)(counter_value.time_running) / 1000000000.0;
-                    watch_db->watch_info[gpu_id].xgmi_neighbor2_tx_throughput =
-                        (counter_value.value * 32) / time_sec;
-                }
+            if (xgmi_counter_read_(gpu_id, AMDSMI_EVNT_XGMI_DATA_OUT_2,
+                                   &counter_value)) {
+                time_sec =
+                    (double)(counter_value.time_running) / 1000000000.0;
+                fields->xgmi_neighbor2_tx_throughput =
+                    (counter_value.value * 32) / time_sec;
             }
             break;
         case AGA_GPU_WATCH_ATTR_ID_XGMI_3_THRPUT:
-            {
-                counter_key = reinterpret_cast<uint64_t>(gpu_handle) +
-                                  AMDSMI_EVNT_XGMI_DATA_OUT_3;
-                auto it = counter_handle_.find(counter_key);
-                if (it != counter_handle_.end()) {
-                    amdsmi_ret = amdsmi_gpu_read_counter(it->second,
-                                                         &counter_value);
-                    if (amdsmi_ret != AMDSMI_STATUS_SUCCESS) {
-                        break;
-                    }
-                    time_sec =
-                        (double)(counter_value.time_running) / 1000000000.0;
-                    watch_db->watch_info[gpu_id].xgmi_neighbor3_tx_throughput =
-                        (counter_value.value * 32) / time_sec;
-                }
+            if (xgmi_counter_read_(gpu_id, AMDSMI_EVNT_XGMI_DATA_OUT_3,
+                                   &counter_value)) {
+                time_sec =
+                    (double)(counter_value.time_running) / 1000000000.0;
+                fields->xgmi_neighbor3_tx_throughput =
+                    (counter_value.value * 32) / time_sec;
             }
             break;
         case AGA_GPU_WATCH_ATTR_ID_XGMI_4_THRPUT:
-            {
-                counter_key = reinterpret_cast<uint64_t>(gpu_handle) +
-                                  AMDSMI_EVNT_XGMI_DATA_OUT_4;
-                auto it = counter_handle_.find(counter_key);
-                if (it != counter_handle_.end()) {
-                    amdsmi_ret = amdsmi_gpu_read_counter(it->second,
-                                                         &counter_value);
-                    if (amdsmi_ret != AMDSMI_STATUS_SUCCESS) {
-                        break;
-                    }
-                    time_sec =
-                        (double)(counter_value.time_running) / 1000000000.0;
-                    watch_db->watch_info[gpu_id].xgmi_neighbor4_tx_throughput =
-                        (counter_value.value * 32) / time_sec;
-                }
+            if (xgmi_counter_read_(gpu_id, AMDSMI_EVNT_XGMI_DATA_OUT_4,
+                                   &counter_value)) {
+                time_sec =
+                    (double)(counter_value.time_running) / 1000000000.0;
+                fields->xgmi_neighbor4_tx_throughput =
+                    (counter_value.value * 32) / time_sec;
             }
             break;
         case AGA_GPU_WATCH_ATTR_ID_XGMI_5_THRPUT:
-            {
-                counter_key = reinterpret_cast<uint64_t>(gpu_handle) +
-                                  AMDSMI_EVNT_XGMI_DATA_OUT_5;
-                auto it = counter_handle_.find(counter_key);
-                if (it != counter_handle_.end()) {
-                    amdsmi_ret = amdsmi_gpu_read_counter(it->second,
-                                                         &counter_value);
-                    if (amdsmi_ret != AMDSMI_STATUS_SUCCESS) {
-                        break;
-                    }
-                    time_sec =
-                        (double)(counter_value.time_running) / 1000000000.0;
-                    watch_db->watch_info[gpu_id].xgmi_neighbor5_tx_throughput =
-                        (counter_value.value * 32) / time_sec;
-                }
+            if (xgmi_counter_read_(gpu_id, AMDSMI_EVNT_XGMI_DATA_OUT_5,
+                                   &counter_value)) {
+                time_sec =
+                    (double)(counter_value.time_running) / 1000000000.0;
+                fields->xgmi_neighbor5_tx_throughput =
+                    (counter_value.value * 32) / time_sec;
             }
             break;
         default:
@@ -684,13 +770,124 @@ smi_state::smi_watcher_update_all_watch_fields_(uint32_t gpu_id,
     return SDK_RET_OK;
 }
 
+sdk_ret_t
+smi_state::gpu_watch_fields_read(uint32_t gpu_id,
+                                 const aga_gpu_watch_attr_set_t& attrs,
+                                 aga_gpu_watch_fields_t *fields) {
+    if (unlikely(gpu_id >= num_gpu_)) {
+        return SDK_RET_INVALID_ARG;
+    }
+    // serve the cached reads as long as they are fresh enough
+    return smi_watcher_update_all_watch_fields_(gpu_id,
+                                                gpu_slot_[gpu_id].handle,
+                                                attrs, false, fields);
+}
+
+sdk_ret_t
+smi_state::watcher_update_gpu_watch_fields(uint32_t gpu_id,
+                                           aga_gpu_watch_db_t *watch_db) {
+    sdk_ret_t ret;
+    uint64_t latency, mono_ns, wall_ns;
+    timespec_t start_ts, end_ts, diff_ts, wall_ts;
+    aga_gpu_watch_fields_t *fields = &watch_db->watch_info[gpu_id];
+
+    if (watcher_due_attrs_[gpu_id].none()) {
+        // nothing to sample on this GPU in this tick
+        return SDK_RET_OK;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &start_ts);
+    clock_gettime(CLOCK_REALTIME, &wall_ts);
+    ret = smi_watcher_update_all_watch_fields_(gpu_id,
+                                               gpu_slot_[gpu_id].handle,
+                                               watcher_due_attrs_[gpu_id],
+                                               true, fields);
+    clock_gettime(CLOCK_MONOTONIC, &end_ts);
+    diff_ts = sdk::timestamp_diff(&end_ts, &start_ts);
+    sdk::timestamp_to_nsecs(&diff_ts, &latency);
+    latency /= TIME_NSECS_PER_USEC;
+    // stash the capture time and collection latency along with the fields
+    // they apply to
+    sdk::timestamp_to_nsecs(&start_ts, &mono_ns);
+    sdk::timestamp_to_nsecs(&wall_ts, &wall_ns);
+    fields->collection_latency = latency;
+    fields->capture_mono_ns = mono_ns;
+    fields->capture_wall_ns = wall_ns;
+    for (uint32_t attr = 0; attr < AGA_GPU_WATCH_ATTRS_MAX; attr++) {
+        if (watcher_due_attrs_[gpu_id].test(attr)) {
+            fields->attr_capture_ns[attr] = mono_ns;
+            fields->attr_collection_latency[attr] = latency;
+        }
+    }
+    if (unlikely(latency >= ((uint64_t)g_watch_timer_interval *
+                                 TIME_USECS_PER_MSEC))) {
+        AGA_TRACE_DEBUG("Watch fields collection on GPU {} took {} usecs",
+                        gpu_slot_[gpu_id].handle, latency);
+    }
+    if (likely(ret == SDK_RET_OK)) {
+        // remember the sampled values for time range queries
+        g_gpu_watch_history.record(gpu_id, *fields, watcher_due_attrs_[gpu_id],
+                                   wall_ns / TIME_NSECS_PER_MSEC);
+    }
+    return ret;
+}
+
+/// \brief    context shared by all the watcher workers in a given tick
+typedef struct watcher_work_ctxt_s {
+    /// next GPU to be sampled
+    uint32_t next_gpu;
+    /// no. of GPUs to be sampled
+    uint32_t num_gpu;
+    /// db to be updated
+    aga_gpu_watch_db_t *watch_db;
+} watcher_work_ctxt_t;
+
+/// \brief    watcher worker callback, keeps picking the next GPU that is not
+///           sampled yet so that one slow GPU doesn't hold up the others
+/// \param[in] arg    watcher work context
+/// \return SDK_RET_OK or error status in case of failure
+static sdk_ret_t
+watcher_work_cb_ (void *arg)
+{
+    uint32_t gpu;
+    watcher_work_ctxt_t *ctxt = (watcher_work_ctxt_t *)arg;
+
+    while ((gpu = SDK_ATOMIC_FETCH_ADD(&ctxt->next_gpu, 1)) < ctxt->num_gpu) {
+        g_smi_state.watcher_update_gpu_watch_fields(gpu, ctxt->watch_db);
+    }
+    return SDK_RET_OK;
+}
+
 sdk_ret_t
 smi_state::watcher_update_watch_db(aga_gpu_watch_db_t *watch_db) {
-    // loop through all gpu devices
-    for (uint32_t gpu = 0; gpu < num_gpu_; gpu++) {
-        // update watch db
-        smi_watcher_update_all_watch_fields_(gpu, gpu_handles_[gpu], watch_db);
+    timespec_t now_ts;
+    uint64_t now_ns;
+    sdk::lib::work_barrier barrier;
+    watcher_work_ctxt_t work_ctxt;
+
+    // figure out what is due for sampling on each GPU in this tick
+    clock_gettime(CLOCK_MONOTONIC, &now_ts);
+    sdk::timestamp_to_nsecs(&now_ts, &now_ns);
+    g_gpu_watch_sched.due_attrs(now_ns / TIME_NSECS_PER_MSEC, num_gpu_,
+                                watcher_due_attrs_);
+    if (unlikely(watcher_tpool_ == NULL)) {
+        // loop through all gpu devices
+        for (uint32_t gpu = 0; gpu < num_gpu_; gpu++) {
+            // update watch db
+            watcher_update_gpu_watch_fields(gpu, watch_db);
+        }
+        return SDK_RET_OK;
+    }
+    // fan out the collection across the workers and wait for all of them
+    // to finish before the db is published
+    work_ctxt.next_gpu = 0;
+    work_ctxt.num_gpu = num_gpu_;
+    work_ctxt.watch_db = watch_db;
+    watcher_tpool_->barrier_init(&barrier, watcher_num_workers_);
+    for (uint32_t w = 0; w < watcher_num_workers_; w++) {
+        watcher_tpool_->work_post(watcher_work_cb_, &work_ctxt, w,
+                                  NULL, &barrier);
     }
+    watcher_tpool_->barrier_wait(&barrier);
     return SDK_RET_OK;
 }
 
@@ -708,8 +905,13 @@ smi_state::cleanup_gpu_watch_inactive_subscribers_(
         subscriber = *it;
         auto& client_info =
             gpu_watch_subscriber_db_.gpu_watch_map[subscriber.gpu_watch_id];
-        // erase the client
+        // erase the client, and the watch along with its aggregation window
+        // once the last client is gone
         client_info.client_set.erase(subscriber.client_ctxt);
+        if (client_info.client_set.empty()) {
+            gpu_watch_subscriber_db_.gpu_watch_map.erase(
+                subscriber.gpu_watch_id);
+        }
 
         // post task to API thread to decrement subscriber refcount
 
@@ -732,14 +934,12 @@ smi_state::cleanup_gpu_watch_inactive_subscribers_(
 
     for (auto it = client_set.begin(); it!= client_set.end(); it++) {
         client_ctxt = *it;
-        // wakeup the front end thread so it can exit
-        client_ctxt->client_inactive = true;
-        AGA_TRACE_INFO("Signaling frontend gRPC thread to quit, client {}, "
-                       "client ctxt {}, stream {}",
+        // close the stream and release the client context
+        AGA_TRACE_INFO("Closing inactive client {}, client ctxt {}, stream {}",
                        client_ctxt->client.c_str(),
                        (void *)client_ctxt,
                        client_ctxt->stream);
-        pthread_cond_signal(&client_ctxt->cond);
+        aga_gpu_watch_client_ctxt_release(client_ctxt);
     }
     return SDK_RET_OK;
 }
@@ -747,24 +947,87 @@ smi_state::cleanup_gpu_watch_inactive_subscribers_(
 sdk_ret_t
 smi_state::gpu_watch_notify_subscribers(void) {
     sdk_ret_t ret;
+    uint64_t now_ns;
     aga_obj_key_t key;
+    timespec_t now_ts;
     aga_gpu_watch_info_t info;
+    aga_gpu_watch_info_t delta_info;
+    gpu_watch_delta_result_t delta_ret;
+    aga_gpu_watch_update_t update, delta_update;
     aga_gpu_watch_client_ctxt_t *client_ctxt;
     gpu_watch_subscriber_info_t inactive_subscriber;
     vector<gpu_watch_subscriber_info_t> inactive_subscribers;
 
+    clock_gettime(CLOCK_MONOTONIC, &now_ts);
+    sdk::timestamp_to_nsecs(&now_ts, &now_ns);
     for (auto& it : gpu_watch_subscriber_db_.gpu_watch_map) {
         key = it.first;
         auto& client_info = it.second;
 
+        if (client_info.client_set.empty()) {
+            // nobody to publish to
+            continue;
+        }
+        // each watch is published at its own sampling interval
+        if (!g_gpu_watch_sched.watch_due(key, now_ns / TIME_NSECS_PER_MSEC)) {
+            continue;
+        }
+
         AGA_TRACE_VERBOSE("GPU watch {} notify subscribers", key.str());
-        memset(&info, 0, sizeof(aga_gpu_watch_info_t));
-        aga_gpu_watch_read(&key, &info);
+        // NOTE: info is reused across watches so the stats storage sized
+        //       for the previous watch gets reused as well
+        ret = aga_gpu_watch_read(&key, &info);
+        if (unlikely(ret != SDK_RET_OK)) {
+            // watch is being operated upon, catch up in next interval
+            continue;
+        }
+        if (info.spec.agg_window) {
+            // fold the samples into the window, publish once it is complete
+            client_info.agg.add(info.spec, info.stats);
+            if (!client_info.agg.window_done()) {
+                continue;
+            }
+            client_info.agg.fill(&info.stats);
+        }
+        // all subscribers of this watch share one encoded update
+        update.info = &info;
+        update.delta = false;
+        update.encoded = NULL;
+        update.encoded_free_cb = NULL;
         for (auto client_set_it = client_info.client_set.begin();
              client_set_it != client_info.client_set.end();
              client_set_it++) {
              client_ctxt = *client_set_it;
-            ret = client_ctxt->write_cb(&info, client_ctxt);
+            if (client_ctxt->changes_only) {
+                // NOTE: delta_info is reused across subscribers so the stats
+                //       storage gets reused as well
+                delta_ret = client_ctxt->delta[key].filter(info,
+                                now_ns / TIME_NSECS_PER_MSEC,
+                                client_ctxt->keyframe_interval,
+                                client_ctxt->deadband, &delta_info);
+                if (delta_ret == GPU_WATCH_DELTA_NONE) {
+                    // nothing changed since the last update sent
+                    continue;
+                } else if (delta_ret == GPU_WATCH_DELTA_CHANGES) {
+                    // changes are specific to this subscriber, so is the
+                    // encoded update
+                    delta_update.info = &delta_info;
+                    delta_update.delta = true;
+                    delta_update.encoded = NULL;
+                    delta_update.encoded_free_cb = NULL;
+                    ret = client_ctxt->write_cb(&delta_update, client_ctxt);
+                    if (delta_update.encoded) {
+                        delta_update.encoded_free_cb(delta_update.encoded);
+                    }
+                    if (unlikely(ret != SDK_RET_OK)) {
+                        inactive_subscriber.gpu_watch_id = info.spec.key;
+                        inactive_subscriber.client_ctxt = client_ctxt;
+                        inactive_subscribers.push_back(inactive_subscriber);
+                    }
+                    continue;
+                }
+            }
+            ret = client_ctxt->write_cb(&update, client_ctxt);
             if (unlikely(ret != SDK_RET_OK)) {
                 // add to list of clients not reachable
                 inactive_subscriber.gpu_watch_id = info.spec.key;
@@ -772,6 +1035,9 @@ smi_state::gpu_watch_notify_subscribers(void) {
                 inactive_subscribers.push_back(inactive_subscriber);
             }
         }
+        if (update.encoded) {
+            update.encoded_free_cb(update.encoded);
+        }
     }
     cleanup_gpu_watch_inactive_subscribers_(inactive_subscribers);
     return SDK_RET_OK;
@@ -780,26 +1046,39 @@ smi_state::gpu_watch_notify_subscribers(void) {
 static void
 watch_timer_cb_ (event::timer_t *timer)
 {
-    sdk_ret_t ret;
-    aga_task_spec_t task_spec = {};
-    static uint16_t timer_ticks = 0;
-
-    // get latest values of all watch fields
-    g_smi_state.watcher_update_watch_db(&task_spec.watch_db);
-
-    // post task to api thread
-    task_spec.task = AGA_TASK_GPU_WATCH_DB_UPDATE;
-    ret = aga_task_create(&task_spec);
-    if (unlikely(ret != SDK_RET_OK)) {
-        AGA_TRACE_ERR("Failed to create GPU watch db update task, err {}",
-                      ret());
+    uint32_t interval;
+    uint64_t now_ns;
+    timespec_t now_ts;
+    aga_gpu_watch_db_t *watch_db;
+
+    // get latest values of all watch fields directly into a free snapshot
+    // buffer and publish it, readers pick it up without any copies
+    watch_db = g_gpu_watch_snapshot.writer_begin(g_smi_state.num_gpu());
+    if (likely(watch_db != NULL)) {
+        g_smi_state.watcher_update_watch_db(watch_db);
+        g_gpu_watch_snapshot.writer_publish(watch_db);
+    } else {
+        AGA_TRACE_ERR("No free GPU watch snapshot buffer, skipping update");
     }
-    // notify the gpu watch subscribers with latest stats once in every
-    // <AGA_WATCHER_GPU_WATCH_UPDATE_FREQ> seconds
-    timer_ticks += uint16_t(AGA_WATCHER_INTERVAL);
-    if (timer_ticks >= AGA_WATCHER_GPU_WATCH_UPDATE_FREQ) {
-        timer_ticks = 0;
-        g_smi_state.gpu_watch_notify_subscribers();
+    // notify the gpu watch subscribers whose watches are due
+    g_smi_state.gpu_watch_notify_subscribers();
+    // age out the history of the attributes that are not sampled anymore
+    clock_gettime(CLOCK_REALTIME, &now_ts);
+    sdk::timestamp_to_nsecs(&now_ts, &now_ns);
+    g_gpu_watch_history.sweep(now_ns / TIME_NSECS_PER_MSEC);
+    // follow the sampling intervals as the watches come and go, and slow
+    // down to the default interval once nothing needs sampling
+    interval = g_gpu_watch_sched.tick_interval();
+    if (interval == 0) {
+        interval = AGA_WATCHER_INTERVAL * TIME_MSECS_PER_SEC;
+    }
+    if (interval != g_watch_timer_interval) {
+        AGA_TRACE_DEBUG("Watch timer interval changing from {}ms to {}ms",
+                        g_watch_timer_interval, interval);
+        g_watch_timer_interval = interval;
+        event::timer_stop(timer);
+        event::timer_set(timer, interval / 1000.0, interval / 1000.0);
+        event::timer_start(timer);
     }
 }
 
@@ -887,174 +1166,101 @@ gpu_create_counter_ (amdsmi_processor_handle gpu_handle,
 sdk_ret_t
 smi_state::watcher_init(void) {
     uint32_t counters;
-    uint64_t counter_key;
     sdk_ret_t ret = SDK_RET_OK;
     amdsmi_status_t amdsmi_ret;
+    aga_gpu_handle_t gpu_handle;
     amdsmi_event_handle_t counter_handle;
 
     // initialize watch field list
     smi_watch_field_list_init();
+    smi_watch_field_offset_init();
+    smi_watch_field_deps_init();
+    // nothing is sampled until a watch is created or the GPU stats or the
+    // watch history are read, see gpu_watch_sched
+
+    // create the worker pool to sample GPUs in parallel
+    if (num_gpu_ > 1) {
+        watcher_num_workers_ = (num_gpu_ < AGA_WATCHER_MAX_WORKERS) ?
+                                   num_gpu_ : AGA_WATCHER_MAX_WORKERS;
+        watcher_tpool_ = sdk::lib::thread_pool::factory(watcher_num_workers_,
+                                                        0, false);
+        if (watcher_tpool_ == NULL) {
+            AGA_TRACE_ERR("Failed to create watcher worker pool, GPUs will "
+                          "be sampled serially");
+            watcher_num_workers_ = 0;
+        }
+    }
 
     // create counters for xgmi stats
     for (uint32_t gpu = 0; gpu < num_gpu_; gpu++) {
+        gpu_handle = gpu_slot_[gpu].handle;
         // check if xgmi counter groups are supported
-        amdsmi_ret = amdsmi_gpu_counter_group_supported(gpu_handles_[gpu],
+        amdsmi_ret = amdsmi_gpu_counter_group_supported(gpu_handle,
                                                         AMDSMI_EVNT_GRP_XGMI);
         if (amdsmi_ret != AMDSMI_STATUS_SUCCESS) {
             AGA_TRACE_ERR("XGMI counter group not supported on GPU {}, ret {}",
-                          gpu_handles_[gpu], amdsmi_ret);
+                          gpu_handle, amdsmi_ret);
             continue;
         }
         // check if atleast 8 counters are available for XGMI coutner group
-        amdsmi_ret = amdsmi_get_gpu_available_counters(gpu_handles_[gpu],
+        amdsmi_ret = amdsmi_get_gpu_available_counters(gpu_handle,
                                                        AMDSMI_EVNT_GRP_XGMI,
                                                        &counters);
         if (amdsmi_ret != AMDSMI_STATUS_SUCCESS) {
             AGA_TRACE_ERR("Counters unavailable for XGMI counter group on "
-                          "GPU {}, ret {}", gpu_handles_[gpu], amdsmi_ret);
+                          "GPU {}, ret {}", gpu_handle, amdsmi_ret);
             continue;
         } else if (counters < 8) {
             AGA_TRACE_ERR("Only {} counters available for XGMI on GPU {}, "
-                          "require {} counters", counters, gpu_handles_[gpu],
-                          8);
+                          "require {} counters", counters, gpu_handle, 8);
             continue;
         }
         // create XGMI counters
-        ret = gpu_create_counter_(gpu_handles_[gpu], AMDSMI_EVNT_XGMI_0_NOP_TX,
-                                  &counter_handle);
-        if (ret == SDK_RET_OK) {
-            counter_key = reinterpret_cast<uint64_t>(gpu_handles_[gpu]) +
-                              AMDSMI_EVNT_XGMI_0_NOP_TX;
-            counter_handle_[counter_key] = counter_handle;
-        }
-        ret = gpu_create_counter_(gpu_handles_[gpu],
-                                  AMDSMI_EVNT_XGMI_0_REQUEST_TX,
-                                  &counter_handle);
-        if (ret == SDK_RET_OK) {
-            counter_key = reinterpret_cast<uint64_t>(gpu_handles_[gpu]) +
-                              AMDSMI_EVNT_XGMI_0_REQUEST_TX;
-            counter_handle_[counter_key] = counter_handle;
-        }
-        ret = gpu_create_counter_(gpu_handles_[gpu],
-                                  AMDSMI_EVNT_XGMI_0_RESPONSE_TX,
-                                  &counter_handle);
-        if (ret == SDK_RET_OK) {
-            counter_key = reinterpret_cast<uint64_t>(gpu_handles_[gpu]) +
-                              AMDSMI_EVNT_XGMI_0_RESPONSE_TX;
-            counter_handle_[counter_key] = counter_handle;
-        }
-        ret = gpu_create_counter_(gpu_handles_[gpu],
-                                  AMDSMI_EVNT_XGMI_0_BEATS_TX,
-                                  &counter_handle);
-        if (ret == SDK_RET_OK) {
-            counter_key = reinterpret_cast<uint64_t>(gpu_handles_[gpu]) +
-                              AMDSMI_EVNT_XGMI_0_BEATS_TX;
-            counter_handle_[counter_key] = counter_handle;
-        }
-        ret = gpu_create_counter_(gpu_handles_[gpu], AMDSMI_EVNT_XGMI_1_NOP_TX,
-                                  &counter_handle);
-        if (ret == SDK_RET_OK) {
-            counter_key = reinterpret_cast<uint64_t>(gpu_handles_[gpu]) +
-                              AMDSMI_EVNT_XGMI_1_NOP_TX;
-            counter_handle_[counter_key] = counter_handle;
-        }
-        ret = gpu_create_counter_(gpu_handles_[gpu],
-                                  AMDSMI_EVNT_XGMI_1_REQUEST_TX,
-                                  &counter_handle);
-        if (ret == SDK_RET_OK) {
-            counter_key = reinterpret_cast<uint64_t>(gpu_handles_[gpu]) +
-                              AMDSMI_EVNT_XGMI_1_REQUEST_TX;
-            counter_handle_[counter_key] = counter_handle;
-        }
-        ret = gpu_create_counter_(gpu_handles_[gpu],
-                                  AMDSMI_EVNT_XGMI_1_RESPONSE_TX,
-                                  &counter_handle);
-        if (ret == SDK_RET_OK) {
-            counter_key = reinterpret_cast<uint64_t>(gpu_handles_[gpu]) +
-                              AMDSMI_EVNT_XGMI_1_RESPONSE_TX;
-            counter_handle_[counter_key] = counter_handle;
-        }
-        ret = gpu_create_counter_(gpu_handles_[gpu],
-                                  AMDSMI_EVNT_XGMI_1_BEATS_TX,
-                                  &counter_handle);
-        if (ret == SDK_RET_OK) {
-            counter_key = reinterpret_cast<uint64_t>(gpu_handles_[gpu]) +
-                              AMDSMI_EVNT_XGMI_1_BEATS_TX;
-            counter_handle_[counter_key] = counter_handle;
+        for (uint32_t evt = AMDSMI_EVNT_XGMI_FIRST;
+             evt <= AMDSMI_EVNT_XGMI_LAST; evt++) {
+            ret = gpu_create_counter_(gpu_handle, (amdsmi_event_type_t)evt,
+                                      &counter_handle);
+            if (ret == SDK_RET_OK) {
+                gpu_slot_[gpu].xgmi_counter[
+                    xgmi_counter_idx_((amdsmi_event_type_t)evt)] =
+                        counter_handle;
+            }
         }
     }
     // create counters for xgmi throughput stats
     for (uint32_t gpu = 0; gpu < num_gpu_; gpu++) {
+        gpu_handle = gpu_slot_[gpu].handle;
         // check if xgmi counter groups are supported
-        amdsmi_ret = amdsmi_gpu_counter_group_supported(gpu_handles_[gpu],
+        amdsmi_ret = amdsmi_gpu_counter_group_supported(gpu_handle,
                          AMDSMI_EVNT_GRP_XGMI_DATA_OUT);
         if (amdsmi_ret != AMDSMI_STATUS_SUCCESS) {
             AGA_TRACE_ERR("XGMI throughput counter group not supported on "
-                          "GPU {}, ret {}", gpu_handles_[gpu], amdsmi_ret);
+                          "GPU {}, ret {}", gpu_handle, amdsmi_ret);
             continue;
         }
         // check if atleast 6 counters are available for XGMI coutner group
-        amdsmi_ret = amdsmi_get_gpu_available_counters(gpu_handles_[gpu],
+        amdsmi_ret = amdsmi_get_gpu_available_counters(gpu_handle,
                          AMDSMI_EVNT_GRP_XGMI_DATA_OUT, &counters);
         if (amdsmi_ret != AMDSMI_STATUS_SUCCESS) {
             AGA_TRACE_ERR("Counters unavailable for XGMI throughput counter "
-                          "group on GPU {}, ret {}", gpu_handles_[gpu],
-                          amdsmi_ret);
+                          "group on GPU {}, ret {}", gpu_handle, amdsmi_ret);
             continue;
         } else if (counters < 6) {
             AGA_TRACE_ERR("Only {} counters available for XGMI throughput on "
                           "GPU {}, require {} counters", counters,
-                          gpu_handles_[gpu], 6);
+                          gpu_handle, 6);
             continue;
         }
         // create XGMI throughput counters
-        ret = gpu_create_counter_(gpu_handles_[gpu],
-                                  AMDSMI_EVNT_XGMI_DATA_OUT_0,
-                                  &counter_handle);
-        if (ret == SDK_RET_OK) {
-            counter_key = reinterpret_cast<uint64_t>(gpu_handles_[gpu]) +
-                              AMDSMI_EVNT_XGMI_DATA_OUT_0;
-            counter_handle_[counter_key] = counter_handle;
-        }
-        ret = gpu_create_counter_(gpu_handles_[gpu],
-                                  AMDSMI_EVNT_XGMI_DATA_OUT_1,
-                                  &counter_handle);
-        if (ret == SDK_RET_OK) {
-            counter_key = reinterpret_cast<uint64_t>(gpu_handles_[gpu]) +
-                              AMDSMI_EVNT_XGMI_DATA_OUT_1;
-            counter_handle_[counter_key] = counter_handle;
-        }
-        ret = gpu_create_counter_(gpu_handles_[gpu],
-                                  AMDSMI_EVNT_XGMI_DATA_OUT_2,
-                                  &counter_handle);
-        if (ret == SDK_RET_OK) {
-            counter_key = reinterpret_cast<uint64_t>(gpu_handles_[gpu]) +
-                              AMDSMI_EVNT_XGMI_DATA_OUT_2;
-            counter_handle_[counter_key] = counter_handle;
-        }
-        ret = gpu_create_counter_(gpu_handles_[gpu],
-                                  AMDSMI_EVNT_XGMI_DATA_OUT_3,
-                                  &counter_handle);
-        if (ret == SDK_RET_OK) {
-            counter_key = reinterpret_cast<uint64_t>(gpu_handles_[gpu]) +
-                              AMDSMI_EVNT_XGMI_DATA_OUT_3;
-            counter_handle_[counter_key] = counter_handle;
-        }
-        ret = gpu_create_counter_(gpu_handles_[gpu],
-                                  AMDSMI_EVNT_XGMI_DATA_OUT_4,
-                                  &counter_handle);
-        if (ret == SDK_RET_OK) {
-            counter_key = reinterpret_cast<uint64_t>(gpu_handles_[gpu]) +
-                              AMDSMI_EVNT_XGMI_DATA_OUT_4;
-            counter_handle_[counter_key] = counter_handle;
-        }
-        ret = gpu_create_counter_(gpu_handles_[gpu],
-                                  AMDSMI_EVNT_XGMI_DATA_OUT_5,
-                                  &counter_handle);
-        if (ret == SDK_RET_OK) {
-            counter_key = reinterpret_cast<uint64_t>(gpu_handles_[gpu]) +
-                              AMDSMI_EVNT_XGMI_DATA_OUT_5;
-            counter_handle_[counter_key] = counter_handle;
+        for (uint32_t evt = AMDSMI_EVNT_XGMI_DATA_OUT_FIRST;
+             evt <= AMDSMI_EVNT_XGMI_DATA_OUT_LAST; evt++) {
+            ret = gpu_create_counter_(gpu_handle, (amdsmi_event_type_t)evt,
+                                      &counter_handle);
+            if (ret == SDK_RET_OK) {
+                gpu_slot_[gpu].xgmi_counter[
+                    xgmi_counter_idx_((amdsmi_event_type_t)evt)] =
+                        counter_handle;
+            }
         }
     }
     return ret;
@@ -1069,7 +1275,9 @@ watcher_thread_init_ (void *ctxt)
     // register for gpu watch subscribe messages
     sdk::ipc::reg_request_handler(AGA_IPC_MSG_ID_GPU_WATCH_SUBSCRIBE,
                                   gpu_watch_subscribe_ipc_cb_, NULL);
-    // start watch timer
+    // start watch timer, it is re-armed as per the sampling intervals of the
+    // watches once the watcher starts ticking
+    g_watch_timer_interval = AGA_WATCHER_INTERVAL * TIME_MSECS_PER_SEC;
     event::timer_init(&watch_timer, watch_timer_cb_,
                       AGA_WATCHER_START_DELAY, AGA_WATCHER_INTERVAL);
     event::timer_start(&watch_timer);
@@ -1099,45 +1307,58 @@ smi_state::spawn_watcher_thread_(void) {
 
 sdk_ret_t
 smi_state::event_monitor_init(void) {
+    sdk_ret_t ret;
     amdsmi_status_t status;
-    gpu_event_record_t null_event_record = {};
 
+    // create the pipe events are handed over on to this thread
+    ret = event_pipe_.init(sizeof(amdsmi_evt_notification_data_t));
+    if (unlikely(ret != SDK_RET_OK)) {
+        AGA_TRACE_ERR("Failed to create event pipe, err {}", ret());
+        return ret;
+    }
     // initialize the s/w state
     for (uint32_t d = 0; d < num_gpu_; d++) {
-        SDK_SPINLOCK_INIT(&gpu_event_db_[gpu_handles_[d]].slock,
-                          PTHREAD_PROCESS_SHARED);
+        gpu_slot_[d].event_db.history.init(AGA_GPU_EVENT_HISTORY_DEPTH);
     }
     // initialize event monitoring for all the devices
     for (uint32_t d = 0; d < num_gpu_; d++) {
         // initialize the event monitoring for the 1st time for all devices
-        status = amdsmi_init_gpu_event_notification(gpu_handles_[d]);
+        status = amdsmi_init_gpu_event_notification(gpu_slot_[d].handle);
         if (unlikely(status != AMDSMI_STATUS_SUCCESS)) {
             AGA_TRACE_ERR("Failed to do event notification initialization, "
-                          "GPU {}, err {}", gpu_handles_[d], status);
+                          "GPU {}, err {}", gpu_slot_[d].handle, status);
             return amdsmi_ret_to_sdk_ret(status);
         }
-        status = amdsmi_set_gpu_event_notification_mask(gpu_handles_[d],
+        status = amdsmi_set_gpu_event_notification_mask(gpu_slot_[d].handle,
                                                         AMDSMI_EVENT_MASK_ALL);
         if (unlikely(status != AMDSMI_STATUS_SUCCESS)) {
             AGA_TRACE_ERR("Failed to set event notification mask, "
-                          "GPU {}, err {}", gpu_handles_[d], status);
+                          "GPU {}, err {}", gpu_slot_[d].handle, status);
             return amdsmi_ret_to_sdk_ret(status);
         }
     }
-    return SDK_RET_OK;
+    // start waiting for the events
+    return spawn_event_reader_thread_();
 }
 
 sdk_ret_t
 smi_state::event_monitor_cleanup(void) {
-    // stop monitoring
+    // stop monitoring, the reader notices the stop request within one poll
+    // timeout; wait for it to exit so that it is not inside the amdsmi event
+    // read when the notifications are torn down below
+    if (event_reader_thread_) {
+        event_reader_stop_.store(true, std::memory_order_release);
+        event_reader_thread_->wait_until_complete();
+        event_reader_thread_->set_running(false);
+        sdk::lib::thread::destroy(event_reader_thread_);
+        event_reader_thread_ = NULL;
+    }
     for (uint32_t d = 0; d < num_gpu_; d++) {
-        amdsmi_stop_gpu_event_notification(gpu_handles_[d]);
+        amdsmi_stop_gpu_event_notification(gpu_slot_[d].handle);
     }
     // cleanup the event state
-    for (uint32_t d = 0; d < AGA_MAX_GPU; d++) {
-        SDK_SPINLOCK_LOCK(&gpu_event_db_[gpu_handles_[d]].slock);
-        gpu_event_db_[gpu_handles_[d]].event_map.clear();
-        SDK_SPINLOCK_UNLOCK(&gpu_event_db_[gpu_handles_[d]].slock);
+    for (uint32_t d = 0; d < num_gpu_; d++) {
+        gpu_slot_[d].event_db.subscribers.clear();
     }
     return SDK_RET_OK;
 }
@@ -1160,30 +1381,19 @@ smi_state::cleanup_event_listeners_(
         // will eventually lead to agent crash
 
         for (uint32_t d = 0; d < num_gpu_; d++) {
-            // lock the event state for this device
-            SDK_SPINLOCK_LOCK(&gpu_event_db_[gpu_handles_[d]].slock);
-            for (uint32_t e = (AGA_EVENT_ID_NONE + 1); e <= AGA_EVENT_ID_MAX;
-                 e++) {
-                auto& event_record =
-                    gpu_event_db_[gpu_handles_[d]].event_map[(aga_event_id_t)e];
-                // erase the client
-                event_record.client_info.client_set.erase(listener.client_ctxt);
-            }
-            // unlock the event state for this device
-            SDK_SPINLOCK_UNLOCK(&gpu_event_db_[gpu_handles_[d]].slock);
+            // erase the client from all the events of this device
+            gpu_slot_[d].event_db.subscribers.remove(listener.client_ctxt);
         }
         client_set.insert(listener.client_ctxt);
     }
     for (auto it = client_set.begin(); it!= client_set.end(); it++) {
         client_ctxt = *it;
-        // wakeup the front end thread so it can exit
-        client_ctxt->client_inactive = true;
-        AGA_TRACE_INFO("Signaling frontend gRPC thread to quit, client {}, "
-                       "client ctxt {}, stream {}",
+        // close the stream and release the client context
+        AGA_TRACE_INFO("Closing inactive client {}, client ctxt {}, stream {}",
                        client_ctxt->client.c_str(),
                        (void *)client_ctxt,
                        client_ctxt->stream);
-        pthread_cond_signal(&client_ctxt->cond);
+        aga_event_client_ctxt_release(client_ctxt);
     }
     return SDK_RET_OK;
 }
@@ -1193,9 +1403,10 @@ smi_state::handle_events(uint32_t num_events, void *event_buffer_) {
     sdk_ret_t ret;
     timespec_t ts;
     gpu_entry *gpu;
-    aga_event_t event = {};
+    aga_event_t event;
     aga_event_id_t event_id;
     amdsmi_processor_handle gpu_handle;
+    gpu_event_history_record_t history_record;
     aga_event_client_ctxt_t *client_ctxt;
     aga_event_listener_info_t inactive_listener;
     amdsmi_evt_notification_data_t *event_buffer;
@@ -1212,41 +1423,43 @@ smi_state::handle_events(uint32_t num_events, void *event_buffer_) {
             continue;
         }
         event_id = aga_event_id_from_smi_event_id(event_buffer[i].event);
-        auto& event_map = gpu_event_db_[gpu_handle].event_map;
-
-        // lock the event state for this device
-        SDK_SPINLOCK_LOCK(&gpu_event_db_[gpu_handle].slock);
-        // update our event state
-        auto& event_record = event_map[event_id];
-        event_record.timestamp = ts;
-        strncpy(event_record.message, event_buffer[i].message,
+        if (event_id == AGA_EVENT_ID_GPU_POST_RESET) {
+            // GPU state cached for reads is not valid anymore
+            gpu->cache_invalidate();
+            topo_invalidate();
+        }
+        auto& event_db = gpu_slot_[gpu->id()].event_db;
+
+        // record the event in the event history of this device
+        history_record.seq = ++event_seq_;
+        history_record.id = event_id;
+        history_record.timestamp = ts;
+        strncpy(history_record.message, event_buffer[i].message,
                 AGA_MAX_EVENT_STR);
-        event_record.message[AGA_MAX_EVENT_STR] = '\0';
+        history_record.message[AGA_MAX_EVENT_STR] = '\0';
+        event_db.history.push(history_record);
         // fill the event record
-        event.id = event_id;
-        event.timestamp = ts;
-        event.gpu = gpu->key();
-        strncpy(event.message, event_buffer[i].message,
-                AGA_MAX_EVENT_STR);
-        event.message[AGA_MAX_EVENT_STR] = '\0';
+        gpu_event_from_history_record(&event, &history_record, gpu->key());
         // walk thru all the clients that are interested in this event and
-        // notify them
-        for (auto client_set_it = event_record.client_info.client_set.begin();
-             client_set_it != event_record.client_info.client_set.end();
-             client_set_it++) {
-             client_ctxt = *client_set_it;
+        // notify them, the callback only queues the event on the client's
+        // stream and the snapshot walked needs no lock
+        auto clients = event_db.subscribers.clients(event_id);
+        if (clients == NULL) {
+            continue;
+        }
+        for (auto client_set_it = clients->begin();
+             client_set_it != clients->end(); client_set_it++) {
+            client_ctxt = *client_set_it;
             // invoke the event notification callback
-            ret = client_ctxt->notify_cb(&event, *client_set_it);
+            ret = client_ctxt->notify_cb(&event, client_ctxt);
             if (unlikely(ret != SDK_RET_OK)) {
                 // add to list of clients not reachable
                 inactive_listener.gpu_id = gpu->id();
                 inactive_listener.event = event_id;
-                inactive_listener.client_ctxt = *client_set_it;
+                inactive_listener.client_ctxt = client_ctxt;
                 inactive_listeners.push_back(inactive_listener);
             }
         }
-        // unlock the event state maintained for this device
-        SDK_SPINLOCK_UNLOCK(&gpu_event_db_[gpu_handle].slock);
     }
     // handle all the dead clients now
     cleanup_event_listeners_(inactive_listeners);
@@ -1254,54 +1467,99 @@ smi_state::handle_events(uint32_t num_events, void *event_buffer_) {
 }
 
 sdk_ret_t
-smi_state::event_read(aga_event_read_cb_t cb, void *ctxt) {
+smi_state::event_read(aga_event_read_cb_t cb, void *ctxt,
+                      const aga_event_query_t *query) {
     aga_event_t event;
+    uint64_t since_seq = query ? query->since_seq : 0;
 
-    // traverse the event database per device
+    // traverse the event history per device
     for (uint32_t d = 0; d < num_gpu_; d++) {
-        auto gpu = gpu_db()->find(gpu_handles_[d]);
+        auto gpu = gpu_db()->find(gpu_slot_[d].handle);
         if (gpu == NULL) {
             continue;
         }
-        auto& event_map = gpu_event_db_[gpu_handles_[d]].event_map;
-        // lock the event map for this device
-        SDK_SPINLOCK_LOCK(&gpu_event_db_[gpu_handles_[d]].slock);
-        for (auto it = event_map.begin(); it != event_map.end(); it++) {
-            event = {};
-            auto& event_record = it->second;
-
-            // fill the event information
-            event.id = it->first;
-            event.timestamp = event_record.timestamp;
-            event.gpu = gpu->key();
-            strncpy(event.message, event_record.message, AGA_MAX_EVENT_STR);
-            event.message[AGA_MAX_EVENT_STR] = '\0';
-            // call the callback now
-            cb(&event, ctxt);
-        }
-        // unlock the event map for this device
-        SDK_SPINLOCK_UNLOCK(&gpu_event_db_[gpu_handles_[d]].slock);
+        gpu_slot_[d].event_db.history.walk(since_seq,
+            [&](const gpu_event_history_record_t *record) {
+                if (gpu_event_query_match(record, query)) {
+                    gpu_event_from_history_record(&event, record, gpu->key());
+                    cb(&event, ctxt);
+                }
+            });
     }
     return SDK_RET_OK;
 }
 
-static void
-event_monitor_timer_cb_ (event::timer_t *timer)
+/// \brief    entry point of the event reader thread, blocks waiting for the
+///           GPU events and hands them over to the event monitor thread
+/// \param[in] ctxt    thread instance
+static void *
+event_reader_thread_start_ (void *ctxt)
 {
     amdsmi_status_t status;
-    uint32_t num_elem = AGA_MAX_GPU * AGA_EVENT_ID_MAX;
-    amdsmi_evt_notification_data_t event_ntfn_data[num_elem];
-
-    // get event information
-    status = amdsmi_get_gpu_event_notification(AGA_SMI_EVENT_MONITOR_INTERVAL,
-                                               &num_elem, event_ntfn_data);
-    if (unlikely(status != AMDSMI_STATUS_SUCCESS)) {
-        AGA_TRACE_ERR("Failed to get event notification data, err {}", status);
-        return;
+    uint32_t num_elem;
+    amdsmi_evt_notification_data_t event_ntfn_data[AGA_SMI_EVENT_BATCH_SIZE];
+
+    SDK_THREAD_INIT(ctxt);
+    while (!g_smi_state.event_reader_stopped()) {
+        // wait for the events
+        num_elem = AGA_SMI_EVENT_BATCH_SIZE;
+        status = amdsmi_get_gpu_event_notification(AGA_SMI_EVENT_READ_TIMEOUT,
+                                                   &num_elem, event_ntfn_data);
+        if (status == AMDSMI_STATUS_NO_DATA) {
+            continue;
+        }
+        if (unlikely(status != AMDSMI_STATUS_SUCCESS)) {
+            AGA_TRACE_ERR("Failed to get event notification data, err {}",
+                          status);
+            // back off instead of spinning on a persistent failure
+            usleep(AGA_SMI_EVENT_READ_TIMEOUT * TIME_USECS_PER_MSEC);
+            continue;
+        }
+        if (num_elem &&
+            (g_smi_state.event_pipe()->write_events(event_ntfn_data,
+                                                    num_elem) != SDK_RET_OK)) {
+            AGA_TRACE_ERR("Dropped GPU events, event monitor is behind, "
+                          "total drops {}",
+                          g_smi_state.event_pipe()->num_drops());
+        }
     }
+    return NULL;
+}
+
+sdk_ret_t
+smi_state::spawn_event_reader_thread_(void) {
+    event_reader_stop_ = false;
+    event_reader_thread_ =
+        sdk::lib::thread::factory(
+            "event-reader", AGA_THREAD_ID_EVENT_READER,
+            sdk::lib::THREAD_ROLE_CONTROL, 0x0, event_reader_thread_start_,
+            sdk::lib::thread::priority_by_role(sdk::lib::THREAD_ROLE_CONTROL),
+            sdk::lib::thread::sched_policy_by_role(
+                                  sdk::lib::THREAD_ROLE_CONTROL));
+    SDK_ASSERT_TRACE_RETURN((event_reader_thread_ != NULL), SDK_RET_ERR,
+                            "GPU event reader thread create failure");
+    event_reader_thread_->start(event_reader_thread_);
+    return SDK_RET_OK;
+}
 
-    // handle all the events
-    g_smi_state.handle_events(num_elem, event_ntfn_data);
+/// \brief    callback invoked when events are written to the event pipe
+/// \param[in] io        io watcher of the event pipe
+/// \param[in] fd        read end of the event pipe
+/// \param[in] events    io events that triggered the callback
+static void
+event_pipe_io_cb_ (event::io_t *io, int fd, int events)
+{
+    uint32_t num_events;
+    amdsmi_evt_notification_data_t event_data[AGA_SMI_EVENT_BATCH_SIZE];
+
+    // drain all the events pending in the pipe
+    do {
+        num_events = g_smi_state.event_pipe()->read_events(
+                         event_data, AGA_SMI_EVENT_BATCH_SIZE);
+        if (num_events) {
+            g_smi_state.handle_events(num_events, event_data);
+        }
+    } while (num_events == AGA_SMI_EVENT_BATCH_SIZE);
 }
 
 /// \brief process an event subscribe request from client
@@ -1309,8 +1567,6 @@ event_monitor_timer_cb_ (event::timer_t *timer)
 /// \return SDK_RET_OK if success or error code in case of failure
 sdk_ret_t
 smi_state::process_event_subscribe_req(aga_event_subscribe_args_t *req) {
-    gpu_event_record_t event_record = {};
-
     for (size_t i = 0; i < req->events.size(); i++) {
         AGA_TRACE_DEBUG("Rcvd event {} subscribe request, client {}, "
                         "client ctxt {}, stream {}",  req->events[i],
@@ -1319,33 +1575,67 @@ smi_state::process_event_subscribe_req(aga_event_subscribe_args_t *req) {
                         (void *)req->client_ctxt->stream);
         for (size_t g = 0; g < req->gpu_ids.size(); g++) {
             uint32_t d = req->gpu_ids[g];
-            auto& event_map = gpu_event_db_[gpu_handles_[d]].event_map;
-
-            // lock the event map for this device
-            SDK_SPINLOCK_LOCK(&gpu_event_db_[gpu_handles_[d]].slock);
-            // check if this event was of interest to any client or happened
-            // already
-            auto event_map_it = event_map.find(req->events[i]);
-            if (event_map_it == event_map.end()) {
-                // 1st time anyone is subscribing to this event
-                event_record.client_info.client_set.insert(req->client_ctxt);
-                event_map[req->events[i]] = event_record;
-            } else {
-                // atleast one client is already interested in this event, check
-                // if this particular client already subscribed to this event
-                auto set_it = event_map_it->second.client_info.client_set.find(
-                                                       req->client_ctxt);
-                if (set_it ==
-                        event_map_it->second.client_info.client_set.end()) {
-                    // this client is a new listener for this event
-                    event_map_it->second.client_info.client_set.insert(
-                                                         req->client_ctxt);
-                } else {
-                    // this client is already subscribed to this event
+
+            // add this client to the listeners of this event, if not
+            // subscribed already
+            gpu_slot_[d].event_db.subscribers.add(req->events[i],
+                                                  req->client_ctxt);
+        }
+    }
+    if (req->resume_seq) {
+        // events that happen from here on are notified to this client only
+        // after the replay as both are handled in this thread
+        replay_events_(req);
+    }
+    return SDK_RET_OK;
+}
+
+sdk_ret_t
+smi_state::replay_events_(aga_event_subscribe_args_t *req) {
+    sdk_ret_t ret;
+    aga_event_t event;
+    aga_event_listener_info_t inactive_listener;
+    vector<aga_event_listener_info_t> inactive_listeners;
+    vector<std::pair<uint32_t, gpu_event_history_record_t>> records;
+
+    // gather the events of interest from the event history of all the GPUs
+    // of interest
+    for (size_t g = 0; g < req->gpu_ids.size(); g++) {
+        uint32_t d = req->gpu_ids[g];
+
+        gpu_slot_[d].event_db.history.walk(req->resume_seq - 1,
+            [&](const gpu_event_history_record_t *record) {
+                if (std::find(req->events.begin(), req->events.end(),
+                              record->id) != req->events.end()) {
+                    records.push_back(std::make_pair(d, *record));
                 }
-            }
-            // unlock the event map for this device
-            SDK_SPINLOCK_UNLOCK(&gpu_event_db_[gpu_handles_[d]].slock);
+            });
+    }
+    // and replay them in the order they happened
+    std::sort(records.begin(), records.end(),
+              [](const std::pair<uint32_t, gpu_event_history_record_t>& r1,
+                 const std::pair<uint32_t, gpu_event_history_record_t>& r2) {
+                  return r1.second.seq < r2.second.seq;
+              });
+    AGA_TRACE_DEBUG("Replaying {} events from seq {} to client {}, "
+                    "client ctxt {}", records.size(), req->resume_seq,
+                    req->client_ctxt->client.c_str(),
+                    (void *)req->client_ctxt);
+    for (auto it = records.begin(); it != records.end(); it++) {
+        auto gpu = gpu_db()->find(gpu_slot_[it->first].handle);
+        if (gpu == NULL) {
+            continue;
+        }
+        gpu_event_from_history_record(&event, &it->second, gpu->key());
+        ret = req->client_ctxt->notify_cb(&event, req->client_ctxt);
+        if (unlikely(ret != SDK_RET_OK)) {
+            // client is not reachable anymore
+            inactive_listener.gpu_id = it->first;
+            inactive_listener.event = event.id;
+            inactive_listener.client_ctxt = req->client_ctxt;
+            inactive_listeners.push_back(inactive_listener);
+            cleanup_event_listeners_(inactive_listeners);
+            return ret;
         }
     }
     return SDK_RET_OK;
@@ -1408,16 +1698,20 @@ smi_state::process_event_gen_req(aga_event_gen_args_t *args) {
             }
             event_data[num_elem].event = smi_event;
             event_data[num_elem].processor_handle =
-                gpu_handles_[args->gpu_ids[i]];
+                gpu_slot_[args->gpu_ids[i]].handle;
             strncpy(event_data[num_elem].message,
                     event_description_(args->events[e]),
                     MAX_EVENT_NOTIFICATION_MSG_SIZE);
             num_elem++;
         }
     }
-    // handle all the events
-    g_smi_state.handle_events(num_elem, event_data);
-    return SDK_RET_OK;
+    // hand the events over to the event monitor the same way as the events
+    // reported by the GPUs
+    ret = event_pipe_.write_events(event_data, num_elem);
+    if (unlikely(ret != SDK_RET_OK)) {
+        AGA_TRACE_ERR("Failed to generate events, err {}", ret());
+    }
+    return ret;
 }
 
 /// \brief callback function to process IPC msg from gRPC thread
@@ -1442,20 +1736,26 @@ event_gen_ipc_cb_ (sdk::ipc::ipc_msg_ptr msg, const void *ctxt)
 static void
 event_monitor_thread_init_ (void *ctxt)
 {
-    static event::timer_t event_monitor_timer;
+    sdk_ret_t ret;
+    static event::io_t event_pipe_io;
 
     // initialize event monitoring state
-    g_smi_state.event_monitor_init();
+    ret = g_smi_state.event_monitor_init();
+    if (unlikely(ret != SDK_RET_OK)) {
+        AGA_TRACE_ERR("Failed to initialize event monitoring, err {}", ret());
+        return;
+    }
     // subscribe to all IPC msgs of interest
     sdk::ipc::reg_request_handler(AGA_IPC_MSG_ID_EVENT_SUBSCRIBE,
                                   event_subscribe_ipc_cb_, NULL);
     sdk::ipc::reg_request_handler(AGA_IPC_MSG_ID_EVENT_GEN,
                                   event_gen_ipc_cb_, NULL);
-    // start event monitoring timer
-    event::timer_init(&event_monitor_timer, event_monitor_timer_cb_,
-                      AGA_SMI_EVENT_MONITOR_START_DELAY,
-                      AGA_SMI_EVENT_MONITOR_INTERVAL);
-    event::timer_start(&event_monitor_timer);
+    // start handling the events as soon as they are handed over
+    if (g_smi_state.event_pipe()->read_fd() >= 0) {
+        event::io_init(&event_pipe_io, event_pipe_io_cb_,
+                       g_smi_state.event_pipe()->read_fd(), EVENT_READ);
+        event::io_start(&event_pipe_io);
+    }
 }
 
 void
@@ -1482,10 +1782,130 @@ smi_state::spawn_event_monitor_thread_(void) {
     return SDK_RET_OK;
 }
 
+void
+smi_state::topo_read_links(uint32_t gpu_id, gpu_topo_matrix_t *matrix) {
+    amdsmi_status_t amdsmi_ret;
+    gpu_topo_link_t *link;
+    aga_gpu_handle_t handle = gpu_slot_[gpu_id].handle;
+
+    for (uint32_t peer = 0; peer < num_gpu_; peer++) {
+        if (peer == gpu_id) {
+            continue;
+        }
+        link = &matrix->link[gpu_id][peer];
+        amdsmi_ret = amdsmi_topo_get_link_type(handle, gpu_slot_[peer].handle,
+                         &link->num_hops, (amdsmi_io_link_type_t *)&link->type);
+        if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
+            AGA_TRACE_ERR("Failed to get link type between gpus {} and {}, "
+                          "err {}", handle, gpu_slot_[peer].handle, amdsmi_ret);
+            // in case of error set num hops to 0xffff and IO link type to
+            // none
+            link->num_hops = 0xffff;
+            link->type = AGA_IO_LINK_TYPE_NONE;
+        }
+        amdsmi_ret = amdsmi_topo_get_link_weight(handle, gpu_slot_[peer].handle,
+                                                 &link->weight);
+        if (unlikely(amdsmi_ret != AMDSMI_STATUS_SUCCESS)) {
+            AGA_TRACE_ERR("Failed to get weight for link between gpus {}"
+                          "and {}, err {}", handle, gpu_slot_[peer].handle,
+                          amdsmi_ret);
+            // in case of error set link weight to 0xffff
+            link->weight = 0xffff;
+        }
+    }
+}
+
+/// \brief context shared by the workers reading the GPU topology
+typedef struct topo_work_ctxt_s {
+    /// next GPU whose links are to be read
+    uint32_t next_gpu;
+    /// no. of GPUs
+    uint32_t num_gpu;
+    /// matrix to be filled
+    gpu_topo_matrix_t *matrix;
+} topo_work_ctxt_t;
+
+/// \brief    topology worker callback, keeps picking the next GPU whose links
+///           are not read yet
+/// \param[in] arg    topology work context
+/// \return SDK_RET_OK or error status in case of failure
+static sdk_ret_t
+topo_work_cb_ (void *arg)
+{
+    uint32_t gpu;
+    topo_work_ctxt_t *ctxt = (topo_work_ctxt_t *)arg;
+
+    while ((gpu = SDK_ATOMIC_FETCH_ADD(&ctxt->next_gpu, 1)) < ctxt->num_gpu) {
+        g_smi_state.topo_read_links(gpu, ctxt->matrix);
+    }
+    return SDK_RET_OK;
+}
+
+sdk_ret_t
+smi_state::topo_build_(void) {
+    uint32_t num_workers;
+    topo_work_ctxt_t work_ctxt;
+    sdk::lib::work_barrier barrier;
+    sdk::lib::thread_pool *tpool = NULL;
+    gpu_topo_matrix_t *matrix;
+
+    matrix = new gpu_topo_matrix_t();
+    num_workers = (num_gpu_ < AGA_TOPO_MAX_WORKERS) ?
+                      num_gpu_ : AGA_TOPO_MAX_WORKERS;
+    if (num_workers > 1) {
+        tpool = sdk::lib::thread_pool::factory(num_workers, 0, false);
+    }
+    if (tpool == NULL) {
+        for (uint32_t gpu = 0; gpu < num_gpu_; gpu++) {
+            topo_read_links(gpu, matrix);
+        }
+    } else {
+        // fan out the reads across the workers, all the links of a GPU are
+        // read by one worker
+        work_ctxt.next_gpu = 0;
+        work_ctxt.num_gpu = num_gpu_;
+        work_ctxt.matrix = matrix;
+        tpool->barrier_init(&barrier, num_workers);
+        for (uint32_t w = 0; w < num_workers; w++) {
+            tpool->work_post(topo_work_cb_, &work_ctxt, w, NULL, &barrier);
+        }
+        tpool->barrier_wait(&barrier);
+        sdk::lib::thread_pool::destroy(tpool);
+    }
+    std::atomic_store(&topo_, gpu_topo_matrix_ptr_t(matrix));
+    AGA_TRACE_DEBUG("Built topology matrix of {} GPUs", num_gpu_);
+    return SDK_RET_OK;
+}
+
+sdk_ret_t
+smi_state::topo_build(void) {
+    std::lock_guard<std::mutex> lock(topo_lock_);
+
+    return topo_build_();
+}
+
+gpu_topo_matrix_ptr_t
+smi_state::topo(void) {
+    gpu_topo_matrix_ptr_t matrix = std::atomic_load(&topo_);
+
+    if (likely(matrix != NULL)) {
+        return matrix;
+    }
+    // concurrent readers of an invalidated matrix wait for one rebuild
+    std::lock_guard<std::mutex> lock(topo_lock_);
+    matrix = std::atomic_load(&topo_);
+    if (matrix == NULL) {
+        topo_build_();
+        matrix = std::atomic_load(&topo_);
+    }
+    return matrix;
+}
+
 sdk_ret_t
 smi_state::init(aga_api_init_params_t *init_params) {
     sdk_ret_t ret;
     amdsmi_status_t status;
+    aga_gpu_handle_t gpu_handles[AGA_MAX_GPU];
 
     // initialize smi library
     status = amdsmi_init(AMDSMI_INIT_AMD_GPUS);
@@ -1493,11 +1913,18 @@ smi_state::init(aga_api_init_params_t *init_params) {
         AGA_TRACE_ERR("Failed to initialize amd smi library, err {}", status);
         return amdsmi_ret_to_sdk_ret(status);
     }
+    // bound the age of cached amdsmi data served to API readers
+    if (init_params->smi_cache_ttl) {
+        g_smi_cache.set_ttl(init_params->smi_cache_ttl);
+    }
     // discover gpus
-    ret = aga::smi_discover_gpus(&num_gpu_, gpu_handles_, NULL);
+    ret = aga::smi_discover_gpus(&num_gpu_, gpu_handles, NULL);
     if (ret != SDK_RET_OK) {
         return ret;
     }
+    for (uint32_t d = 0; d < num_gpu_; d++) {
+        gpu_slot_[d].handle = gpu_handles[d];
+    }
     // spawn event monitor thread
     spawn_event_monitor_thread_();
     // spawn watcher thread
@@ -131,14 +131,12 @@ smi_state::cleanup_event_listeners_(
     }
     for (auto it = client_set.begin(); it!= client_set.end(); it++) {
         client_ctxt = *it;
-        // wakeup the front end thread so it can exit
-        client_ctxt->client_inactive = true;
-        AGA_TRACE_INFO("Signaling frontend gRPC thread to quit, client {}, "
-                       "client ctxt {}, stream {}",
+        // close the stream and release the client context
+        AGA_TRACE_INFO("Closing inactive client {}, client ctxt {}, stream {}",
                        client_ctxt->client.c_str(),
                        (void *)client_ctxt,
                        client_ctxt->stream);
-        pthread_cond_signal(&client_ctxt->cond);
+        aga_event_client_ctxt_release(client_ctxt);
     }
     return SDK_RET_OK;
 }
@@ -27,6 +27,8 @@ limitations under the License.
 #include "nic/gpuagent/api/include/aga_init.hpp"
 #include "nic/gpuagent/api/include/aga_gpu.hpp"
 #include "nic/gpuagent/api/include/aga_task.hpp"
+#include "nic/gpuagent/api/internal/aga_gpu_watch.hpp"
+#include "nic/gpuagent/api/gpu_watch_sched.hpp"
 #ifndef ROCM_SMI
 #include "nic/third-party/rocm/amd_smi_lib/include/amd_smi/amdsmi.h"
 
@@ -60,21 +62,44 @@ sdk_ret_t smi_gpu_fill_spec(aga_gpu_handle_t handle,
 sdk_ret_t smi_gpu_fill_status(aga_gpu_handle_t handle, uint32_t id,
                               aga_gpu_status_t *status);
 
+/// \brief    refresh the runtime varying fields (current clocks, link state,
+///           throttling, KFD processes etc.) of a previously filled status
+/// \param[in] handle    GPU handle
+/// \param[in] id        GPU index
+/// \param[in,out] status    operational status to be refreshed
+/// \return     SDK_RET_OK or error code in case of failure
+sdk_ret_t smi_gpu_fill_dynamic_status(aga_gpu_handle_t handle, uint32_t id,
+                                      aga_gpu_status_t *status);
+
 /// \brief    fill gpu object statistics
 /// \param[in] handle                   GPU handle
 /// \param[in] main_partition_handle    in case of GPU partitions, handle of the
 ///                                     first partition, else, GPU handle
 /// \param[out] stats    gpu object stats to be filled
+/// \param[in] live     true to read from the GPU instead of the smi cache
 /// \return     SDK_RET_OK or error code in case of failure
 sdk_ret_t smi_gpu_fill_stats(aga_gpu_handle_t handle,
                              aga_gpu_handle_t first_partition_handle,
-                             aga_gpu_stats_t *stats);
+                             aga_gpu_stats_t *stats, bool live = false);
+
+/// \brief    read the given watch attributes of a GPU right away instead of
+///           waiting for the watcher to sample them
+/// \param[in] gpu_id        GPU id
+/// \param[in] attrs         attributes to be read
+/// \param[in,out] fields    watch fields, only the fields of the given
+///                          attributes are updated
+/// \return     SDK_RET_OK or error code in case of failure
+sdk_ret_t smi_gpu_watch_fields_read(uint32_t gpu_id,
+                                    const aga_gpu_watch_attr_set_t& attrs,
+                                    aga_gpu_watch_fields_t *fields);
 
 /// \brief    read all the events and invokve the callback provided for each
-/// \param[in] cb    callback function pointer
-/// \param[in] ctxt  opaque context passed back to the callback
+/// \param[in] cb       callback function pointer
+/// \param[in] ctxt     opaque context passed back to the callback
+/// \param[in] query    if not NULL, only events matching the query are read
 /// \return     SDK_RET_OK or error code in case of failure
-sdk_ret_t smi_event_read_all(aga_event_read_cb_t cb, void *ctxt);
+sdk_ret_t smi_event_read_all(aga_event_read_cb_t cb, void *ctxt,
+                             const aga_event_query_t *query);
 
 /// \brief     reset gpu or a specific gpu setting
 /// \param[in] handle    GPU handle
@@ -91,7 +116,13 @@ sdk_ret_t smi_gpu_reset(aga_gpu_handle_t handle,
 sdk_ret_t smi_gpu_update(aga_gpu_handle_t handle, aga_gpu_spec_t *spec,
                          uint64_t upd_mask);
 
-/// \brief     fill gpu device topology
+/// \brief     read and cache the device topology of all the GPUs, the cached
+///            topology is rebuilt on next read after GPU resets and
+///            partition changes
+/// \return    SDK_RET_OK or error code in case of failure
+sdk_ret_t smi_gpu_topology_init(void);
+
+/// \brief     fill gpu device topology from the cached topology
 /// \param[in] gpu_handle   GPU handle
 /// \param[out] info    GPU topology information
 /// \return    SDK_RET_OK or error code in case of failure
@@ -33,17 +33,23 @@ limitations under the License.
 #include "nic/gpuagent/api/smi/smi_events.hpp"
 #include "nic/gpuagent/api/smi/smi_api_mock_impl.hpp"
 
-/// initial delay (in seconds) after which event monitoring starts
-#define AGA_SMI_EVENT_MONITOR_START_DELAY    10.0
-/// event monitoring frequency (in seconds)
-#define AGA_SMI_EVENT_MONITOR_INTERVAL       3.0
+/// initial delay (in seconds) after which mock events start getting generated
+#define AGA_SMI_EVENT_MOCK_START_DELAY       10.0
+/// mock event generation frequency (in seconds)
+#define AGA_SMI_EVENT_MOCK_INTERVAL          3.0
+/// size of the buffer events are read from the event pipe into (in bytes)
+#define AGA_SMI_EVENT_BUF_SIZE               (16 * PIPE_BUF)
 
 namespace aga {
 
 /// event database indexed by processor handle
 unordered_map<aga_gpu_handle_t, gpu_event_db_entry_t> g_gpu_event_db;
+/// sequence number of the last event reported
+uint64_t g_event_seq;
 /// event monitor thread instance
 sdk::event_thread::event_thread *g_event_monitor_thread;
+/// pipe the mock events are handed over on to the event monitor thread
+gpu_event_pipe g_event_pipe;
 
 /// \brief    fill clock frequency ranges of the given GPU
 /// \param[in] gpu_handle   GPU handle
@@ -204,10 +210,19 @@ smi_gpu_fill_status (aga_gpu_handle_t gpu_handle, uint32_t gpu_id,
     return SDK_RET_OK;
 }
 
+sdk_ret_t
+smi_gpu_fill_dynamic_status (aga_gpu_handle_t gpu_handle, uint32_t gpu_id,
+                             aga_gpu_status_t *status)
+{
+    smi_fill_clock_status_(gpu_handle, status);
+    smi_fill_gpu_kfd_pid_status_(gpu_handle, status);
+    return SDK_RET_OK;
+}
+
 sdk_ret_t
 smi_gpu_fill_stats (aga_gpu_handle_t gpu_handle,
                     aga_gpu_handle_t first_partition_handle,
-                    aga_gpu_stats_t *stats)
+                    aga_gpu_stats_t *stats, bool live)
 {
     std::random_device rd; // obtain a random number from hardware
     std::mt19937 gen(rd()); // seed the generator
@@ -238,63 +253,59 @@ smi_gpu_fill_stats (aga_gpu_handle_t gpu_handle,
     return SDK_RET_OK;
 }
 
-typedef struct gpu_event_cb_ctxt_s {
-    aga_event_read_cb_t cb;
-} gpu_event_cb_ctxt_t;
-
-static inline bool
-gpu_event_read_cb (void *obj, void *ctxt)
+sdk_ret_t
+smi_gpu_watch_fields_read (uint32_t gpu_id,
+                           const aga_gpu_watch_attr_set_t& attrs,
+                           aga_gpu_watch_fields_t *fields)
 {
-    aga_event_t event;
-    gpu_entry *gpu = (gpu_entry *)obj;
-    gpu_event_cb_ctxt_t *walk_ctxt = (gpu_event_cb_ctxt_t *)ctxt;
-
-    auto& event_map = g_gpu_event_db[gpu->handle()].event_map;
-    // lock the event map for this device
-    SDK_SPINLOCK_LOCK(&g_gpu_event_db[gpu->handle()].slock);
-    for (auto it = event_map.begin(); it != event_map.end(); it++) {
-        event = {};
-        auto& event_record = it->second;
-
-        // fill the event information
-        event.id = it->first;
-        event.timestamp = event_record.timestamp;
-        event.gpu = gpu->key();
-        strncpy(event.message, event_record.message, AGA_MAX_EVENT_STR);
-        event.message[AGA_MAX_EVENT_STR] = '\0';
-        // call the callback now
-        walk_ctxt->cb(&event, ctxt);
-    }
-    // unlock the event map for this device
-    SDK_SPINLOCK_UNLOCK(&g_gpu_event_db[gpu->handle()].slock);
-    return false;
+    return SDK_RET_OK;
 }
 
 sdk_ret_t
-event_read (aga_event_read_cb_t cb, void *ctxt)
+event_read (aga_event_read_cb_t cb, void *ctxt,
+            const aga_event_query_t *query)
 {
-    gpu_event_cb_ctxt_t event_ctxt;
+    aga_event_t event;
+    uint64_t since_seq = query ? query->since_seq : 0;
 
-    event_ctxt.cb = cb;
-    gpu_db()->walk(gpu_event_read_cb, &event_ctxt);
+    for (uint32_t d = 0; d < AGA_MOCK_NUM_GPU; d++) {
+        auto gpu = gpu_db()->find(gpu_get_handle(d));
+        if (gpu == NULL) {
+            continue;
+        }
+        g_gpu_event_db[gpu_get_handle(d)].history.walk(since_seq,
+            [&](const gpu_event_history_record_t *record) {
+                if (gpu_event_query_match(record, query)) {
+                    gpu_event_from_history_record(&event, record, gpu->key());
+                    cb(&event, ctxt);
+                }
+            });
+    }
     return SDK_RET_OK;
 }
 
 sdk_ret_t
-smi_event_read_all (aga_event_read_cb_t cb, void *ctxt)
+smi_event_read_all (aga_event_read_cb_t cb, void *ctxt,
+                    const aga_event_query_t *query)
 {
-    return event_read(cb, ctxt);
+    return event_read(cb, ctxt, query);
 }
 
 sdk_ret_t
 event_monitor_init (void)
 {
-    gpu_event_record_t null_event_record = {};
+    sdk_ret_t ret;
 
+    // create the pipe events are handed over on to the event monitor thread
+    ret = g_event_pipe.init(event_size_get());
+    if (unlikely(ret != SDK_RET_OK)) {
+        AGA_TRACE_ERR("Failed to create event pipe, err {}", ret());
+        return ret;
+    }
     // initialize the s/w state
     for (uint32_t d = 0; d < AGA_MOCK_NUM_GPU; d++) {
-        SDK_SPINLOCK_INIT(&g_gpu_event_db[gpu_get_handle(d)].slock,
-                          PTHREAD_PROCESS_SHARED);
+        g_gpu_event_db[gpu_get_handle(d)].history.init(
+            AGA_GPU_EVENT_HISTORY_DEPTH);
     }
     return SDK_RET_OK;
 }
@@ -303,6 +314,8 @@ sdk_ret_t
 cleanup_event_listeners (vector<aga_event_listener_info_t>& listeners)
 {
     aga_event_listener_info_t listener;
+    aga_event_client_ctxt_t *client_ctxt;
+    set<aga_event_client_ctxt_t *> client_set;
 
     for (auto it = listeners.begin(); it != listeners.end(); it++) {
         listener = *it;
@@ -315,26 +328,20 @@ cleanup_event_listeners (vector<aga_event_listener_info_t>& listeners)
         // will eventually lead to agent crash
 
         for (uint32_t d = 0; d < AGA_MOCK_NUM_GPU; d++) {
-            // lock the event state for this device
-            SDK_SPINLOCK_LOCK(&g_gpu_event_db[gpu_get_handle(d)].slock);
-            for (uint32_t e = (AGA_EVENT_ID_NONE + 1); e <= AGA_EVENT_ID_MAX;
-                 e++) {
-                auto& event_record =
-                    g_gpu_event_db[gpu_get_handle(d)].event_map[(aga_event_id_t)e];
-                // erase the client
-                event_record.client_info.client_set.erase(listener.client_ctxt);
-            }
-            // unlock the event state for this device
-            SDK_SPINLOCK_UNLOCK(&g_gpu_event_db[gpu_get_handle(d)].slock);
+            // erase the client from all the events of this device
+            g_gpu_event_db[gpu_get_handle(d)].subscribers.remove(
+                                                  listener.client_ctxt);
         }
-        // wakeup the front end thread so it can exit
-        listener.client_ctxt->client_inactive = true;
-        AGA_TRACE_INFO("Signaling frontend gRPC thread to quit, client {}, "
-                       "client ctxt {}, stream {}",
-                       listener.client_ctxt->client.c_str(),
-                       (void *)listener.client_ctxt,
-                       listener.client_ctxt->stream);
-        pthread_cond_signal(&listener.client_ctxt->cond);
+        client_set.insert(listener.client_ctxt);
+    }
+    for (auto it = client_set.begin(); it!= client_set.end(); it++) {
+        client_ctxt = *it;
+        // close the stream and release the client context
+        AGA_TRACE_INFO("Closing inactive client {}, client ctxt {}, stream {}",
+                       client_ctxt->client.c_str(),
+                       (void *)client_ctxt,
+                       client_ctxt->stream);
+        aga_event_client_ctxt_release(client_ctxt);
     }
     return SDK_RET_OK;
 }
@@ -346,8 +353,9 @@ handle_events (uint32_t num_events, void *event_buffer)
     timespec_t ts;
     gpu_entry *gpu;
     aga_gpu_handle_t gpu_handle;
-    aga_event_t event = {};
+    aga_event_t event;
     aga_event_id_t event_id;
+    gpu_event_history_record_t history_record;
     aga_event_client_ctxt_t *client_ctxt;
     aga_event_listener_info_t inactive_listener;
     vector<aga_event_listener_info_t> inactive_listeners;
@@ -362,52 +370,72 @@ handle_events (uint32_t num_events, void *event_buffer)
             continue;
         }
         event_id = event_buffer_get_event_id(event_buffer, i);
-        auto& event_map = g_gpu_event_db[gpu_handle].event_map;
-
-        // lock the event state for this device
-        SDK_SPINLOCK_LOCK(&g_gpu_event_db[gpu_handle].slock);
-        // update our event state
-        auto& event_record = event_map[event_id];
-        event_record.timestamp = ts;
-        strncpy(event_record.message, event_buffer_get_message(event_buffer, i),
-                AGA_MAX_EVENT_STR);
-        event_record.message[AGA_MAX_EVENT_STR] = '\0';
+
+        // record the event in the event history of this device
+        history_record.seq = ++g_event_seq;
+        history_record.id = event_id;
+        history_record.timestamp = ts;
+        strncpy(history_record.message,
+                event_buffer_get_message(event_buffer, i), AGA_MAX_EVENT_STR);
+        history_record.message[AGA_MAX_EVENT_STR] = '\0';
+        g_gpu_event_db[gpu_handle].history.push(history_record);
         // fill the event record
-        event.id = event_id;
-        event.timestamp = ts;
-        event.gpu = gpu->key();
-        strncpy(event.message, event_buffer_get_message(event_buffer, i),
-                AGA_MAX_EVENT_STR);
-        event.message[AGA_MAX_EVENT_STR] = '\0';
+        gpu_event_from_history_record(&event, &history_record, gpu->key());
         // walk thru all the clients that are interested in this event and
         // notify them
-        for (auto client_set_it = event_record.client_info.client_set.begin();
-             client_set_it != event_record.client_info.client_set.end();
-             client_set_it++) {
-             client_ctxt = *client_set_it;
+        auto clients = g_gpu_event_db[gpu_handle].subscribers.clients(event_id);
+        if (clients == NULL) {
+            continue;
+        }
+        for (auto client_set_it = clients->begin();
+             client_set_it != clients->end(); client_set_it++) {
+            client_ctxt = *client_set_it;
             // invoke the event notification callback
-            ret = client_ctxt->notify_cb(&event, *client_set_it);
+            ret = client_ctxt->notify_cb(&event, client_ctxt);
             if (unlikely(ret != SDK_RET_OK)) {
                 // add to list of clients not reachable
                 inactive_listener.gpu_id = gpu->id();
                 inactive_listener.event = event_id;
-                inactive_listener.client_ctxt = *client_set_it;
+                inactive_listener.client_ctxt = client_ctxt;
                 inactive_listeners.push_back(inactive_listener);
             }
         }
-        // unlock the event state maintained for this device
-        SDK_SPINLOCK_UNLOCK(&g_gpu_event_db[gpu_handle].slock);
     }
     // handle all the dead clients now
     cleanup_event_listeners(inactive_listeners);
     return SDK_RET_OK;
 }
 
+/// \brief    timer callback generating mock events, the events are handed
+///           over to the event monitor the same way as the real GPU events
+/// \param[in] timer    mock event timer
+static void
+event_mock_timer_cb (sdk::event_thread::timer_t *timer)
+{
+    if (g_event_pipe.write_events(event_get(), 1) != SDK_RET_OK) {
+        AGA_TRACE_ERR("Dropped mock GPU event, total drops {}",
+                      g_event_pipe.num_drops());
+    }
+}
+
+/// \brief    callback invoked when events are written to the event pipe
+/// \param[in] io        io watcher of the event pipe
+/// \param[in] fd        read end of the event pipe
+/// \param[in] events    io events that triggered the callback
 static void
-event_monitor_timer_cb (sdk::event_thread::timer_t *timer)
+event_pipe_io_cb (sdk::event_thread::io_t *io, int fd, int events)
 {
-    // handle all the events
-    handle_events(1, event_get());
+    uint32_t num_events, max_events;
+    static char event_data[AGA_SMI_EVENT_BUF_SIZE];
+
+    // drain all the events pending in the pipe
+    max_events = sizeof(event_data) / event_size_get();
+    do {
+        num_events = g_event_pipe.read_events(event_data, max_events);
+        if (num_events) {
+            handle_events(num_events, event_data);
+        }
+    } while (num_events == max_events);
 }
 
 /// \brief process an event subscribe request from client
@@ -416,8 +444,6 @@ event_monitor_timer_cb (sdk::event_thread::timer_t *timer)
 sdk_ret_t
 process_event_subscribe_req (aga_event_subscribe_args_t *req)
 {
-    gpu_event_record_t event_record = {};
-
     for (size_t i = 0; i < req->events.size(); i++) {
         AGA_TRACE_DEBUG("Rcvd event {} subscribe request, client {}, "
                         "client ctxt {}, stream {}",  req->events[i],
@@ -426,33 +452,11 @@ process_event_subscribe_req (aga_event_subscribe_args_t *req)
                         (void *)req->client_ctxt->stream);
         for (size_t g = 0; g < req->gpu_ids.size(); g++) {
             uint32_t d = req->gpu_ids[g];
-            auto& event_map = g_gpu_event_db[gpu_get_handle(d)].event_map;
-
-            // lock the event map for this device
-            SDK_SPINLOCK_LOCK(&g_gpu_event_db[gpu_get_handle(d)].slock);
-            // check if this event was of interest to any client or happened
-            // already
-            auto event_map_it = event_map.find(req->events[i]);
-            if (event_map_it == event_map.end()) {
-                // 1st time anyone is subscribing to this event
-                event_record.client_info.client_set.insert(req->client_ctxt);
-                event_map[req->events[i]] = event_record;
-            } else {
-                // atleast one client is already interested in this event, check
-                // if this particular client already subscribed to this event
-                auto set_it = event_map_it->second.client_info.client_set.find(
-                                                       req->client_ctxt);
-                if (set_it ==
-                        event_map_it->second.client_info.client_set.end()) {
-                    // this client is a new listener for this event
-                    event_map_it->second.client_info.client_set.insert(
-                                                         req->client_ctxt);
-                } else {
-                    // this client is already subscribed to this event
-                }
-            }
-            // unlock the event map for this device
-            SDK_SPINLOCK_UNLOCK(&g_gpu_event_db[gpu_get_handle(d)].slock);
+
+            // add this client to the listeners of this event, if not
+            // subscribed already
+            g_gpu_event_db[gpu_get_handle(d)].subscribers.add(
+                req->events[i], req->client_ctxt);
         }
     }
     return SDK_RET_OK;
@@ -480,18 +484,28 @@ event_subscribe_ipc_cb (sdk::ipc::ipc_msg_ptr msg, const void *ctxt)
 static void
 event_monitor_thread_init (void *ctxt)
 {
-    static sdk::event_thread::timer_t event_monitor_timer;
+    sdk_ret_t ret;
+    static sdk::event_thread::io_t event_pipe_io;
+    static sdk::event_thread::timer_t event_mock_timer;
 
     // initialize event monitoring state
-    event_monitor_init();
+    ret = event_monitor_init();
+    if (unlikely(ret != SDK_RET_OK)) {
+        AGA_TRACE_ERR("Failed to initialize event monitoring, err {}", ret());
+        return;
+    }
     // subscribe to all IPC msgs of interest
     sdk::ipc::reg_request_handler(AGA_IPC_MSG_ID_EVENT_SUBSCRIBE,
                                   event_subscribe_ipc_cb, NULL);
-    // start event monitoring timer
-    sdk::event_thread::timer_init(&event_monitor_timer, event_monitor_timer_cb,
-                                  AGA_SMI_EVENT_MONITOR_START_DELAY,
-                                  AGA_SMI_EVENT_MONITOR_INTERVAL);
-    sdk::event_thread::timer_start(&event_monitor_timer);
+    // start handling the events as soon as they are handed over
+    sdk::event_thread::io_init(&event_pipe_io, event_pipe_io_cb,
+                               g_event_pipe.read_fd(), EVENT_READ);
+    sdk::event_thread::io_start(&event_pipe_io);
+    // start generating mock events
+    sdk::event_thread::timer_init(&event_mock_timer, event_mock_timer_cb,
+                                  AGA_SMI_EVENT_MOCK_START_DELAY,
+                                  AGA_SMI_EVENT_MOCK_INTERVAL);
+    sdk::event_thread::timer_start(&event_mock_timer);
 }
 
 static void
@@ -499,9 +513,7 @@ event_monitor_thread_exit (void *ctxt)
 {
     // cleanup the event state
     for (uint32_t d = 0; d < AGA_MOCK_NUM_GPU; d++) {
-        SDK_SPINLOCK_LOCK(&g_gpu_event_db[gpu_get_handle(d)].slock);
-        g_gpu_event_db[gpu_get_handle(d)].event_map.clear();
-        SDK_SPINLOCK_UNLOCK(&g_gpu_event_db[gpu_get_handle(d)].slock);
+        g_gpu_event_db[gpu_get_handle(d)].subscribers.clear();
     }
 }
 
@@ -543,6 +555,12 @@ smi_gpu_update (aga_gpu_handle_t gpu_handle, aga_gpu_spec_t *spec,
     return SDK_RET_OK;
 }
 
+sdk_ret_t
+smi_gpu_topology_init (void)
+{
+    return SDK_RET_OK;
+}
+
 sdk_ret_t
 smi_gpu_fill_device_topology (aga_gpu_handle_t gpu_handle,
                               aga_device_topology_info_t *info)
@@ -65,6 +65,10 @@ uint64_t gpu_get_unique_id(uint32_t gpu_idx);
 /// return      pointer to event
 void *event_get(void);
 
+/// \brief      get the size of an event returned by event_get()
+/// return      size of the event
+size_t event_size_get(void);
+
 }    // namespace aga
 
 #endif    // __AGA_API_SMI_API_HPP__
@@ -23,8 +23,13 @@ limitations under the License.
 #ifndef __AGA_SMI_EVENTS_HPP__
 #define __AGA_SMI_EVENTS_HPP__
 
+#include <atomic>
+#include <memory>
 #include <unordered_map>
 #include <set>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
 #include "nic/sdk/include/sdk/base.hpp"
 #include "nic/sdk/lib/thread/thread.hpp"
 #include "nic/sdk/include/sdk/timestamp.hpp"
@@ -43,44 +48,359 @@ using std::unordered_map;
 
 namespace aga {
 
-/// \brief per client info maintained for each GPU event
-typedef struct gpu_event_client_info_s {
-    /// set of client contexts
-    set<aga_event_client_ctxt_t *> client_set;
-    /// last notified timestamp
-    timespec_t last_ntfn_ts;
-} gpu_event_client_info_t;
+/// max. number of past events remembered per GPU
+#define AGA_GPU_EVENT_HISTORY_DEPTH        256
 
-/// \brief    per event information
-typedef struct gpu_event_record_s {
+/// \brief set of clients subscribed to an event
+typedef set<aga_event_client_ctxt_t *> gpu_event_client_set_t;
+
+/// \brief    clients subscribed to the events of a GPU
+/// \remark
+///   - the set of clients of every event is published as an immutable
+///     snapshot, readers load the current snapshot with an atomic
+///     shared_ptr load and walk it without taking any lock
+///   - writers are serialized, copy the set, change the copy and publish it,
+///     so no lock is ever held while the clients are being notified
+class gpu_event_subscribers {
+public:
+    /// \brief snapshot of the clients of an event
+    typedef std::shared_ptr<const gpu_event_client_set_t> snapshot_t;
+
+    /// \brief constructor
+    gpu_event_subscribers() {
+        SDK_SPINLOCK_INIT(&slock_, PTHREAD_PROCESS_PRIVATE);
+    }
+
+    /// \brief destructor
+    ~gpu_event_subscribers() {
+        SDK_SPINLOCK_DESTROY(&slock_);
+    }
+
+    /// \brief    return the clients subscribed to an event
+    /// \param[in] event    event identifier
+    /// \return    snapshot of the clients, NULL if there are none
+    snapshot_t clients(aga_event_id_t event) const {
+        return std::atomic_load(&clients_[event]);
+    }
+
+    /// \brief    subscribe a client to an event
+    /// \param[in] event     event identifier
+    /// \param[in] client    client context
+    void add(aga_event_id_t event, aga_event_client_ctxt_t *client) {
+        gpu_event_client_set_t *clients;
+
+        SDK_SPINLOCK_LOCK(&slock_);
+        snapshot_t cur = std::atomic_load(&clients_[event]);
+        if ((cur == NULL) || (cur->find(client) == cur->end())) {
+            clients = cur ? new gpu_event_client_set_t(*cur) :
+                             new gpu_event_client_set_t();
+            clients->insert(client);
+            std::atomic_store(&clients_[event], snapshot_t(clients));
+        }
+        SDK_SPINLOCK_UNLOCK(&slock_);
+    }
+
+    /// \brief    unsubscribe a client from all the events
+    /// \param[in] client    client context
+    void remove(aga_event_client_ctxt_t *client) {
+        gpu_event_client_set_t *clients;
+
+        SDK_SPINLOCK_LOCK(&slock_);
+        for (uint32_t e = (AGA_EVENT_ID_NONE + 1); e <= AGA_EVENT_ID_MAX;
+             e++) {
+            snapshot_t cur = std::atomic_load(&clients_[e]);
+            if ((cur == NULL) || (cur->find(client) == cur->end())) {
+                continue;
+            }
+            clients = new gpu_event_client_set_t(*cur);
+            clients->erase(client);
+            std::atomic_store(&clients_[e], snapshot_t(clients));
+        }
+        SDK_SPINLOCK_UNLOCK(&slock_);
+    }
+
+    /// \brief    unsubscribe all the clients from all the events
+    void clear(void) {
+        SDK_SPINLOCK_LOCK(&slock_);
+        for (uint32_t e = (AGA_EVENT_ID_NONE + 1); e <= AGA_EVENT_ID_MAX;
+             e++) {
+            std::atomic_store(&clients_[e], snapshot_t());
+        }
+        SDK_SPINLOCK_UNLOCK(&slock_);
+    }
+
+private:
+    /// spinlock serializing the writers, readers never take it
+    sdk_spinlock_t slock_;
+    /// clients of every event indexed by event identifier
+    snapshot_t clients_[AGA_EVENT_ID_MAX + 1];
+};
+
+/// \brief    event remembered in the event history of a GPU
+typedef struct gpu_event_history_record_s {
+    /// sequence number of the event
+    uint64_t seq;
+    /// event identifier
+    aga_event_id_t id;
     /// time when the event happened
     timespec_t timestamp;
     /// event description
     char message[AGA_MAX_EVENT_STR + 1];
-    /// clients interested in this event and associated state
-    gpu_event_client_info_t client_info;
+} gpu_event_history_record_t;
+
+/// \brief    bounded history of the events of a GPU, once the ring is full
+///           the oldest event is overwritten by the new one
+/// \remark
+///   - events are added only by the event monitor thread
+///   - readers don't take any lock, every slot carries the sequence number of
+///     the event in it and a reader skips the slot if the sequence number
+///     changes while the event is being copied out (i.e., the slot got
+///     overwritten in the meantime)
+class gpu_event_ring {
+public:
+    /// \brief constructor
+    gpu_event_ring() : slot_(NULL), depth_(0), widx_(0) {}
+
+    /// \brief destructor
+    ~gpu_event_ring() {
+        delete [] slot_;
+    }
+
+    /// \brief    allocate the ring
+    /// \param[in] depth    max. number of events in the ring
+    void init(uint32_t depth) {
+        delete [] slot_;
+        slot_ = new slot_t[depth];
+        for (uint32_t i = 0; i < depth; i++) {
+            slot_[i].seq.store(0, std::memory_order_relaxed);
+        }
+        depth_ = depth;
+        widx_.store(0, std::memory_order_release);
+    }
+
+    /// \brief    add an event to the ring
+    /// \param[in] record    event to be added
+    void push(const gpu_event_history_record_t& record) {
+        uint64_t widx = widx_.load(std::memory_order_relaxed);
+        slot_t *slot;
+
+        if (unlikely(slot_ == NULL)) {
+            return;
+        }
+        slot = &slot_[widx % depth_];
+        // invalidate the slot while the event in it is being rewritten
+        slot->seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot->record = record;
+        slot->seq.store(record.seq, std::memory_order_release);
+        widx_.store(widx + 1, std::memory_order_release);
+    }
+
+    /// \brief    walk the events in the ring from the oldest to the latest
+    /// \param[in] since_seq    only events with sequence number greater than
+    ///                         this are walked
+    /// \param[in] walk_cb      callback invoked with a copy of every event
+    template <typename CB>
+    void walk(uint64_t since_seq, CB walk_cb) const {
+        uint64_t seq, widx;
+        const slot_t *slot;
+        gpu_event_history_record_t record;
 
-    /// constructor
-    gpu_event_record_s() {
-        memset(&timestamp, 0, sizeof(timestamp));
-        memset(message, 0, sizeof(message));
+        widx = widx_.load(std::memory_order_acquire);
+        for (uint64_t i = (widx > depth_) ? (widx - depth_) : 0;
+             i < widx; i++) {
+            slot = &slot_[i % depth_];
+            seq = slot->seq.load(std::memory_order_acquire);
+            if ((seq == 0) || (seq <= since_seq)) {
+                continue;
+            }
+            record = slot->record;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot->seq.load(std::memory_order_relaxed) != seq) {
+                // overwritten while being copied
+                continue;
+            }
+            walk_cb(&record);
+        }
     }
-} gpu_event_record_t;
 
-/// \brief event map with event id as the key
-typedef unordered_map<aga_event_id_t, gpu_event_record_t> gpu_event_map_t;
+private:
+    /// \brief    one entry in the ring
+    typedef struct slot_s {
+        /// sequence number of the event in the slot, 0 if the slot is empty
+        /// or being written to
+        std::atomic<uint64_t> seq;
+        /// event in the slot
+        gpu_event_history_record_t record;
+    } slot_t;
+
+private:
+    /// slots of the ring
+    slot_t *slot_;
+    /// no. of slots in the ring
+    uint32_t depth_;
+    /// no. of events added to the ring so far
+    std::atomic<uint64_t> widx_;
+};
+
+/// capacity of the pipe GPU events are handed over on (in bytes)
+#define AGA_GPU_EVENT_PIPE_SIZE            (1 << 20)
+
+/// \brief    pipe handing over the events reported by the smi layer to the
+///           event monitor thread
+/// \remark
+///   - the event monitor thread watches the read end of the pipe and handles
+///     the events as soon as they are written, events injected for testing
+///     go through the same pipe
+///   - every event is written with a single write() that is smaller than
+///     PIPE_BUF, so concurrent writers never interleave and a reader asking
+///     for a multiple of the event size always gets whole events
+///   - both ends are non-blocking, events are dropped if the event monitor
+///     thread falls behind by more than the pipe capacity
+class gpu_event_pipe {
+public:
+    /// \brief constructor
+    gpu_event_pipe() : event_size_(0) {
+        fd_[0] = fd_[1] = -1;
+        num_drops_.store(0, std::memory_order_relaxed);
+    }
+
+    /// \brief destructor
+    ~gpu_event_pipe() {
+        if (fd_[0] >= 0) {
+            close(fd_[0]);
+            close(fd_[1]);
+        }
+    }
+
+    /// \brief    create the pipe
+    /// \param[in] event_size    size of an event in the pipe
+    /// \return SDK_RET_OK or error status in case of failure
+    sdk_ret_t init(size_t event_size) {
+        if (event_size > PIPE_BUF) {
+            return SDK_RET_INVALID_ARG;
+        }
+        if (pipe2(fd_, O_NONBLOCK | O_CLOEXEC) < 0) {
+            return SDK_RET_ERR;
+        }
+        // best effort, default capacity is used if this fails
+        fcntl(fd_[1], F_SETPIPE_SZ, AGA_GPU_EVENT_PIPE_SIZE);
+        event_size_ = event_size;
+        return SDK_RET_OK;
+    }
+
+    /// \brief    return the fd to be watched for events
+    /// \return    read end of the pipe
+    int read_fd(void) const {
+        return fd_[0];
+    }
+
+    /// \brief    return the number of events dropped so far
+    /// \return    number of events dropped
+    uint64_t num_drops(void) const {
+        return num_drops_.load(std::memory_order_relaxed);
+    }
+
+    /// \brief    write events to the pipe
+    /// \param[in] events        events to be written
+    /// \param[in] num_events    number of events
+    /// \return SDK_RET_OK or error status in case some events are dropped
+    sdk_ret_t write_events(const void *events, uint32_t num_events) {
+        const char *event = (const char *)events;
+        uint32_t num_written = 0;
+
+        for (; num_written < num_events; num_written++) {
+            if (write(fd_[1], event, event_size_) != (ssize_t)event_size_) {
+                break;
+            }
+            event += event_size_;
+        }
+        if (unlikely(num_written < num_events)) {
+            num_drops_.fetch_add(num_events - num_written,
+                                 std::memory_order_relaxed);
+            return SDK_RET_NO_RESOURCE;
+        }
+        return SDK_RET_OK;
+    }
+
+    /// \brief    read the events pending in the pipe
+    /// \param[out] events        buffer to read the events into
+    /// \param[in]  max_events    max. number of events the buffer can hold
+    /// \return    number of events read
+    uint32_t read_events(void *events, uint32_t max_events) {
+        ssize_t rv;
+
+        rv = read(fd_[0], events, max_events * event_size_);
+        if (rv <= 0) {
+            return 0;
+        }
+        return (uint32_t)(rv / event_size_);
+    }
+
+private:
+    /// read and write ends of the pipe
+    int fd_[2];
+    /// size of an event
+    size_t event_size_;
+    /// number of events dropped as the pipe was full
+    std::atomic<uint64_t> num_drops_;
+};
 
 /// \brief    per GPU current event information
 typedef struct gpu_event_db_entry_s {
-    // TODO:
-    // this lock is not needed if we handle everything in the backend thread,
-    // revisit later !!
-    /// spinlock to avoid race conditions
-    sdk_spinlock_t slock;
-    /// event map indexed/keyed by event id
-    gpu_event_map_t event_map;
+    /// clients subscribed to the events of the GPU
+    gpu_event_subscribers subscribers;
+    /// recent events of the GPU
+    gpu_event_ring history;
 } gpu_event_db_entry_t;
 
+/// \brief    check if an event in the event history matches the given query
+/// \param[in] record    event in the event history
+/// \param[in] query     event history query, NULL matches all the events
+/// \return    true if the event matches the query or else false
+static inline bool
+gpu_event_query_match (const gpu_event_history_record_t *record,
+                       const aga_event_query_t *query)
+{
+    timespec_t ts = record->timestamp;
+    timespec_t start_ts, end_ts;
+
+    if (query == NULL) {
+        return true;
+    }
+    if (record->seq <= query->since_seq) {
+        return false;
+    }
+    start_ts = query->start_time;
+    if ((start_ts.tv_sec || start_ts.tv_nsec) &&
+        sdk::timestamp_before(&ts, &start_ts)) {
+        return false;
+    }
+    end_ts = query->end_time;
+    if ((end_ts.tv_sec || end_ts.tv_nsec) &&
+        sdk::timestamp_later(&ts, &end_ts)) {
+        return false;
+    }
+    return true;
+}
+
+/// \brief    fill event information from an event in the event history
+/// \param[out] event     event to be filled
+/// \param[in]  record    event in the event history
+/// \param[in]  gpu       key of the GPU the event happened on
+static inline void
+gpu_event_from_history_record (aga_event_t *event,
+                               const gpu_event_history_record_t *record,
+                               const aga_obj_key_t& gpu)
+{
+    *event = {};
+    event->seq = record->seq;
+    event->id = record->id;
+    event->timestamp = record->timestamp;
+    event->gpu = gpu;
+    memcpy(event->message, record->message, sizeof(event->message));
+}
+
 /// \brief    internal structure to hold event listener information
 typedef struct aga_event_listener_info_s {
     /// GPU id
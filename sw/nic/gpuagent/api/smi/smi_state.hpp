@@ -23,15 +23,20 @@ limitations under the License.
 #ifndef __AGA_SMI_STATE_HPP__
 #define __AGA_SMI_STATE_HPP__
 
+#include <atomic>
 #include <unordered_map>
 #include <set>
+#include <memory>
+#include <mutex>
 #include "nic/sdk/include/sdk/base.hpp"
 #include "nic/sdk/lib/thread/thread.hpp"
 #include "nic/sdk/include/sdk/timestamp.hpp"
 #include "nic/sdk/lib/event_thread/event_thread.hpp"
+#include "nic/sdk/lib/utils/thread_pool.hpp"
 #include "nic/sdk/include/sdk/lock.hpp"
 #include "nic/gpuagent/api/include/aga_init.hpp"
 #include "nic/gpuagent/api/include/aga_event.hpp"
+#include "nic/gpuagent/api/gpu_watch_sched.hpp"
 #include "nic/gpuagent/api/internal/aga_event.hpp"
 #include "nic/gpuagent/api/smi/smi_api.hpp"
 #include "nic/gpuagent/api/smi/smi_events.hpp"
@@ -46,11 +51,43 @@ using std::unordered_map;
 
 namespace aga {
 
-/// \brief event db map with processor handle as the key
-typedef unordered_map<aga_gpu_handle_t, gpu_event_db_entry_t> gpu_event_db_t;
-
-/// \brief gpu counter handle map
-typedef unordered_map<uint64_t, uintptr_t> gpu_counter_handle_t;
+/// \brief number of XGMI counters tracked per GPU, counters of
+///        AMDSMI_EVNT_GRP_XGMI group followed by those of
+///        AMDSMI_EVNT_GRP_XGMI_DATA_OUT group
+#define AGA_SMI_XGMI_COUNTER_MAX                                           \
+    ((AMDSMI_EVNT_XGMI_LAST - AMDSMI_EVNT_XGMI_FIRST + 1) +                \
+     (AMDSMI_EVNT_XGMI_DATA_OUT_LAST - AMDSMI_EVNT_XGMI_DATA_OUT_FIRST + 1))
+
+/// \brief per GPU state of the smi layer, kept in a dense table indexed by
+///        GPU id (i.e., gpu_entry::id()) so that hot paths of the watcher
+///        and event monitor don't need any hash lookups
+typedef struct gpu_slot_s {
+    /// GPU handle
+    aga_gpu_handle_t handle;
+    /// XGMI counter handles, 0 if the counter is not created
+    amdsmi_event_handle_t xgmi_counter[AGA_SMI_XGMI_COUNTER_MAX];
+    /// current event state of the GPU
+    gpu_event_db_entry_t event_db;
+} __ALIGN__(AGA_CACHE_LINE_SIZE) gpu_slot_t;
+
+/// \brief link between a pair of GPUs
+typedef struct gpu_topo_link_s {
+    /// IO link type of the link
+    aga_io_link_type_t type;
+    /// distance in terms of no. of hops
+    uint64_t num_hops;
+    /// weight assigned to the link
+    uint64_t weight;
+} gpu_topo_link_t;
+
+/// \brief links between all pairs of GPUs indexed by GPU ids
+typedef struct gpu_topo_matrix_s {
+    gpu_topo_link_t link[AGA_MAX_GPU][AGA_MAX_GPU];
+} gpu_topo_matrix_t;
+
+/// \brief topology matrix published to the readers, never modified once
+///        published
+typedef std::shared_ptr<const gpu_topo_matrix_t> gpu_topo_matrix_ptr_t;
 
 /// \brief  smi_state class contains state of smi client
 class smi_state {
@@ -58,6 +95,16 @@ public:
     /// \brief constructor
     smi_state() {
         num_gpu_ = 0;
+        event_seq_ = 0;
+        event_reader_thread_ = NULL;
+        event_reader_stop_ = false;
+        for (uint32_t d = 0; d < AGA_MAX_GPU; d++) {
+            gpu_slot_[d].handle = NULL;
+            memset(gpu_slot_[d].xgmi_counter, 0,
+                   sizeof(gpu_slot_[d].xgmi_counter));
+        }
+        watcher_tpool_ = NULL;
+        watcher_num_workers_ = 0;
     }
 
     /// \brief    destructor
@@ -87,15 +134,47 @@ public:
     /// \return SDK_RET_OK or error status in case of failure
     sdk_ret_t handle_events(uint32_t num_events, void *event_buffer);
 
+    /// \brief    return the pipe the GPU events are handed over on to the
+    ///           event monitor thread
+    /// \return    event pipe
+    gpu_event_pipe *event_pipe(void) { return &event_pipe_; }
+
+    /// \brief    check if the event reader thread is asked to exit
+    /// \return    true if the event reader thread must exit
+    bool event_reader_stopped(void) const {
+        return event_reader_stop_.load(std::memory_order_acquire);
+    }
+
     /// \brief    return number of GPUs in the node
     /// \return    number of GPUs
     uint32_t num_gpu(void) const { return num_gpu_; }
 
+    /// \brief    (re)build the topology matrix of all the GPUs, links of
+    ///           different GPUs are read from amdsmi in parallel
+    /// \return SDK_RET_OK or error status in case of failure
+    sdk_ret_t topo_build(void);
+
+    /// \brief    drop the topology matrix, it is rebuilt on next read
+    void topo_invalidate(void) {
+        std::atomic_store(&topo_, gpu_topo_matrix_ptr_t());
+    }
+
+    /// \brief    return the topology matrix, building it if needed
+    /// \return    topology matrix or NULL in case of failure
+    gpu_topo_matrix_ptr_t topo(void);
+
+    /// \brief    read the links from a GPU to all the other GPUs
+    /// \param[in]  gpu_id    GPU id
+    /// \param[out] matrix    matrix to be filled
+    void topo_read_links(uint32_t gpu_id, gpu_topo_matrix_t *matrix);
+
     /// \brief    read all the events and invokve the callback provided for each
-    /// \param[in] cb    callback function pointer
-    /// \param[in] ctxt  opaque context passed back to the callback
+    /// \param[in] cb       callback function pointer
+    /// \param[in] ctxt     opaque context passed back to the callback
+    /// \param[in] query    if not NULL, only events matching the query are read
     /// \return     SDK_RET_OK or error code in case of failure
-    sdk_ret_t event_read(aga_event_read_cb_t cb, void *ctxt);
+    sdk_ret_t event_read(aga_event_read_cb_t cb, void *ctxt,
+                         const aga_event_query_t *query);
 
     /// \brief    process incoming event generate requests
     /// \param[in] args    pointer to event generate request
@@ -124,11 +203,34 @@ public:
      /// \return SDK_RET_OK or error status in case of failure
      sdk_ret_t watcher_update_watch_db(aga_gpu_watch_db_t *watch_db);
 
+     /// \brief    read the given watch attributes of a GPU right away, for
+     ///           readers that can't wait for the watcher to sample them
+     /// \param[in]     gpu_id    GPU id
+     /// \param[in]     attrs     attributes to be read
+     /// \param[in,out] fields    watch fields, only the fields of the given
+     ///                          attributes are updated
+     /// \return SDK_RET_OK or error status in case of failure
+     sdk_ret_t gpu_watch_fields_read(uint32_t gpu_id,
+                                     const aga_gpu_watch_attr_set_t& attrs,
+                                     aga_gpu_watch_fields_t *fields);
+
+     /// \brief    get and update watch fields of a given GPU, and record the
+     ///           time taken to collect them
+     /// \param[in]  gpu_id      GPU id
+     /// \param[out] watch_db    db to be updated
+     /// \return SDK_RET_OK or error status in case of failure
+     sdk_ret_t watcher_update_gpu_watch_fields(uint32_t gpu_id,
+                                               aga_gpu_watch_db_t *watch_db);
+
 private:
     /// \brief spawn event monitor thread
     /// \return SDK_RET_OK or error status in case of failure
     sdk_ret_t spawn_event_monitor_thread_(void);
 
+    /// \brief spawn the thread that blocks waiting for GPU events
+    /// \return SDK_RET_OK or error status in case of failure
+    sdk_ret_t spawn_event_reader_thread_(void);
+
     /// \brief spawn watcher thread
     /// \return SDK_RET_OK or error status in case of failure
     sdk_ret_t spawn_watcher_thread_(void);
@@ -139,35 +241,74 @@ private:
     sdk_ret_t cleanup_event_listeners_(
                   vector<aga_event_listener_info_t>& listeners);
 
+    /// \brief replay the events of interest in the event history to a new
+    ///        subscriber
+    /// \param[in] req    event subscription request
+    /// \return SDK_RET_OK or error status in case of failure
+    sdk_ret_t replay_events_(aga_event_subscribe_args_t *req);
+
     /// \brief  clearnup inactive gpu watch subscribers
     /// \param[in] subscribers    list of inactive subscribers
     /// \return SDK_RET_OK or error status in case of failure
     sdk_ret_t cleanup_gpu_watch_inactive_subscribers_(
                   vector<gpu_watch_subscriber_info_t>& subscribers);
 
+    /// \brief    build and publish the topology matrix, caller holds the
+    ///           topology lock
+    /// \return SDK_RET_OK or error status in case of failure
+    sdk_ret_t topo_build_(void);
+
+    /// \brief    read an XGMI counter of a GPU
+    /// \param[in]  gpu_id           GPU id
+    /// \param[in]  event_type       XGMI counter event type
+    /// \param[out] counter_value    counter value read
+    /// \return true if the counter is read or else false
+    bool xgmi_counter_read_(uint32_t gpu_id, amdsmi_event_type_t event_type,
+                            amdsmi_counter_value_t *counter_value);
+
     /// \brief    update watcher fields of interest
     /// \param[in]  gpu_id      GPU id
     /// \param[in]  gpu_handle  GPU handle
-    /// \param[out] watch_db    db to be updated
+    /// \param[in]  due         attributes to be sampled
+    /// \param[in]  refresh     true to bypass the smi cache and refresh it
+    /// \param[out] fields      watch fields to be updated, only the fields
+    ///                         of the attributes sampled are touched
     /// \return SDK_RET_OK or error status in case of failure
     sdk_ret_t smi_watcher_update_all_watch_fields_(uint32_t gpu_id,
-                  aga_gpu_handle_t gpu_handle, aga_gpu_watch_db_t *watch_db);
+                  aga_gpu_handle_t gpu_handle,
+                  const aga_gpu_watch_attr_set_t& due, bool refresh,
+                  aga_gpu_watch_fields_t *fields);
 
 private:
     /// no. of GPUs in the system
     uint32_t num_gpu_;
-    /// gpu handles
-    aga_gpu_handle_t gpu_handles_[AGA_MAX_GPU];
-    /// gpu cpunter handles
-    gpu_counter_handle_t counter_handle_;
+    /// per GPU state indexed by GPU id
+    gpu_slot_t gpu_slot_[AGA_MAX_GPU];
+    /// sequence number of the last event reported, updated only by the event
+    /// monitor thread
+    uint64_t event_seq_;
     /// event monitor thread instance
     sdk::event_thread::event_thread *event_monitor_thread_;
+    /// event reader thread instance
+    sdk::lib::thread *event_reader_thread_;
+    /// set to ask the event reader thread to exit after its current poll
+    std::atomic<bool> event_reader_stop_;
+    /// pipe from the event reader thread to the event monitor thread
+    gpu_event_pipe event_pipe_;
     /// watcher thread instance
     sdk::event_thread::event_thread *watcher_thread_;
-    /// event database map
-    gpu_event_db_t gpu_event_db_;
+    /// worker pool used by the watcher to sample GPUs in parallel
+    sdk::lib::thread_pool *watcher_tpool_;
+    /// no. of workers in the watcher pool
+    uint32_t watcher_num_workers_;
+    /// attributes due for sampling on each GPU in the current watcher tick
+    aga_gpu_watch_attr_set_t watcher_due_attrs_[AGA_MAX_GPU];
     /// gpu watch database
     gpu_watch_subscriber_db_t gpu_watch_subscriber_db_;
+    /// lock serializing the topology matrix builds
+    std::mutex topo_lock_;
+    /// topology matrix of all the GPUs, NULL if not built yet or invalidated
+    gpu_topo_matrix_ptr_t topo_;
 };
 
 /// global singleton smi state class instance
@@ -30,6 +30,7 @@ limitations under the License.
 #include "nic/sdk/lib/thread/thread.hpp"
 #include "nic/sdk/lib/event_thread/event_thread.hpp"
 #include "nic/gpuagent/api/internal/aga_gpu_watch.hpp"
+#include "nic/gpuagent/api/gpu_watch_agg.hpp"
 #include "nic/gpuagent/api/include/aga_init.hpp"
 
 using std::set;
@@ -45,6 +46,9 @@ namespace aga {
 typedef struct gpu_watch_client_info_s {
     /// set of client contexts
     set<aga_gpu_watch_client_ctxt_t *> client_set;
+    /// statistics of the current aggregation window, if the watch is
+    /// aggregated
+    gpu_watch_agg agg;
 } gpu_watch_client_info_t;
 
 /// \brief gpu watch and client context map with gpu watch id as the key
@@ -104,37 +104,11 @@ task::handle_gpu_reset_task_(aga_gpu_reset_task_spec_t *spec) {
         }
     }
     ret = smi_gpu_reset(gpu->handle(), spec->reset_type);
+    // reset brings back the defaults, refresh the cached spec/status
+    gpu->cache_invalidate();
     return ret;
 }
 
-typedef struct gpu_update_watch_cb_ctxt_s {
-    aga_gpu_watch_db_t *watch_db;
-} gpu_update_watch_cb_ctxt_t;
-
-static inline bool
-gpu_update_watch_cb (void *obj, void *ctxt)
-{
-    aga_gpu_watch_db_t *watch_db;
-    gpu_entry *gpu = (gpu_entry *)obj;
-    gpu_update_watch_cb_ctxt_t *cb_ctxt;
-
-    cb_ctxt = (gpu_update_watch_cb_ctxt_t *)ctxt;
-    watch_db = cb_ctxt->watch_db;
-
-    gpu->update_stats(&watch_db->watch_info[gpu->id()]);
-    return false;
-}
-
-sdk_ret_t
-task::handle_gpu_update_watch_db_task_(aga_gpu_watch_db_t *watch_db) {
-    gpu_update_watch_cb_ctxt_t ctxt;
-
-    ctxt.watch_db = watch_db;
-    // walk over all gpus and update stats
-    gpu_db()->walk_handle_db(gpu_update_watch_cb, &ctxt);
-    return SDK_RET_OK;
-}
-
 sdk_ret_t
 task::handle_gpu_watch_subscriber_add_task_(
           aga_gpu_watch_subscriber_spec_t *spec) {
@@ -176,9 +150,6 @@ task::create_handler(api_params_base *api_params) {
     case AGA_TASK_GPU_RESET:
         ret = handle_gpu_reset_task_(&spec->gpu_reset_task_spec);
         break;
-    case AGA_TASK_GPU_WATCH_DB_UPDATE:
-        ret = handle_gpu_update_watch_db_task_(&spec->watch_db);
-        break;
     case AGA_TASK_GPU_WATCH_SUBSCRIBE_ADD:
         ret = handle_gpu_watch_subscriber_add_task_(&spec->subscriber_spec);
         break;
@@ -92,11 +92,6 @@ private:
     /// \return   SDK_RET_OK or error code
     sdk_ret_t handle_gpu_reset_task_(aga_gpu_reset_task_spec_t *spec);
 
-    /// \brief    update watch db task
-    /// \param[in] watch_db   GPU stats watch db
-    /// \return   SDK_RET_OK or error code
-    sdk_ret_t handle_gpu_update_watch_db_task_(aga_gpu_watch_db_t *watch_db);
-
     /// \brief    handle GPU watch subscriber add task
     /// \param[in] spec    GPU watch subscriber spec
     /// \return   SDK_RET_OK or error code
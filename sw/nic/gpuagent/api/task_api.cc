@@ -50,7 +50,7 @@ aga_task_api_handle (api_op_t op, aga_obj_key_t *key, aga_task_spec_t *spec)
         } else {
             AGA_API_PARAMS_FROM_API_CTXT(api_ctxt)->task_spec = *spec;
         }
-        return process_api(api_ctxt);
+        return process_api(AGA_BATCH_CTXT_INVALID, api_ctxt);
     }
     return SDK_RET_OOM;
 }
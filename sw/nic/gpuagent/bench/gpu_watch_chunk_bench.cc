@@ -0,0 +1,198 @@
+
+/*
+Copyright (c) Advanced Micro Devices, Inc. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+//----------------------------------------------------------------------------
+///
+/// \file
+/// standalone benchmark of the GPU watch history chunk encoding, feeds
+/// synthetic series shaped like the watched attributes through
+/// gpu_watch_chunk and reports the compression and encode/decode rates
+///
+/// usage: gpu_watch_chunk_bench [num-samples]
+///
+//----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <random>
+#include <vector>
+#include "nic/sdk/include/sdk/timestamp.hpp"
+#include "nic/gpuagent/api/gpu_watch_history.hpp"
+
+using aga::gpu_watch_chunk;
+
+/// default no. of samples fed per series
+#define GPU_WATCH_CHUNK_BENCH_SAMPLES    (1 << 20)
+
+/// \brief    shape of a synthetic series
+typedef enum gpu_watch_bench_series_e {
+    /// value that never changes (e.g., clocks of an idle GPU)
+    GPU_WATCH_BENCH_SERIES_STEADY,
+    /// value that drifts a little every sample (e.g., power, temperature)
+    GPU_WATCH_BENCH_SERIES_GAUGE,
+    /// counter that rarely moves (e.g., ECC error counters)
+    GPU_WATCH_BENCH_SERIES_ECC,
+    GPU_WATCH_BENCH_SERIES_MAX,
+} gpu_watch_bench_series_t;
+
+static const char *g_series_name[GPU_WATCH_BENCH_SERIES_MAX] = {
+    "steady",
+    "gauge",
+    "ecc",
+};
+
+/// \brief     generate the samples of a synthetic series, timestamps follow
+///            the history interval with the occasional jitter of the
+///            watcher timer
+/// \param[in]  type           shape of the series
+/// \param[in]  num_samples    no. of samples to generate
+/// \param[out] ts             sample timestamps (in milliseconds)
+/// \param[out] values         sample values
+static void
+gen_series_ (gpu_watch_bench_series_t type, uint32_t num_samples,
+             std::vector<uint64_t>& ts, std::vector<uint64_t>& values)
+{
+    std::mt19937_64 rng(type);
+    uint64_t now = 1700000000000ULL, value;
+
+    ts.resize(num_samples);
+    values.resize(num_samples);
+    if (type == GPU_WATCH_BENCH_SERIES_GAUGE) {
+        value = 300;
+    } else if (type == GPU_WATCH_BENCH_SERIES_ECC) {
+        value = 0;
+    } else {
+        value = 1700;
+    }
+    for (uint32_t i = 0; i < num_samples; i++) {
+        now += AGA_GPU_WATCH_HISTORY_INTERVAL;
+        ts[i] = now;
+        if ((rng() % 16) == 0) {
+            ts[i] += rng() % 8;
+        }
+        switch (type) {
+        case GPU_WATCH_BENCH_SERIES_GAUGE:
+            value += (rng() % 7) - 3;
+            break;
+        case GPU_WATCH_BENCH_SERIES_ECC:
+            if ((rng() % 1000) == 0) {
+                value++;
+            }
+            break;
+        default:
+            break;
+        }
+        values[i] = value;
+    }
+}
+
+/// \brief     return the time elapsed since the given start time
+/// \param[in] start_ts    start time
+/// \return    elapsed time (in nanoseconds)
+static uint64_t
+elapsed_ns_ (timespec_t *start_ts)
+{
+    uint64_t ns;
+    timespec_t end_ts, diff_ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &end_ts);
+    diff_ts = sdk::timestamp_diff(&end_ts, start_ts);
+    sdk::timestamp_to_nsecs(&diff_ts, &ns);
+    return ns;
+}
+
+/// \brief     feed a synthetic series through the chunks and report the
+///            results
+/// \param[in] type           shape of the series
+/// \param[in] num_samples    no. of samples to feed
+/// \return    0 if the decoded samples match the encoded ones, -1 otherwise
+static int
+bench_series_ (gpu_watch_bench_series_t type, uint32_t num_samples)
+{
+    size_t num_bytes = 0;
+    uint32_t idx = 0, num_bad = 0;
+    timespec_t start_ts;
+    uint64_t encode_ns, decode_ns;
+    std::vector<gpu_watch_chunk> chunks;
+    std::vector<uint64_t> ts, values;
+
+    gen_series_(type, num_samples, ts, values);
+    chunks.reserve((num_samples / AGA_GPU_WATCH_HISTORY_CHUNK_SAMPLES) + 1);
+    // encode, same chunking as the history uses
+    clock_gettime(CLOCK_MONOTONIC, &start_ts);
+    for (uint32_t i = 0; i < num_samples; i++) {
+        if (chunks.empty() || (chunks.back().num_samples() >=
+                                   AGA_GPU_WATCH_HISTORY_CHUNK_SAMPLES)) {
+            if (!chunks.empty()) {
+                chunks.back().seal();
+            }
+            chunks.emplace_back(ts[i], values[i]);
+        } else {
+            chunks.back().append(ts[i], values[i]);
+        }
+    }
+    encode_ns = elapsed_ns_(&start_ts);
+    for (const auto& chunk : chunks) {
+        num_bytes += chunk.mem_size();
+    }
+    // decode and verify
+    clock_gettime(CLOCK_MONOTONIC, &start_ts);
+    for (const auto& chunk : chunks) {
+        chunk.walk([&](uint64_t t, uint64_t v) {
+            if ((t != ts[idx]) || (v != values[idx])) {
+                num_bad++;
+            }
+            idx++;
+            return false;
+        });
+    }
+    decode_ns = elapsed_ns_(&start_ts);
+    printf("%-8s %10u %12.2f %12.2f %12.2f %12.2f\n",
+           g_series_name[type], num_samples,
+           (double)num_bytes / num_samples,
+           (double)(2 * sizeof(uint64_t)) * num_samples / num_bytes,
+           (double)encode_ns / num_samples, (double)decode_ns / num_samples);
+    if ((idx != num_samples) || num_bad) {
+        fprintf(stderr, "%s: decoded %u of %u samples, %u mismatches\n",
+                g_series_name[type], idx, num_samples, num_bad);
+        return -1;
+    }
+    return 0;
+}
+
+int
+main (int argc, char **argv)
+{
+    int rv = 0;
+    uint32_t num_samples = GPU_WATCH_CHUNK_BENCH_SAMPLES;
+
+    if (argc > 1) {
+        num_samples = strtoul(argv[1], NULL, 0);
+        if (num_samples == 0) {
+            fprintf(stderr, "usage: %s [num-samples]\n", argv[0]);
+            return 1;
+        }
+    }
+    printf("%-8s %10s %12s %12s %12s %12s\n", "series", "samples",
+           "bytes/sample", "ratio", "ns/encode", "ns/decode");
+    for (uint32_t t = 0; t < GPU_WATCH_BENCH_SERIES_MAX; t++) {
+        if (bench_series_((gpu_watch_bench_series_t)t, num_samples) < 0) {
+            rv = 1;
+        }
+    }
+    return rv;
+}
@@ -45,6 +45,7 @@ var (
 	eventIdList      []aga.EventId
 	eventGpuId       string
 	eventGpuUuids    [][]byte
+	eventSeqNum      uint64
 )
 
 var eventShowCmd = &cobra.Command{
@@ -83,6 +84,7 @@ func init() {
 	eventShowCmd.Flags().StringVarP(&eventGpuId, "gpu", "g", "", "Specify comma separated list of GPU ids")
 	eventShowCmd.Flags().StringVar(&eventSeverityStr, "severity", "debug", "Specify severity of events of interest (debug, info, warn, critical)")
 	eventShowCmd.Flags().Uint32Var(&eventCategoryNum, "category", 0, "Specify category of events of interest")
+	eventShowCmd.Flags().Uint64Var(&eventSeqNum, "since-seq", 0, "Specify sequence number after which events are of interest")
 	//eventShowCmd.Flags().MarkHidden("category")
 	//eventShowCmd.Flags().MarkHidden("severity")
 
@@ -90,6 +92,7 @@ func init() {
 	eventDebugCmd.AddCommand(eventSubscribeCmd)
 	eventSubscribeCmd.Flags().StringVar(&eventList, "event-id", "", "Specify comma separated list of events of interest (1-5)")
 	eventSubscribeCmd.Flags().StringVarP(&eventGpuId, "gpu", "g", "", "Specify comma separated list of GPU ids")
+	eventSubscribeCmd.Flags().Uint64Var(&eventSeqNum, "resume-seq", 0, "Specify sequence number of the first past event to be replayed")
 	eventSubscribeCmd.MarkFlagRequired("gpu")
 	eventSubscribeCmd.MarkFlagRequired("event-id")
 
@@ -190,6 +193,7 @@ func eventShowCmdPreRunE(cmd *cobra.Command, args []string) error {
 }
 
 func printEvent(event *aga.Event) {
+	fmt.Printf("%-20s : %d\n", "Sequence Number", event.GetSeqNum())
 	fmt.Printf("%-20s : %s\n", "Event Id", event.GetId().String())
 	fmt.Printf("%-20s : %s\n", "GPU Id", utils.IdToStr(event.GetGPU()))
 	fmt.Printf("%-20s : %s\n", "Severity", event.GetSeverity().String())
@@ -238,6 +242,7 @@ func eventSubscribeCmdHandler(cmd *cobra.Command, args []string) error {
 		},
 		Gpu: eventGpuUuids,
 	}
+	req.ResumeSeqNum = eventSeqNum
 	// connect to GPU agent
 	c, ctxt, cancel, err := utils.CreateNewAGAGRPClient()
 	if err != nil {
@@ -291,6 +296,7 @@ func eventShowCmdHandler(cmd *cobra.Command, args []string) error {
 	if cmd.Flags().Changed("gpu") {
 		req.Filter.Gpu = eventGpuUuids
 	}
+	req.SinceSeqNum = eventSeqNum
 	// connect to GPU agent
 	c, ctxt, cancel, err := utils.CreateNewAGAGRPClient()
 	if err != nil {
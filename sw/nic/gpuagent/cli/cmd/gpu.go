@@ -41,6 +41,7 @@ import (
 
 var (
 	gpuID               string
+	gpuLiveRead         bool
 	gpuAdminState       string
 	overDriveLevel      uint32
 	powerCap            uint64
@@ -132,6 +133,8 @@ func init() {
 	gpuShowCmd.Flags().StringVarP(&gpuID, "id", "i", "", "Specify GPU id")
 	gpuShowCmd.Flags().BoolP("partitioned", "p", false,
 		"Show only partitioned GPUs")
+	gpuShowCmd.Flags().BoolVar(&gpuLiveRead, "live", false,
+		"Read GPU information from the GPU instead of agent's cache")
 
 	gpuShowCmd.AddCommand(gpuAllShowCmd)
 	gpuAllShowCmd.Flags().StringVarP(&gpuID, "id", "i", "", "Specify GPU id")
@@ -334,6 +337,7 @@ func gpuShowCmdHandler(cmd *cobra.Command, args []string) error {
 			Id: [][]byte{},
 		}
 	}
+	req.LiveRead = gpuLiveRead
 
 	// connect to GPU agent
 	c, ctxt, cancel, err := utils.CreateNewAGAGRPClient()
@@ -1433,6 +1437,11 @@ func printGPUStats(gpu *aga.GPU, statsOnly bool) {
 		fmt.Printf(indent+"%-38s : %d\n", "HBM thermal residency accumulated",
 			vStats.GetHBMThermalResidencyAccumulated())
 	}
+	if stats.GetWatchCollectionLatency() != 0 {
+		fmt.Printf(indent+"%-38s : %d\n",
+			"Stats collection latency (in usecs)",
+			stats.GetWatchCollectionLatency())
+	}
 
 	fmt.Printf("\n%s\n", strings.Repeat("-", 80))
 }
@@ -28,7 +28,9 @@ import (
 	"encoding/json"
 	"fmt"
 	"io"
+	"strconv"
 	"strings"
+	"time"
 
 	uuid "github.com/satori/go.uuid"
 	"github.com/spf13/cobra"
@@ -47,6 +49,16 @@ var (
 	gpuWatchAttrsStr string
 	gpuWatchAttrs    []string
 	gpuWatchAttrIDs  []aga.GPUWatchAttrId
+	gpuWatchInterval uint32
+	gpuWatchDuration uint32
+	gpuWatchRes      uint32
+	gpuWatchAggWin   uint32
+	gpuWatchAggStr   string
+	gpuWatchAggStats []aga.GPUWatchAggStat
+	gpuWatchChanges  bool
+	gpuWatchKeyframe uint32
+	gpuWatchDbStr    string
+	gpuWatchDeadband []*aga.GPUWatchDeadband
 )
 
 var gpuWatchCreateCmd = &cobra.Command{
@@ -85,6 +97,14 @@ var gpuWatchStatsShowCmd = &cobra.Command{
 	RunE:  gpuWatchStatsShowCmdHandler,
 }
 
+var gpuWatchHistoryShowCmd = &cobra.Command{
+	Use:     "history",
+	Short:   "show GPU watch history",
+	Long:    "show samples of GPU attributes remembered by the agent",
+	PreRunE: gpuWatchHistoryShowCmdPreRun,
+	RunE:    gpuWatchHistoryShowCmdHandler,
+}
+
 var gpuWatchDebugCmd = &cobra.Command{
 	Use:   "gpu-watch",
 	Short: "GPU watch object",
@@ -110,6 +130,16 @@ func init() {
 			"(gpu-clock, memory-clock, memory-temp, gpu-temp, power-usage, "+
 			"ecc-total, pcie-bandwidth, gpu-util, memory-usage, ecc-count, "+
 			"xgmi-tx, xgmi-throughput)")
+	gpuWatchCreateCmd.Flags().Uint32VarP(&gpuWatchInterval,
+		"sampling-interval", "s", 0, "Specify sampling interval in "+
+			"milliseconds, must be a multiple of 100 (default 5000)")
+	gpuWatchCreateCmd.Flags().Uint32VarP(&gpuWatchAggWin,
+		"aggregation-window", "w", 0, "Specify aggregation window in "+
+			"milliseconds, must be a multiple of sampling interval")
+	gpuWatchCreateCmd.Flags().StringVarP(&gpuWatchAggStr,
+		"aggregation-stats", "t", "", "Specify comma separated list of "+
+			"statistics computed over every aggregation window (min, max, "+
+			"avg, p50, p90, p95, p99) (default min,max,avg)")
 	gpuWatchCreateCmd.MarkFlagRequired("id")
 	gpuWatchCreateCmd.MarkFlagRequired("gpu")
 	gpuWatchCreateCmd.MarkFlagRequired("attr")
@@ -134,169 +164,214 @@ func init() {
 	gpuWatchStatsShowCmd.Flags().StringVarP(&gpuWatchID, "id", "i", "",
 		"Specify GPU watch id")
 
+	gpuWatchShowCmd.AddCommand(gpuWatchHistoryShowCmd)
+	gpuWatchHistoryShowCmd.Flags().StringVarP(&gpuWatchGPUsStr, "gpu", "g",
+		"", "Specify comma separated list of GPUs (default all GPUs)")
+	gpuWatchHistoryShowCmd.Flags().StringVarP(&gpuWatchAttrsStr, "attr", "a",
+		"", "Specify comma separated list of attributes (same as the ones "+
+			"accepted by create gpu-watch)")
+	gpuWatchHistoryShowCmd.Flags().Uint32VarP(&gpuWatchDuration,
+		"duration", "d", 60, "Specify how far back to look in seconds")
+	gpuWatchHistoryShowCmd.Flags().Uint32VarP(&gpuWatchRes,
+		"resolution", "r", 0, "Specify resolution in milliseconds, only the "+
+			"latest sample in every such window is shown")
+	gpuWatchHistoryShowCmd.MarkFlagRequired("attr")
+
 	debugCmd.AddCommand(gpuWatchDebugCmd)
 	gpuWatchDebugCmd.AddCommand(gpuWatchSubscribeCmd)
 	gpuWatchSubscribeCmd.Flags().StringVarP(&gpuWatchID, "id", "i", "",
 		"Specify comma separated list of GPU watch ids to subscribe")
+	gpuWatchSubscribeCmd.Flags().BoolVarP(&gpuWatchChanges, "changes-only",
+		"c", false, "Receive only the attributes that changed")
+	gpuWatchSubscribeCmd.Flags().Uint32VarP(&gpuWatchKeyframe,
+		"keyframe-interval", "k", 0, "Specify interval in milliseconds at "+
+			"which all the attributes are received anyway with "+
+			"--changes-only (default 60000)")
+	gpuWatchSubscribeCmd.Flags().StringVarP(&gpuWatchDbStr, "deadband", "d",
+		"", "Specify comma separated list of <attr>=<threshold>, changes "+
+			"upto the threshold are not received with --changes-only")
 	gpuWatchSubscribeCmd.MarkFlagRequired("id")
 }
 
-func gpuWatchCreateCmdPreRun(cmd *cobra.Command, args []string) error {
-	if cmd == nil {
-		return fmt.Errorf("Invalid argument")
-	}
-	if err := utils.IsUUIDValid(gpuWatchID); err != nil {
-		return err
-	}
-	gpuWatchGPUs := strings.Split(gpuWatchGPUsStr, ",")
-	for _, gpu := range gpuWatchGPUs {
-		if err := utils.IsUUIDValid(gpu); err != nil {
-			return err
-		}
-		gpuWatchGPUIDs = append(gpuWatchGPUIDs,
-			uuid.FromStringOrNil(gpu).Bytes())
-	}
-	gpuWatchAttrs := strings.Split(gpuWatchAttrsStr, ",")
+// gpuWatchAttrsParse converts a comma separated list of attribute names to
+// the list of attribute ids
+func gpuWatchAttrsParse(attrsStr string) ([]aga.GPUWatchAttrId, error) {
+	var attrIDs []aga.GPUWatchAttrId
+	gpuWatchAttrs := strings.Split(attrsStr, ",")
 	for _, attr := range gpuWatchAttrs {
 		switch strings.ToLower(attr) {
 		case "gpu-clock":
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_GPU_CLOCK)
 		case "memory-clock":
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_MEM_CLOCK)
 		case "memory-temp":
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_MEMORY_TEMP)
 		case "gpu-temp":
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_GPU_TEMP)
 		case "power-usage":
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_POWER_USAGE)
 		case "ecc-total":
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_CORRECT_TOTAL)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_UNCORRECT_TOTAL)
 		case "pcie-bandwidth":
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_PCIE_BANDWIDTH)
 		case "gpu-util":
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_GPU_UTIL)
 		case "memory-usage":
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_GPU_MEMORY_USAGE)
 		case "ecc-count":
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_SDMA_CE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_SDMA_UE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_GFX_CE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_GFX_UE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_MMHUB_CE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_MMHUB_UE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_ATHUB_CE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_ATHUB_UE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_PCIE_BIF_CE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_PCIE_BIF_UE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_HDP_CE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_HDP_UE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_XGMI_WAFL_CE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_XGMI_WAFL_UE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_DF_CE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_DF_UE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_SMN_CE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_SMN_UE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_SEM_CE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_SEM_UE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_MP0_CE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_MP0_UE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_MP1_CE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_MP1_UE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_FUSE_CE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_FUSE_UE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_UMC_CE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_UMC_UE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_MCA_CE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_MCA_UE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_VCN_CE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_VCN_UE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_JPEG_CE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_JPEG_UE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_IH_CE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_IH_UE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_MPIO_CE)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_ECC_MPIO_UE)
 		case "xgmi-tx":
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_XGMI_0_NOP_TX)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_XGMI_1_NOP_TX)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_XGMI_0_REQ_TX)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_XGMI_1_REQ_TX)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_XGMI_0_RESP_TX)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_XGMI_1_RESP_TX)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_XGMI_0_BEATS_TX)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_XGMI_1_BEATS_TX)
 		case "xgmi-throughput":
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_XGMI_0_THRPUT)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_XGMI_1_THRPUT)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_XGMI_2_THRPUT)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_XGMI_3_THRPUT)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_XGMI_4_THRPUT)
-			gpuWatchAttrIDs = append(gpuWatchAttrIDs,
+			attrIDs = append(attrIDs,
 				aga.GPUWatchAttrId_GPU_WATCH_ATTR_ID_XGMI_5_THRPUT)
 		default:
-			return fmt.Errorf("Invalid GPU watch attribute specified")
+			return nil, fmt.Errorf("Invalid GPU watch attribute specified")
+		}
+	}
+	return attrIDs, nil
+}
+
+func gpuWatchCreateCmdPreRun(cmd *cobra.Command, args []string) error {
+	if cmd == nil {
+		return fmt.Errorf("Invalid argument")
+	}
+	if err := utils.IsUUIDValid(gpuWatchID); err != nil {
+		return err
+	}
+	gpuWatchGPUs := strings.Split(gpuWatchGPUsStr, ",")
+	for _, gpu := range gpuWatchGPUs {
+		if err := utils.IsUUIDValid(gpu); err != nil {
+			return err
+		}
+		gpuWatchGPUIDs = append(gpuWatchGPUIDs,
+			uuid.FromStringOrNil(gpu).Bytes())
+	}
+	attrIDs, err := gpuWatchAttrsParse(gpuWatchAttrsStr)
+	if err != nil {
+		return err
+	}
+	gpuWatchAttrIDs = attrIDs
+	if cmd.Flags().Changed("aggregation-stats") {
+		for _, stat := range strings.Split(gpuWatchAggStr, ",") {
+			val, ok := aga.GPUWatchAggStat_value["GPU_WATCH_AGG_STAT_"+
+				strings.ToUpper(stat)]
+			if !ok || val == 0 {
+				return fmt.Errorf("Invalid aggregation statistic %s", stat)
+			}
+			gpuWatchAggStats = append(gpuWatchAggStats,
+				aga.GPUWatchAggStat(val))
 		}
 	}
 	return nil
@@ -308,9 +383,12 @@ func gpuWatchCreateCmdHandler(cmd *cobra.Command, args []string) error {
 	}
 	cmd.SilenceUsage = true
 	spec := &aga.GPUWatchSpec{
-		Id:        uuid.FromStringOrNil(gpuWatchID).Bytes(),
-		GPU:       gpuWatchGPUIDs,
-		Attribute: gpuWatchAttrIDs,
+		Id:                uuid.FromStringOrNil(gpuWatchID).Bytes(),
+		GPU:               gpuWatchGPUIDs,
+		Attribute:         gpuWatchAttrIDs,
+		SamplingInterval:  gpuWatchInterval,
+		AggregationWindow: gpuWatchAggWin,
+		AggregationStat:   gpuWatchAggStats,
 	}
 	req := &aga.GPUWatchRequest{
 		Spec: []*aga.GPUWatchSpec{spec},
@@ -365,9 +443,12 @@ func gpuWatchDeleteCmdHandler(cmd *cobra.Command, args []string) error {
 }
 
 type GPUWatchSpec struct {
-	Id        string
-	GPU       []string
-	Attribute []aga.GPUWatchAttrId
+	Id                string
+	GPU               []string
+	Attribute         []aga.GPUWatchAttrId
+	SamplingInterval  uint32
+	AggregationWindow uint32
+	AggregationStat   []aga.GPUWatchAggStat
 }
 
 func printGPUWatchJson(resp *aga.GPUWatch) {
@@ -377,6 +458,9 @@ func printGPUWatchJson(resp *aga.GPUWatch) {
 		spec.GPU = append(spec.GPU, utils.IdToStr(gpu))
 	}
 	spec.Attribute = resp.GetSpec().GetAttribute()
+	spec.SamplingInterval = resp.GetSpec().GetSamplingInterval()
+	spec.AggregationWindow = resp.GetSpec().GetAggregationWindow()
+	spec.AggregationStat = resp.GetSpec().GetAggregationStat()
 	b, _ := json.MarshalIndent(&spec, "  ", " ")
 	bString := string(b)
 	fmt.Println(" {")
@@ -416,6 +500,18 @@ func printGPUWatchSpec(resp *aga.GPUWatch, specOnly bool) {
 		}
 	}
 	fmt.Println()
+	fmt.Printf("%-23s : %d ms\n", "Sampling interval",
+		resp.GetSpec().GetSamplingInterval())
+	if resp.GetSpec().GetAggregationWindow() != 0 {
+		fmt.Printf("%-23s : %d ms\n", "Aggregation window",
+			resp.GetSpec().GetAggregationWindow())
+		var stats []string
+		for _, stat := range resp.GetSpec().GetAggregationStat() {
+			stats = append(stats, gpuWatchAggStatStr(stat))
+		}
+		fmt.Printf("%-23s : %s\n", "Aggregation statistics",
+			strings.Join(stats, ", "))
+	}
 	if specOnly {
 		fmt.Printf("\n%s\n", strings.Repeat("-", 60))
 	}
@@ -449,30 +545,56 @@ func printGPUWatchStats(resp *aga.GPUWatch, statsOnly bool) {
 		fmt.Printf("\n  GPU : %s\n", utils.IdToStr(gpuAttr.GetGPU()))
 		for i, attr := range gpuAttr.GetAttr() {
 			if i == 0 {
-				line := strings.Repeat("-", 42)
+				line := strings.Repeat("-", 68)
 				fmt.Printf("  %s\n", line)
-				fmt.Printf("  %-30s%-12s\n", "Attribute", "Value")
+				fmt.Printf("  %-30s%-20s%-18s\n", "Attribute", "Value",
+					"Captured (latency)")
 				fmt.Printf("  %s\n", line)
 			}
 			attrStr := strings.ToLower(strings.Replace(attr.GetId().String(),
 				"GPU_WATCH_ATTR_ID_", "", -1))
 			attrStr = strings.Replace(attrStr, "_", "-", -1)
+			capStr := "-"
+			if attr.GetCaptureMonotonicTime() != 0 {
+				capStr = fmt.Sprintf("%s (%dus)",
+					attr.GetCaptureTime().Local().Format("15:04:05.000"),
+					attr.GetCollectionLatency())
+			}
 			switch attr.GetValue().GetWatchAttrVal().(type) {
 			case *aga.GPUWatchAttrVal_LongVal:
 				valStr := fmt.Sprintf("%v %s", attr.GetValue().GetLongVal(),
 					attr.GetValue().GetUnits())
-				fmt.Printf("  %-30s%-12v\n", attrStr, valStr)
+				fmt.Printf("  %-30s%-20v%s\n", attrStr, valStr, capStr)
 			case *aga.GPUWatchAttrVal_FloatVal:
 				valStr := fmt.Sprintf("%v %s", attr.GetValue().GetFloatVal(),
 					attr.GetValue().GetUnits())
-				fmt.Printf("  %-30s%-12v\n", attrStr, valStr)
+				fmt.Printf("  %-30s%-20v%s\n", attrStr, valStr, capStr)
 			case *aga.GPUWatchAttrVal_StringVal:
-				fmt.Printf("  %-30s%-12s\n", attrStr,
-					attr.GetValue().GetStringVal())
+				fmt.Printf("  %-30s%-20s%s\n", attrStr,
+					attr.GetValue().GetStringVal(), capStr)
+			default:
+				// aggregated watch, one statistic per line
+				for j, agg := range attr.GetAggregate() {
+					valStr := fmt.Sprintf("%s %.2f %s",
+						gpuWatchAggStatStr(agg.GetStat()), agg.GetValue(),
+						attr.GetValue().GetUnits())
+					if j == 0 {
+						fmt.Printf("  %-30s%-20v%s\n", attrStr, valStr,
+							capStr)
+					} else {
+						fmt.Printf("  %-30s%-20v\n", "", valStr)
+					}
+				}
 			}
 		}
 	}
-	fmt.Printf("\n%s\n", strings.Repeat("-", 60))
+	fmt.Printf("\n%s\n", strings.Repeat("-", 70))
+}
+
+// gpuWatchAggStatStr returns the short name of an aggregation statistic
+func gpuWatchAggStatStr(stat aga.GPUWatchAggStat) string {
+	return strings.ToLower(strings.Replace(stat.String(),
+		"GPU_WATCH_AGG_STAT_", "", -1))
 }
 
 func printGPUWatchSummary(count int) {
@@ -636,6 +758,35 @@ func gpuWatchSubscribeCmdPreRun(cmd *cobra.Command, args []string) error {
 		}
 		gpuWatchUUIDs = append(gpuWatchUUIDs, uuid.FromStringOrNil(id).Bytes())
 	}
+	if !cmd.Flags().Changed("changes-only") &&
+		(cmd.Flags().Changed("keyframe-interval") ||
+			cmd.Flags().Changed("deadband")) {
+		return fmt.Errorf("Cannot specify keyframe-interval or deadband " +
+			"without changes-only")
+	}
+	if cmd.Flags().Changed("deadband") {
+		for _, db := range strings.Split(gpuWatchDbStr, ",") {
+			kv := strings.Split(db, "=")
+			if len(kv) != 2 {
+				return fmt.Errorf("Invalid deadband %s", db)
+			}
+			threshold, err := strconv.ParseFloat(kv[1], 64)
+			if err != nil || threshold < 0 {
+				return fmt.Errorf("Invalid deadband threshold %s", kv[1])
+			}
+			attrIDs, err := gpuWatchAttrsParse(kv[0])
+			if err != nil {
+				return err
+			}
+			for _, attrID := range attrIDs {
+				gpuWatchDeadband = append(gpuWatchDeadband,
+					&aga.GPUWatchDeadband{
+						Attribute: attrID,
+						Threshold: threshold,
+					})
+			}
+		}
+	}
 	return nil
 }
 
@@ -646,7 +797,10 @@ func gpuWatchSubscribeCmdHandler(cmd *cobra.Command, args []string) error {
 	cmd.SilenceUsage = true
 	var rsp *aga.GPUWatch
 	req := &aga.GPUWatchSubscribeRequest{
-		Id: gpuWatchUUIDs,
+		Id:               gpuWatchUUIDs,
+		ChangesOnly:      gpuWatchChanges,
+		KeyframeInterval: gpuWatchKeyframe,
+		Deadband:         gpuWatchDeadband,
 	}
 	// connect to GPU agent
 	c, ctxt, cancel, err := utils.CreateNewAGAGRPClient()
@@ -672,3 +826,77 @@ func gpuWatchSubscribeCmdHandler(cmd *cobra.Command, args []string) error {
 	}
 	return nil
 }
+
+func gpuWatchHistoryShowCmdPreRun(cmd *cobra.Command, args []string) error {
+	if cmd == nil {
+		return fmt.Errorf("Invalid argument")
+	}
+	if cmd.Flags().Changed("gpu") {
+		for _, gpu := range strings.Split(gpuWatchGPUsStr, ",") {
+			if err := utils.IsUUIDValid(gpu); err != nil {
+				return err
+			}
+			gpuWatchGPUIDs = append(gpuWatchGPUIDs,
+				uuid.FromStringOrNil(gpu).Bytes())
+		}
+	}
+	attrIDs, err := gpuWatchAttrsParse(gpuWatchAttrsStr)
+	if err != nil {
+		return err
+	}
+	gpuWatchAttrIDs = attrIDs
+	return nil
+}
+
+func printGPUWatchSeries(series *aga.GPUWatchSeries) {
+	attrStr := strings.ToLower(strings.Replace(series.GetId().String(),
+		"GPU_WATCH_ATTR_ID_", "", -1))
+	attrStr = strings.Replace(attrStr, "_", "-", -1)
+	fmt.Printf("
+  GPU : %s, Attribute : %s\n",
+		utils.IdToStr(series.GetGPU()), attrStr)
+	line := strings.Repeat("-", 42)
+	fmt.Printf("  %s\n", line)
+	fmt.Printf("  %-30s%-12s\n", "Time", "Value")
+	fmt.Printf("  %s\n", line)
+	for _, sample := range series.GetSample() {
+		valStr := fmt.Sprintf("%v %s", sample.GetValue(), series.GetUnits())
+		fmt.Printf("  %-30s%-12s\n",
+			sample.GetTime().Local().Format("2006-01-02 15:04:05"), valStr)
+	}
+}
+
+func gpuWatchHistoryShowCmdHandler(cmd *cobra.Command, args []string) error {
+	if cmd == nil || len(args) > 0 {
+		return fmt.Errorf("Invalid argument")
+	}
+	cmd.SilenceUsage = true
+	startTime := time.Now().Add(-time.Duration(gpuWatchDuration) * time.Second)
+	req := &aga.GPUWatchHistoryGetRequest{
+		GPU:        gpuWatchGPUIDs,
+		Attribute:  gpuWatchAttrIDs,
+		StartTime:  &startTime,
+		Resolution: gpuWatchRes,
+	}
+	// connect to GPU agent
+	c, ctxt, cancel, err := utils.CreateNewAGAGRPClient()
+	if err != nil {
+		return fmt.Errorf("Could not connect to the GPU agent, is agent running?")
+	}
+	defer c.Close()
+	defer cancel()
+	client := aga.NewGPUWatchSvcClient(c)
+	respMsg, err := client.GPUWatchHistoryGet(ctxt, req)
+	if err != nil {
+		return fmt.Errorf("Getting GPU watch history failed, err %v", err)
+	}
+	if respMsg.ApiStatus != aga.ApiStatus_API_STATUS_OK {
+		return fmt.Errorf("Operation failed with %v error",
+			respMsg.ApiStatus)
+	}
+	for _, series := range respMsg.GetSeries() {
+		printGPUWatchSeries(series)
+	}
+	fmt.Printf("\n%s\n", strings.Repeat("-", 60))
+	return nil
+}
@@ -36,6 +36,8 @@ enum {
     AGA_THREAD_ID_API,
     // event monitoring thread
     AGA_THREAD_ID_EVENT_MONITOR,
+    // thread blocking on GPU event notifications
+    AGA_THREAD_ID_EVENT_READER,
     // GPU field watcher thread
     AGA_THREAD_ID_WATCHER,
 };
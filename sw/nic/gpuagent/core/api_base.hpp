@@ -97,6 +97,14 @@ public:
         return SDK_RET_INVALID_OP;
     }
 
+    /// \brief capture the current config of the object in the given API
+    ///        params, used to restore the object if an API batch fails
+    /// \param[out] api_params    API parameters to be filled with the spec
+    /// \return   SDK_RET_OK or error code
+    virtual sdk_ret_t backup(api_params_base *api_params) {
+        return SDK_RET_INVALID_OP;
+    }
+
     /// \brief returns true if some operation is in progress
     bool in_use(void) const {
         return in_use_;
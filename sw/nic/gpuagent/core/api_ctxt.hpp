@@ -28,6 +28,7 @@ limitations under the License.
 
 #include "nic/gpuagent/core/api_params.hpp"
 #include "nic/gpuagent/core/trace.hpp"
+#include "nic/gpuagent/core/mem.hpp"
 
 namespace aga {
 
@@ -56,13 +57,13 @@ api_ctxt_alloc (obj_id_t obj_id, api_op_t api_op)
 {
     api_ctxt_t *api_ctxt;
 
-    api_ctxt = (api_ctxt_t *)calloc(1, sizeof(api_ctxt_t));
+    api_ctxt = (api_ctxt_t *)slab_get(AGA_SLAB_ID_API_CTXT)->alloc();
     if (api_ctxt) {
         api_ctxt->obj_id = obj_id;
         api_ctxt->api_op = api_op;
-        api_ctxt->api_params = api_params_base::factory();
+        api_ctxt->api_params = api_params_base::factory(obj_id, api_op);
         if (unlikely(api_ctxt->api_params == NULL)) {
-            free(api_ctxt);
+            slab_get(AGA_SLAB_ID_API_CTXT)->free(api_ctxt);
             return NULL;
         }
     }
@@ -76,7 +77,7 @@ api_ctxt_free (api_ctxt_t *api_ctxt)
         api_params_base::destroy(api_ctxt->obj_id, api_ctxt->api_op,
                                  api_ctxt->api_params);
     }
-    free(api_ctxt);
+    slab_get(AGA_SLAB_ID_API_CTXT)->free(api_ctxt);
 }
 
 }    // namespace aga
@@ -43,18 +43,16 @@ api_engine_init (state_base *state)
     return SDK_RET_OK;
 }
 
-sdk_ret_t
-api_msg_handle_cb (api_msg_t *api_msg, sdk::ipc::ipc_msg_ptr ipc_msg)
+/// \brief    process one API
+/// \param[in] api_ctxt    API context
+/// \return #SDK_RET_OK on success, failure status code on error
+static sdk_ret_t
+api_process_ (api_ctxt_t *api_ctxt)
 {
     api_base *api_obj;
-    api_ctxt_t *api_ctxt;
     sdk_ret_t ret = SDK_RET_ERR;
-    api_params_base *api_params;
-    aga_api_cfg_req_t *req = &api_msg->req;
+    api_params_base *api_params = api_ctxt->api_params;
 
-    // currently we support only one API per API ipc msg
-    api_ctxt = req->apis.at(0);
-    api_params = api_ctxt->api_params;
     AGA_TRACE_DEBUG("Handling api {} on obj {}, key {}", api_ctxt->api_op,
                     api_ctxt->obj_id,
                     api_params->obj_key(api_ctxt->obj_id,
@@ -175,6 +173,169 @@ api_msg_handle_cb (api_msg_t *api_msg, sdk::ipc::ipc_msg_ptr ipc_msg)
     return ret;
 }
 
+/// \brief    undo information of an API processed as part of a batch
+typedef struct api_undo_s {
+    /// API that was processed
+    api_ctxt_t *api_ctxt;
+    /// config of the object before the API was processed, captured for
+    /// update and delete operations
+    api_params_base *backup;
+} api_undo_t;
+
+/// \brief    capture what is needed to undo the given API, before it is
+///           processed
+/// \param[in]  api_ctxt    API context
+/// \param[out] undo        undo information to be filled
+/// \return #SDK_RET_OK on success, failure status code on error
+static sdk_ret_t
+api_undo_init_ (api_ctxt_t *api_ctxt, api_undo_t *undo)
+{
+    sdk_ret_t ret;
+    api_base *api_obj;
+
+    undo->api_ctxt = api_ctxt;
+    undo->backup = NULL;
+    if (api_base::stateless(api_ctxt->obj_id)) {
+        // stateless objects (e.g., tasks) leave nothing behind to undo
+        return SDK_RET_OK;
+    }
+    if (api_ctxt->api_op == API_OP_CREATE) {
+        // created object itself is the undo information
+        return SDK_RET_OK;
+    }
+    api_obj = api_base::find_obj(api_ctxt);
+    if (api_obj == NULL) {
+        // API is going to fail anyway, nothing to undo
+        return SDK_RET_OK;
+    }
+    // backup holds the full spec of the object, even for delete operations
+    undo->backup = api_params_base::factory(api_ctxt->obj_id, API_OP_UPDATE);
+    if (unlikely(undo->backup == NULL)) {
+        return SDK_RET_OOM;
+    }
+    ret = api_obj->backup(undo->backup);
+    if (unlikely(ret != SDK_RET_OK)) {
+        AGA_TRACE_ERR("Failed to backup obj {}, key {} for API batch "
+                      "rollback, err {}", api_ctxt->obj_id,
+                      api_obj->key2str(), ret());
+        api_params_base::destroy(api_ctxt->obj_id, API_OP_UPDATE,
+                                 undo->backup);
+        undo->backup = NULL;
+    }
+    return ret;
+}
+
+/// \brief    undo an API successfully processed as part of a failed batch
+/// \param[in] undo    undo information captured before processing the API
+static void
+api_undo_ (api_undo_t *undo)
+{
+    sdk_ret_t ret = SDK_RET_OK;
+    api_base *api_obj;
+    api_ctxt_t undo_ctxt;
+    api_ctxt_t *api_ctxt = undo->api_ctxt;
+
+    if (api_base::stateless(api_ctxt->obj_id)) {
+        return;
+    }
+    switch (api_ctxt->api_op) {
+    case API_OP_CREATE:
+        // delete the object that got created
+        api_obj = api_base::find_obj(api_ctxt);
+        if (api_obj == NULL) {
+            ret = SDK_RET_ENTRY_NOT_FOUND;
+            break;
+        }
+        ret = g_api_obj_cb[api_ctxt->obj_id].delete_cb(api_obj,
+                                                       api_ctxt->api_params);
+        if (ret == SDK_RET_OK) {
+            api_obj->del_from_db();
+            api_obj->delay_delete();
+        }
+        break;
+    case API_OP_UPDATE:
+        // restore the config the object had before the update
+        api_obj = api_base::find_obj(api_ctxt);
+        if (api_obj == NULL) {
+            ret = SDK_RET_ENTRY_NOT_FOUND;
+            break;
+        }
+        ret = g_api_obj_cb[api_ctxt->obj_id].update_cb(api_obj,
+                                                       undo->backup);
+        break;
+    case API_OP_DELETE:
+        // re-create the object that got deleted
+        undo_ctxt = *api_ctxt;
+        undo_ctxt.api_op = API_OP_CREATE;
+        undo_ctxt.api_params = undo->backup;
+        api_obj = api_base::factory(&undo_ctxt);
+        if (api_obj == NULL) {
+            ret = SDK_RET_OOM;
+            break;
+        }
+        ret = g_api_obj_cb[api_ctxt->obj_id].create_cb(api_obj,
+                                                       undo->backup);
+        if (ret == SDK_RET_OK) {
+            ret = api_obj->add_to_db();
+        }
+        if (ret != SDK_RET_OK) {
+            api_base::free(api_ctxt->obj_id, api_obj);
+        }
+        break;
+    default:
+        break;
+    }
+    if (unlikely(ret != SDK_RET_OK)) {
+        AGA_TRACE_ERR("Failed to rollback api {} on obj {}, key {}, err {}",
+                      api_ctxt->api_op, api_ctxt->obj_id,
+                      api_ctxt->api_params->obj_key(api_ctxt->obj_id,
+                                                    api_ctxt->api_op).str(),
+                      ret());
+    }
+}
+
+sdk_ret_t
+api_msg_handle_cb (api_msg_t *api_msg, sdk::ipc::ipc_msg_ptr ipc_msg)
+{
+    uint32_t num_done;
+    sdk_ret_t ret = SDK_RET_OK;
+    aga_api_cfg_req_t *req = &api_msg->req;
+    std::vector<api_undo_t> undo(req->apis.size());
+
+    if (req->apis.size() == 1) {
+        // nothing to rollback when there is only one API
+        return api_process_(req->apis[0]);
+    }
+    // process the APIs in the batch in order and stop at first failure
+    for (num_done = 0; num_done < req->apis.size(); num_done++) {
+        ret = api_undo_init_(req->apis[num_done], &undo[num_done]);
+        if (unlikely(ret != SDK_RET_OK)) {
+            break;
+        }
+        ret = api_process_(req->apis[num_done]);
+        if (unlikely(ret != SDK_RET_OK)) {
+            break;
+        }
+    }
+    if (unlikely(ret != SDK_RET_OK)) {
+        AGA_TRACE_ERR("API batch processing failed at api {} of {}, "
+                      "rolling back, err {}", num_done + 1,
+                      req->apis.size(), ret());
+        // rollback the APIs processed so far, in the reverse order
+        while (num_done--) {
+            api_undo_(&undo[num_done]);
+        }
+    }
+    // release the backups
+    for (auto& u : undo) {
+        if (u.backup) {
+            api_params_base::destroy(u.api_ctxt->obj_id, API_OP_UPDATE,
+                                     u.backup);
+        }
+    }
+    return ret;
+}
+
 /// \@}
 
 }    // namespace aga
@@ -29,6 +29,7 @@ limitations under the License.
 #include "nic/gpuagent/core/api_ctxt.hpp"
 #include "nic/gpuagent/core/aga_core.hpp"
 #include "nic/gpuagent/core/trace.hpp"
+#include "nic/gpuagent/core/mem.hpp"
 
 namespace aga {
 
@@ -40,7 +41,7 @@ api_msg_alloc (void)
     void *mem;
     api_msg_t *api_msg;
 
-    mem = calloc(1, sizeof(api_msg_t));
+    mem = slab_get(AGA_SLAB_ID_API_MSG)->alloc();
     if (unlikely(mem == NULL)) {
         return NULL;
     }
@@ -54,7 +55,7 @@ static inline void
 api_msg_free (api_msg_t *msg)
 {
     msg->~api_msg_t();
-    free(msg);
+    slab_get(AGA_SLAB_ID_API_MSG)->free(msg);
 }
 
 // allocate and initialize API IPC msg
@@ -78,6 +79,23 @@ api_msg_init (api_ctxt_t *api_ctxt)
     return api_msg;
 }
 
+// allocate and initialize API IPC msg to accumulate a batch of APIs in
+static inline api_msg_t *
+api_msg_init (aga_batch_params_t *params)
+{
+    api_msg_t *api_msg;
+
+    api_msg = api_msg_alloc();
+    if (unlikely(api_msg == NULL)) {
+        return NULL;
+    }
+    api_msg->msg_id = AGA_IPC_MSG_ID_CFG;
+    api_msg->req.async = params->async;
+    api_msg->req.response_cb = params->response_cb;
+    api_msg->req.cookie = params->cookie;
+    return api_msg;
+}
+
 static inline sdk_ret_t
 api_msg_destroy (api_msg_t *api_msg)
 {
@@ -113,18 +131,14 @@ api_process_async_result_ (sdk::ipc::ipc_msg_ptr msg, const void *ctx)
     api_msg_destroy(api_msg);
 }
 
-sdk_ret_t
-process_api (api_ctxt_t *api_ctxt)
+// send the API msg to API thread and wait for the result, unless the msg
+// is to be processed asynchronously
+static sdk_ret_t
+api_msg_send_ (api_msg_t *api_msg)
 {
     sdk_ret_t ret;
-    api_msg_t *api_msg;
 
-    // allocate and initilize API context
-    api_msg = api_msg_init(api_ctxt);
-    if (unlikely(api_msg == NULL)) {
-        return SDK_RET_OOM;
-    }
-    if (api_ctxt->async) {
+    if (api_msg->req.async) {
         // send API msg to API and receive the response asynchronously
         sdk::ipc::request(AGA_THREAD_ID_API, AGA_IPC_MSG_ID_CFG, &api_msg,
                           sizeof(api_msg), api_process_async_result_, api_msg);
@@ -140,4 +154,62 @@ process_api (api_ctxt_t *api_ctxt)
     return ret;
 }
 
+aga_batch_ctxt_t
+batch_start (aga_batch_params_t *params)
+{
+    api_msg_t *api_msg;
+
+    api_msg = api_msg_init(params);
+    if (unlikely(api_msg == NULL)) {
+        return AGA_BATCH_CTXT_INVALID;
+    }
+    return (aga_batch_ctxt_t)api_msg;
+}
+
+sdk_ret_t
+batch_commit (aga_batch_ctxt_t bctxt)
+{
+    api_msg_t *api_msg = (api_msg_t *)bctxt;
+
+    if (unlikely(bctxt == AGA_BATCH_CTXT_INVALID)) {
+        return SDK_RET_INVALID_ARG;
+    }
+    if (api_msg->req.apis.empty()) {
+        // nothing to process
+        if (api_msg->req.async && api_msg->req.response_cb) {
+            api_msg->req.response_cb(SDK_RET_OK, api_msg->req.cookie);
+        }
+        api_msg_destroy(api_msg);
+        return SDK_RET_OK;
+    }
+    return api_msg_send_(api_msg);
+}
+
+sdk_ret_t
+batch_destroy (aga_batch_ctxt_t bctxt)
+{
+    if (unlikely(bctxt == AGA_BATCH_CTXT_INVALID)) {
+        return SDK_RET_INVALID_ARG;
+    }
+    return api_msg_destroy((api_msg_t *)bctxt);
+}
+
+sdk_ret_t
+process_api (aga_batch_ctxt_t bctxt, api_ctxt_t *api_ctxt)
+{
+    api_msg_t *api_msg;
+
+    if (bctxt != AGA_BATCH_CTXT_INVALID) {
+        // accumulate the API in the batch, it is processed on commit
+        ((api_msg_t *)bctxt)->req.apis.push_back(api_ctxt);
+        return SDK_RET_OK;
+    }
+    // allocate and initilize API context
+    api_msg = api_msg_init(api_ctxt);
+    if (unlikely(api_msg == NULL)) {
+        return SDK_RET_OOM;
+    }
+    return api_msg_send_(api_msg);
+}
+
 }    // namespace aga
@@ -29,6 +29,7 @@ limitations under the License.
 #include <vector>
 #include "nic/sdk/lib/ipc/ipc.hpp"
 #include "nic/gpuagent/include/globals.hpp"
+#include "nic/gpuagent/api/include/aga_batch.hpp"
 #include "nic/gpuagent/core/ipc_msg.hpp"
 #include "nic/gpuagent/core/api_ctxt.hpp"
 
@@ -52,9 +53,7 @@ typedef struct aga_api_cfg_req_s {
     /// API batch request and response in case batch is requested
     /// to be processed asynchronously
     void *cookie;
-    /// list of api calls to process
-    // NOTE:
-    // currently only one API is supported as there is no batching requirement
+    /// list of api calls to process, in order
     vector<api_ctxt_t *> apis;
 } aga_api_cfg_req_t;
 
@@ -67,12 +66,28 @@ typedef struct api_msg_s {
     sdk_ret_t status;
 } api_msg_t;
 
+/// \brief    start a new API batch
+/// \param[in] params    batch parameters
+/// \return    batch context or AGA_BATCH_CTXT_INVALID in case of failure
+aga_batch_ctxt_t batch_start(aga_batch_params_t *params);
+
+/// \brief    send all the APIs in the batch to API thread for processing and
+///           release the batch
+/// \param[in] bctxt    batch context
+/// \return #SDK_RET_OK on success, failure status code on error
+sdk_ret_t batch_commit(aga_batch_ctxt_t bctxt);
+
+/// \brief    release the batch without processing any of its APIs
+/// \param[in] bctxt    batch context
+/// \return #SDK_RET_OK on success, failure status code on error
+sdk_ret_t batch_destroy(aga_batch_ctxt_t bctxt);
+
 /// \brief    wrapper function to process all API calls
-/// \param[in]  msg_id      unique message identifier
+/// \param[in]  bctxt       batch context
 /// \param[in]  api_ctxt    api specific context to be added to batch or
 ///                         processed individually if batch context in invalid
 /// \return #SDK_RET_OK on success, failure status code on error
-sdk_ret_t process_api(api_ctxt_t *api_ctxt);
+sdk_ret_t process_api(aga_batch_ctxt_t bctxt, api_ctxt_t *api_ctxt);
 
 }    // namespace aga
 
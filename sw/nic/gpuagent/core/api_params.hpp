@@ -36,8 +36,11 @@ namespace aga {
 ///           specific attributes while the object is being operated on
 class api_params_base {
 public:
-    /// \brief    allocate an instance of this class
-    static api_params_base *factory(void);
+    /// \brief    allocate an instance of this class, big enough to hold the
+    ///           params of the given API operation on the given object
+    /// param[in] obj_id        object id/type
+    /// param[in] api_op        API operation being performed
+    static api_params_base *factory(obj_id_t obj_id, api_op_t api_op);
 
     /// \brief    destroy and free given instance of this class
     /// param[in] obj_id        object id/type
@@ -0,0 +1,92 @@
+
+/*
+Copyright (c) Advanced Micro Devices, Inc. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+//----------------------------------------------------------------------------
+///
+/// \file
+/// memory pools used while processing APIs
+///
+//----------------------------------------------------------------------------
+
+#include "nic/sdk/include/sdk/base.hpp"
+#include "nic/sdk/include/sdk/assert.hpp"
+#include "nic/gpuagent/core/trace.hpp"
+#include "nic/gpuagent/core/mem.hpp"
+#include "nic/gpuagent/core/api_ctxt.hpp"
+#include "nic/gpuagent/core/api_msg.hpp"
+
+namespace aga {
+
+/// number of API contexts/msgs carved out of a slab block; these are small
+/// and short lived, a block comfortably covers a burst of config requests
+#define AGA_API_SLAB_ELEMS_PER_BLOCK        64
+
+/// all the slabs created so far, indexed by slab id
+static slab *g_slabs[AGA_SLAB_ID_MAX - AGA_SLAB_ID_MIN];
+
+slab *
+slab_create (const char *name, uint32_t slab_id, uint32_t elem_sz,
+             uint32_t elems_per_block, bool zero_on_alloc)
+{
+    slab *new_slab;
+
+    SDK_ASSERT((slab_id >= AGA_SLAB_ID_MIN) && (slab_id < AGA_SLAB_ID_MAX));
+    // elements are allocated and freed from gRPC, API and watcher threads
+    new_slab = slab::factory(name, slab_id, elem_sz, elems_per_block, true,
+                             true, zero_on_alloc);
+    if (unlikely(new_slab == NULL)) {
+        AGA_TRACE_ERR("Failed to create slab {}, elem size {}", name, elem_sz);
+        return NULL;
+    }
+    g_slabs[slab_id - AGA_SLAB_ID_MIN] = new_slab;
+    return new_slab;
+}
+
+slab *
+slab_get (uint32_t slab_id)
+{
+    return g_slabs[slab_id - AGA_SLAB_ID_MIN];
+}
+
+sdk_ret_t
+slab_walk (slab_walk_cb_t walk_cb, void *ctxt)
+{
+    for (uint32_t i = 0; i < (AGA_SLAB_ID_MAX - AGA_SLAB_ID_MIN); i++) {
+        if (g_slabs[i] && walk_cb(g_slabs[i], ctxt)) {
+            break;
+        }
+    }
+    return SDK_RET_OK;
+}
+
+sdk_ret_t
+api_mem_init (void)
+{
+    // API contexts are expected to be zeroed on allocation
+    if (slab_create("api_ctxt", AGA_SLAB_ID_API_CTXT, sizeof(api_ctxt_t),
+                    AGA_API_SLAB_ELEMS_PER_BLOCK, true) == NULL) {
+        return SDK_RET_OOM;
+    }
+    if (slab_create("api_msg", AGA_SLAB_ID_API_MSG, sizeof(api_msg_t),
+                    AGA_API_SLAB_ELEMS_PER_BLOCK, true) == NULL) {
+        return SDK_RET_OOM;
+    }
+    return SDK_RET_OK;
+}
+
+}    // namespace aga
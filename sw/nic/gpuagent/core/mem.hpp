@@ -0,0 +1,88 @@
+
+/*
+Copyright (c) Advanced Micro Devices, Inc. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+//----------------------------------------------------------------------------
+///
+/// \file
+/// memory pools used while processing APIs
+///
+//----------------------------------------------------------------------------
+
+#ifndef __AGA_CORE_MEM_HPP__
+#define __AGA_CORE_MEM_HPP__
+
+#include "nic/sdk/include/sdk/base.hpp"
+#include "nic/sdk/lib/slab/slab.hpp"
+
+using sdk::lib::slab;
+
+namespace aga {
+
+/// \brief slab identifiers
+enum {
+    AGA_SLAB_ID_MIN = sdk::lib::SDK_SLAB_ID_RSVD,
+    /// API contexts
+    AGA_SLAB_ID_API_CTXT = AGA_SLAB_ID_MIN,
+    /// API IPC messages
+    AGA_SLAB_ID_API_MSG,
+    /// API params carrying only the object key (i.e., delete operations)
+    AGA_SLAB_ID_API_PARAMS_KEY,
+    /// API params of GPU objects
+    AGA_SLAB_ID_API_PARAMS_GPU,
+    /// API params of task objects
+    AGA_SLAB_ID_API_PARAMS_TASK,
+    /// API params of GPU watch objects
+    AGA_SLAB_ID_API_PARAMS_GPU_WATCH,
+    AGA_SLAB_ID_MAX,
+};
+
+/// \brief     slab walk callback function type
+/// \param[in] slab    slab instance
+/// \param[in] ctxt    opaque context passed to the walk
+/// \return    true if walk needs to be stopped or false if walk needs to
+///            continue
+typedef bool (*slab_walk_cb_t)(slab *slab, void *ctxt);
+
+/// \brief     create a slab and keep track of it for the slab walk
+/// \param[in] name               name of the slab
+/// \param[in] slab_id            one of AGA_SLAB_ID_XXX
+/// \param[in] elem_sz            size of each element
+/// \param[in] elems_per_block    number of elements carved out of each block
+/// \param[in] zero_on_alloc      true if elements need to be zeroed on alloc
+/// \return    slab instance or NULL in case of failure
+slab *slab_create(const char *name, uint32_t slab_id, uint32_t elem_sz,
+                  uint32_t elems_per_block, bool zero_on_alloc);
+
+/// \brief     return the slab instance given its id
+/// \param[in] slab_id    one of AGA_SLAB_ID_XXX
+/// \return    slab instance or NULL if not created
+slab *slab_get(uint32_t slab_id);
+
+/// \brief     walk all the slabs
+/// \param[in] walk_cb    callback to be invoked for every slab
+/// \param[in] ctxt       opaque context passed back to the callback
+/// \return    SDK_RET_OK on success, failure status code on error
+sdk_ret_t slab_walk(slab_walk_cb_t walk_cb, void *ctxt);
+
+/// \brief     create the memory pools of the API processing framework
+/// \return    SDK_RET_OK on success, failure status code on error
+sdk_ret_t api_mem_init(void);
+
+}    // namespace aga
+
+#endif    // __AGA_CORE_MEM_HPP__
@@ -0,0 +1,177 @@
+
+/*
+Copyright (c) Advanced Micro Devices, Inc. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+//----------------------------------------------------------------------------
+///
+/// \file
+/// read-mostly object database with RCU style (copy-on-write) updates
+///
+//----------------------------------------------------------------------------
+
+#ifndef __AGA_CORE_RCU_DB_HPP__
+#define __AGA_CORE_RCU_DB_HPP__
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include "nic/sdk/include/sdk/base.hpp"
+#include "nic/gpuagent/api/mem.hpp"
+
+namespace aga {
+
+/// \brief    base of the versions of all the rcu dbs, lets the superseded
+///           versions be reclaimed without knowing their types
+class rcu_db_version {
+public:
+    /// \brief destructor
+    virtual ~rcu_db_version() {}
+};
+
+/// \brief    read-mostly map of objects
+/// \remark
+///   - readers load the pointer to the current version of the map and never
+///     block on writers or on each other, nor do they touch any shared
+///     cache line other than the pointer itself
+///   - writers (serialized among themselves) copy the current version, modify
+///     the copy and publish it atomically; the superseded version is delay
+///     deleted, so readers that loaded it keep using it until they are done
+///   - just like the objects the map points to, which are also released via
+///     delay delete, readers must be done with a version within the delay
+///     delete timeout
+///   - updates are O(n), which is fine for the config path where objects are
+///     few and churn is low compared to reads
+template <typename K, typename V, typename H = std::hash<K>>
+class rcu_db {
+public:
+    /// one version of the map
+    typedef std::unordered_map<K, V, H> map_t;
+    /// version of the map held by readers
+    typedef const map_t *snapshot_t;
+
+    /// \brief constructor
+    rcu_db() : db_(new version_t()) {}
+
+    /// \brief destructor
+    ~rcu_db() {
+        delete db_.load(std::memory_order_relaxed);
+    }
+
+    /// \brief    return the current version of the map
+    /// \return   current version of the map, valid for the delay delete
+    ///           timeout
+    snapshot_t snapshot(void) const {
+        return &db_.load(std::memory_order_acquire)->map;
+    }
+
+    /// \brief     lookup an element given its key
+    /// \param[in] key    key of the element
+    /// \param[out] val   value of the element, if found
+    /// \return    true if element is found or else false
+    bool find(const K& key, V *val) const {
+        snapshot_t db = snapshot();
+        auto it = db->find(key);
+
+        if (it == db->end()) {
+            return false;
+        }
+        *val = it->second;
+        return true;
+    }
+
+    /// \brief     insert an element
+    /// \param[in] key    key of the element
+    /// \param[in] val    value of the element
+    /// \param[in] replace    if true, replace the element if it exists
+    /// \return    true if element is inserted or else false
+    bool insert(const K& key, const V& val, bool replace = false) {
+        std::lock_guard<std::mutex> lock(writer_lock_);
+        version_t *db = db_.load(std::memory_order_relaxed);
+
+        if (!replace && (db->map.find(key) != db->map.end())) {
+            return false;
+        }
+        version_t *new_db = new version_t(*db);
+        new_db->map[key] = val;
+        publish_(new_db);
+        return true;
+    }
+
+    /// \brief     remove an element given its key
+    /// \param[in] key    key of the element
+    /// \param[out] val   value of the removed element, if found
+    /// \return    true if element is removed or else false
+    bool erase(const K& key, V *val) {
+        std::lock_guard<std::mutex> lock(writer_lock_);
+        version_t *db = db_.load(std::memory_order_relaxed);
+        auto it = db->map.find(key);
+
+        if (it == db->map.end()) {
+            return false;
+        }
+        if (val) {
+            *val = it->second;
+        }
+        version_t *new_db = new version_t(*db);
+        new_db->map.erase(key);
+        publish_(new_db);
+        return true;
+    }
+
+    /// \brief     walk all the elements of the current version of the map
+    /// \param[in] walk_cb    callback invoked for every element, walk stops
+    ///                       when the callback returns true
+    template <typename CB>
+    void walk(CB walk_cb) const {
+        snapshot_t db = snapshot();
+
+        for (auto it = db->begin(); it != db->end(); ++it) {
+            if (walk_cb(it->second)) {
+                break;
+            }
+        }
+    }
+
+private:
+    /// \brief    one version of the map, as published to the readers
+    struct version_t : public rcu_db_version {
+        map_t map;
+    };
+
+    /// \brief     publish a new version of the map and retire the current
+    ///            one once the readers are done with it
+    /// \param[in] new_db    new version of the map
+    /// \remark    must be called with the writer lock held
+    void publish_(version_t *new_db) {
+        version_t *old_db = db_.load(std::memory_order_relaxed);
+
+        db_.store(new_db, std::memory_order_release);
+        // if the old version can't be parked for reclamation it is leaked,
+        // as readers may still be using it
+        delay_delete(old_db);
+    }
+
+private:
+    /// current version of the map
+    std::atomic<version_t *> db_;
+    /// lock serializing the writers
+    std::mutex writer_lock_;
+};
+
+}    // namespace aga
+
+#endif    // __AGA_CORE_RCU_DB_HPP__
@@ -153,8 +153,9 @@ create_gpus (void)
         entry->set_handle(gpu_handles[i]);
         // set partition id
         entry->set_partition_id(partition_id);
-        // initialize GPU spec
+        // initialize GPU spec and the cached status
         entry->init_spec();
+        entry->init_status();
         // insert in handle db
         gpu_db()->insert_in_handle_db(entry);
         // if GPU is a child GPU, add to the parent GPU
@@ -173,6 +174,12 @@ create_gpus (void)
                               spec.memory_partition_type);
         }
     }
+    // read the topology of all the GPUs once, topology reads are served from
+    // this from here on
+    ret = aga::smi_gpu_topology_init();
+    if (unlikely(ret != SDK_RET_OK)) {
+        AGA_TRACE_ERR("GPU topology init failed, err {}", ret());
+    }
     return SDK_RET_OK;
 }
 
@@ -279,6 +286,9 @@ aga_init (aga_init_params_t *init_params)
     // initialize sdk logger
     logger_init(sdk_logger);
     // initialize API layer
+    api_init_params.smi_cache_ttl = init_params->smi_cache_ttl;
+    api_init_params.gpu_watch_history_retention =
+        init_params->gpu_watch_history_retention;
     aga_api_init(&api_init_params);
     // do gRPC library init
     grpc_init();
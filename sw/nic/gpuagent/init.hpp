@@ -40,6 +40,10 @@ typedef struct aga_init_params_s {
     std::string grpc_server;
     // rdcd gRPC server (IP:port) to connect to
     std::string rdc_server;
+    // max. age of cached smi data served to API readers (in milliseconds)
+    uint32_t smi_cache_ttl;
+    // how far back GPU watch attribute samples are remembered (in seconds)
+    uint32_t gpu_watch_history_retention;
 } aga_init_params_t;
 
 /// \brief    initialize the agent state, threads etc.
@@ -36,6 +36,7 @@ limitations under the License.
 #include "nic/sdk/include/sdk/assert.hpp"
 #include "nic/gpuagent/include/globals.hpp"
 #include "nic/gpuagent/init.hpp"
+#include "nic/gpuagent/api/include/aga_gpu_watch.hpp"
 #include "nic/gpuagent/svc/gpu.hpp"
 
 using grpc::Channel;
@@ -50,8 +51,9 @@ using grpc::Status;
 static void inline
 print_usage (char **argv)
 {
-    fprintf(stdout, "Usage : %s [-p <port> | --grpc-server-port <port>]\n\n",
-            argv[0]);
+    fprintf(stdout, "Usage : %s [-p <port> | --grpc-server-port <port>] "
+            "[-t <msecs> | --smi-cache-ttl <msecs>] "
+            "[-r <secs> | --watch-history-retention <secs>]\n\n", argv[0]);
     fprintf(stdout, "Use -h | --help for help\n");
 }
 
@@ -63,14 +65,17 @@ main (int argc, char **argv)
     aga_init_params_t init_params = {};
     // command line options
     struct option longopts[] = {
-        { "grpc-server-port", required_argument, NULL, 'p' },
-        { "rdc-server",       required_argument, NULL, 's' },
-        { "help",             no_argument,       NULL, 'h' },
-        { 0,                  0,                 NULL,  0  }
+        { "grpc-server-port",        required_argument, NULL, 'p' },
+        { "rdc-server",              required_argument, NULL, 's' },
+        { "smi-cache-ttl",           required_argument, NULL, 't' },
+        { "watch-history-retention", required_argument, NULL, 'r' },
+        { "help",                    no_argument,       NULL, 'h' },
+        { 0,                         0,                 NULL,  0  }
     };
 
     // parse CLI options
-    while ((oc = getopt_long(argc, argv, ":hp:s:W;", longopts, NULL)) != -1) {
+    while ((oc = getopt_long(argc, argv, ":hp:s:t:r:W;",
+                             longopts, NULL)) != -1) {
         switch (oc) {
         case 'p':
             try {
@@ -100,6 +105,43 @@ main (int argc, char **argv)
                 ":" + std::to_string(AGA_DEFAULT_RDC_GRPC_SERVER_PORT);
             break;
 
+        case 't':
+            try {
+                int ttl = std::stoi(optarg);
+                if (ttl <= 0) {
+                    fprintf(stderr, "Invalid smi cache ttl %d specified\n",
+                            ttl);
+                    print_usage(argv);
+                    exit(1);
+                }
+                init_params.smi_cache_ttl = ttl;
+            } catch (const std::logic_error &e) {
+                // invalid_argument or out_of_range
+                fprintf(stderr, "Invalid smi cache ttl specified\n");
+                print_usage(argv);
+                exit(1);
+            }
+            break;
+
+        case 'r':
+            try {
+                int retention = std::stoi(optarg);
+                if ((retention <= 0) ||
+                    (retention > AGA_GPU_WATCH_HISTORY_RETENTION_MAX)) {
+                    fprintf(stderr, "Invalid watch history retention %d "
+                            "specified\n", retention);
+                    print_usage(argv);
+                    exit(1);
+                }
+                init_params.gpu_watch_history_retention = retention;
+            } catch (const std::logic_error &e) {
+                // invalid_argument or out_of_range
+                fprintf(stderr, "Invalid watch history retention specified\n");
+                print_usage(argv);
+                exit(1);
+            }
+            break;
+
         case 'h':
             print_usage(argv);
             exit(0);
@@ -24,7 +24,11 @@ limitations under the License.
 //----------------------------------------------------------------------------
 
 #include "nic/gpuagent/core/trace.hpp"
+#include "nic/gpuagent/core/mem.hpp"
+#include "nic/gpuagent/api/mem.hpp"
+#include "nic/gpuagent/api/gpu_watch_history.hpp"
 #include "nic/gpuagent/svc/debug.hpp"
+#include "nic/gpuagent/svc/stream_reactor.hpp"
 
 Status
 DebugSvcImpl::TraceUpdate(ServerContext *context,
@@ -103,3 +107,70 @@ DebugSvcImpl::TraceFlush(ServerContext *context, const Empty *req,
     core::flush_logs();
     return Status::OK;
 }
+
+Status
+DebugSvcImpl::StreamGet(ServerContext *context, const Empty *req,
+                        StreamGetResponse *rsp) {
+    StreamReactorBase::Walk([rsp](const stream_stats_t& stats) {
+        auto proto_stats = rsp->add_stream();
+
+        proto_stats->set_client(stats.client);
+        proto_stats->set_method(stats.method);
+        proto_stats->set_overflowpolicy(stats.policy);
+        proto_stats->set_queuedepthmax(stats.queue_depth_max);
+        proto_stats->set_queuedepth(stats.queue_depth);
+        proto_stats->set_queuedepthpeak(stats.queue_depth_peak);
+        proto_stats->set_numsent(stats.num_sent);
+        proto_stats->set_numdropped(stats.num_dropped);
+        proto_stats->set_numcoalesced(stats.num_coalesced);
+    });
+    return Status::OK;
+}
+
+static bool
+slab_stats_fill (sdk::lib::slab *slab, void *ctxt)
+{
+    auto rsp = (SlabGetResponse *)ctxt;
+    auto proto_stats = rsp->add_slab();
+
+    proto_stats->set_name(slab->name());
+    proto_stats->set_id(slab->slab_id());
+    proto_stats->set_elemsize(slab->elem_sz());
+    proto_stats->set_elemsperblock(slab->elems_per_block());
+    proto_stats->set_numinuse(slab->num_in_use());
+    proto_stats->set_numallocs(slab->num_allocs());
+    proto_stats->set_numfrees(slab->num_frees());
+    proto_stats->set_numallocfails(slab->num_alloc_fails());
+    proto_stats->set_numblocks(slab->num_blocks());
+    return false;
+}
+
+Status
+DebugSvcImpl::SlabGet(ServerContext *context, const Empty *req,
+                      SlabGetResponse *rsp) {
+    aga::delay_delete_stats_t reclaim_stats;
+    auto proto_reclaim = rsp->mutable_reclaim();
+
+    aga::slab_walk(slab_stats_fill, rsp);
+    aga::delay_delete_stats_get(&reclaim_stats);
+    proto_reclaim->set_numpending(reclaim_stats.num_pending);
+    proto_reclaim->set_numreclaimed(reclaim_stats.num_reclaimed);
+    proto_reclaim->set_numfails(reclaim_stats.num_fails);
+    return Status::OK;
+}
+
+Status
+DebugSvcImpl::WatchHistoryGet(ServerContext *context, const Empty *req,
+                              WatchHistoryGetResponse *rsp) {
+    aga::gpu_watch_history_stats_t stats;
+
+    aga::g_gpu_watch_history.stats(&stats);
+    rsp->set_numseries(stats.num_series);
+    rsp->set_numsamples(stats.num_samples);
+    rsp->set_numbytes(stats.num_bytes);
+    rsp->set_numencoded(stats.num_encoded);
+    rsp->set_encodensecs(stats.encode_ns);
+    rsp->set_numdecoded(stats.num_decoded);
+    rsp->set_decodensecs(stats.decode_ns);
+    return Status::OK;
+}
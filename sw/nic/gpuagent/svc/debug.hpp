@@ -39,6 +39,9 @@ using types::Empty;
 using amdgpu::TraceRequest;
 using amdgpu::TraceResponse;
 using amdgpu::TraceGetResponse;
+using amdgpu::StreamGetResponse;
+using amdgpu::SlabGetResponse;
+using amdgpu::WatchHistoryGetResponse;
 
 class DebugSvcImpl final : public DebugSvc::Service {
 public:
@@ -48,6 +51,12 @@ public:
                          TraceGetResponse *rsp) override;
     Status TraceFlush(ServerContext *context, const Empty *req,
                       Empty *rsp) override;
+    Status StreamGet(ServerContext *context, const Empty *req,
+                     StreamGetResponse *rsp) override;
+    Status SlabGet(ServerContext *context, const Empty *req,
+                   SlabGetResponse *rsp) override;
+    Status WatchHistoryGet(ServerContext *context, const Empty *req,
+                           WatchHistoryGetResponse *rsp) override;
 };
 
 #endif    // __AGA_SVC_DEBUG_HPP__
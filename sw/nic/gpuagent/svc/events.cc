@@ -40,12 +40,21 @@ EventSvcImpl::EventGet(ServerContext *server_ctx,
     return Status::OK;
 }
 
-Status
-EventSvcImpl::EventSubscribe(ServerContext* context,
-                             const EventSubscribeRequest *proto_req,
-                             ServerWriter<Event> *stream) {
-    aga_svc_event_subscribe(context, proto_req, stream);
-    return Status::OK;
+ServerWriteReactor<Event> *
+EventSvcImpl::EventSubscribe(CallbackServerContext* context,
+                             const EventSubscribeRequest *proto_req) {
+    sdk_ret_t ret;
+    EventStreamReactor *reactor;
+
+    reactor = new EventStreamReactor(context->peer(), "EventSubscribe",
+                                     proto_req->overflowpolicy(),
+                                     proto_req->queuedepth());
+    ret = aga_svc_event_subscribe(context, proto_req, reactor);
+    if (unlikely(ret != SDK_RET_OK)) {
+        reactor->Close(Status(grpc::StatusCode::INVALID_ARGUMENT,
+                              "Event subscribe request failed"));
+    }
+    return reactor;
 }
 
 Status
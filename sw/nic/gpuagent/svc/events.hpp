@@ -30,10 +30,13 @@ limitations under the License.
 #include "gen/proto/gpuagent/types.pb.h"
 #include "gen/proto/gpuagent/events.pb.h"
 #include "gen/proto/gpuagent/events.grpc.pb.h"
+#include "nic/gpuagent/svc/stream_reactor.hpp"
 
 using grpc::Status;
 using grpc::ServerContext;
 using grpc::ServerWriter;
+using grpc::CallbackServerContext;
+using grpc::ServerWriteReactor;
 
 using amdgpu::EventSvc;
 using amdgpu::Event;
@@ -44,14 +47,20 @@ using amdgpu::DebugEventSvc;
 using amdgpu::EventGenRequest;
 using amdgpu::EventGenResponse;
 
-class EventSvcImpl final : public EventSvc::Service {
+/// reactor that streams events to a subscriber
+typedef StreamReactor<Event> EventStreamReactor;
+
+/// EventSubscribe is served with the callback API so that subscribers
+/// don't pin a sync gRPC thread for the lifetime of the stream
+class EventSvcImpl final :
+    public EventSvc::WithCallbackMethod_EventSubscribe<EventSvc::Service> {
 public:
     Status EventGet(ServerContext* context,
                     const EventRequest *request,
                     EventResponse *response) override;
-    Status EventSubscribe(ServerContext* context,
-                          const EventSubscribeRequest *request,
-                          ServerWriter<Event> *stream) override;
+    ServerWriteReactor<Event> *EventSubscribe(
+                          CallbackServerContext* context,
+                          const EventSubscribeRequest *request) override;
 };
 
 class DebugEventSvcImpl final : public DebugEventSvc::Service {
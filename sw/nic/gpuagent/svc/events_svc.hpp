@@ -157,6 +157,7 @@ aga_event_match_type (const amdgpu::EventFilter& proto_filter)
 static inline sdk_ret_t
 aga_svc_event_get (const EventRequest *req, EventResponse *rsp) {
     sdk_ret_t ret;
+    aga_event_query_t query = {};
     aga_event_read_cb_ctxt_t cb_ctxt = {};
 
     aga_api_trace_verbose("Event", "Get", req);
@@ -171,7 +172,8 @@ aga_svc_event_get (const EventRequest *req, EventResponse *rsp) {
             return ret;
         }
     }
-    ret = aga_event_read_all(aga_event_read_cb, &cb_ctxt);
+    aga_event_query_proto_to_api_spec(&query, *req);
+    ret = aga_event_read_all(aga_event_read_cb, &cb_ctxt, &query);
     return ret;
 }
 
@@ -189,8 +191,11 @@ aga_event_ntfn_cb (const aga_event_t *event,
     if (unlikely(ret != SDK_RET_OK)) {
         return ret;
     }
-    // try to write to the client stream
-    rv = ((ServerWriter<Event> *)client_ctxt->stream)->Write(proto_event);
+    // queue the event on the client stream, repeated occurrences of the
+    // same event on the same GPU coalesce if the subscriber asked for it
+    rv = ((EventStreamReactor *)client_ctxt->stream)->Send(proto_event,
+             std::string(event->gpu.id, OBJ_MAX_KEY_LEN) +
+                 std::to_string(event->id));
     if (unlikely(rv == false)) {
         AGA_TRACE_ERR("Failed to notify event {} to client {}",
                       event->id, client_ctxt->client.c_str());
@@ -199,10 +204,16 @@ aga_event_ntfn_cb (const aga_event_t *event,
     return SDK_RET_OK;
 }
 
+void
+aga_event_close_cb (void *stream)
+{
+    ((EventStreamReactor *)stream)->Close();
+}
+
 static inline sdk_ret_t
-aga_svc_event_subscribe (ServerContext* context,
+aga_svc_event_subscribe (CallbackServerContext* context,
                          const EventSubscribeRequest *proto_req,
-                         ServerWriter<Event> *stream) {
+                         EventStreamReactor *stream) {
     sdk_ret_t ret;
     aga_event_id_t event_id;
     aga_event_subscribe_req_t req;
@@ -227,7 +238,7 @@ aga_svc_event_subscribe (ServerContext* context,
                 AGA_TRACE_ERR("Failed to subscribe client {} to unknown "
                               "event {}", context->peer().c_str(),
                               proto_req->filter().events().id(i));
-                goto end;
+                return SDK_RET_INVALID_ARG;
             }
             req.events[i] = event_id;
             AGA_TRACE_VERBOSE("Client {}, stream {} subscribed for event {}",
@@ -247,10 +258,9 @@ aga_svc_event_subscribe (ServerContext* context,
     strncpy(req.client, context->peer().c_str(), AGA_MAX_CLIENT_STR);
     req.stream = stream;
     req.notify_cb = aga_event_ntfn_cb;
-    aga_event_subscribe(&req);
-
-end:
-    return SDK_RET_OK;
+    req.close_cb = aga_event_close_cb;
+    req.resume_seq = proto_req->resumeseqnum();
+    return aga_event_subscribe(&req);
 }
 
 static inline sdk_ret_t
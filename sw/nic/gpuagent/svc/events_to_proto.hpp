@@ -69,6 +69,7 @@ aga_event_api_spec_to_proto (amdgpu::Event *proto_event,
     time_stamp->set_nanos(event->timestamp.tv_nsec);
     proto_event->set_gpu(event->gpu.id, OBJ_MAX_KEY_LEN);
     proto_event->set_description(event->message);
+    proto_event->set_seqnum(event->seq);
     return SDK_RET_OK;
 }
 
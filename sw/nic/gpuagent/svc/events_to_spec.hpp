@@ -130,4 +130,19 @@ aga_event_filter_proto_to_api_spec (aga_event_filter_ctxt_t *api_spec,
     return SDK_RET_OK;
 }
 
+static inline void
+aga_event_query_proto_to_api_spec (aga_event_query_t *api_spec,
+                                   const amdgpu::EventRequest& proto_spec)
+{
+    api_spec->since_seq = proto_spec.sinceseqnum();
+    if (proto_spec.has_starttime()) {
+        api_spec->start_time.tv_sec = proto_spec.starttime().seconds();
+        api_spec->start_time.tv_nsec = proto_spec.starttime().nanos();
+    }
+    if (proto_spec.has_endtime()) {
+        api_spec->end_time.tv_sec = proto_spec.endtime().seconds();
+        api_spec->end_time.tv_nsec = proto_spec.endtime().nanos();
+    }
+}
+
 #endif    // __AGA_SVC_EVENTS_TO_SPEC_HPP__
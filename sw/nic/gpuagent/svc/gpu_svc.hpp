@@ -47,14 +47,15 @@ aga_svc_gpu_get (const GPUGetRequest *proto_req, GPUGetResponse *proto_rsp)
     }
     aga_api_trace_verbose("GPU", "Get", proto_req);
     if (proto_req->id_size() == 0) {
-        ret = aga_gpu_read_all(aga_gpu_api_info_to_proto, proto_rsp);
+        ret = aga_gpu_read_all(aga_gpu_api_info_to_proto, proto_rsp,
+                               proto_req->liveread());
         proto_rsp->set_apistatus(sdk_ret_to_api_status(ret));
         return ret;
     }
     for (int i = 0; i < proto_req->id_size(); i ++) {
         aga_obj_key_proto_to_api_spec(&key, proto_req->id(i));
         memset(&info, 0, sizeof(aga_gpu_info_t));
-        ret = aga_gpu_read(&key, &info);
+        ret = aga_gpu_read(&key, &info, proto_req->liveread());
         if (unlikely(ret != SDK_RET_OK)) {
             proto_rsp->set_apistatus(sdk_ret_to_api_status(ret));
             break;
@@ -70,13 +71,21 @@ aga_svc_gpu_update (const GPUUpdateRequest *proto_req,
                     GPUUpdateResponse *proto_rsp)
 {
     sdk_ret_t ret;
+    aga_batch_ctxt_t bctxt;
     aga_gpu_spec_t api_spec;
+    aga_batch_params_t batch_params = {};
 
     if ((proto_req == NULL) || (proto_req->spec_size() == 0)) {
         proto_rsp->set_apistatus(types::ApiStatus::API_STATUS_INVALID_ARG);
         return SDK_RET_INVALID_ARG;
     }
     aga_api_trace_verbose("GPU", "Update", proto_req);
+    // all the updates in the request are applied in one go or not at all
+    bctxt = aga_batch_start(&batch_params);
+    if (unlikely(bctxt == AGA_BATCH_CTXT_INVALID)) {
+        proto_rsp->set_apistatus(sdk_ret_to_api_status(SDK_RET_OOM));
+        return SDK_RET_OOM;
+    }
     for (int i = 0; i < proto_req->spec_size(); i++) {
         auto spec = proto_req->spec(i);
 
@@ -85,12 +94,17 @@ aga_svc_gpu_update (const GPUUpdateRequest *proto_req,
         if (unlikely(ret != SDK_RET_OK)) {
             goto end;
         }
-        ret = aga_gpu_update(&api_spec);
+        ret = aga_gpu_update(&api_spec, bctxt);
         if (ret != SDK_RET_OK) {
             goto end;
         }
     }
+    ret = aga_batch_commit(bctxt);
+    bctxt = AGA_BATCH_CTXT_INVALID;
 end:
+    if (bctxt != AGA_BATCH_CTXT_INVALID) {
+        aga_batch_destroy(bctxt);
+    }
     proto_rsp->set_apistatus(sdk_ret_to_api_status(ret));
     return ret;
 }
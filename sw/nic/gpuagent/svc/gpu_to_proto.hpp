@@ -703,6 +703,7 @@ aga_gpu_api_stats_to_proto (GPUStats *proto_stats,
     }
     aga_gpu_violation_stats_to_proto(proto_stats->mutable_violationstats(),
                                      &stats->violation_stats);
+    proto_stats->set_watchcollectionlatency(stats->watch_collection_latency);
 }
 
 // populate proto buf from gpu info
@@ -62,11 +62,40 @@ GPUWatchSvcImpl::GPUWatchGet(ServerContext *context,
 }
 
 Status
-GPUWatchSvcImpl::GPUWatchSubscribe(ServerContext *context,
-                     const GPUWatchSubscribeRequest *proto_req,
-                     grpc::ServerWriter<GPUWatch> *writer) {
+GPUWatchSvcImpl::GPUWatchHistoryGet(ServerContext *context,
+                                    const GPUWatchHistoryGetRequest *proto_req,
+                                    GPUWatchHistoryGetResponse *proto_rsp) {
     sdk_ret_t ret;
 
-    ret = aga_svc_gpu_watch_subscribe(context, proto_req, writer);
+    ret = aga_svc_gpu_watch_history_get(proto_req, proto_rsp);
+    proto_rsp->set_apistatus(sdk_ret_to_api_status(ret));
     return Status::OK;
 }
+
+ServerWriteReactor<grpc::ByteBuffer> *
+GPUWatchSvcImpl::GPUWatchSubscribe(CallbackServerContext *context,
+                     const grpc::ByteBuffer *raw_req) {
+    sdk_ret_t ret;
+    Status status;
+    grpc::ByteBuffer req_buf(*raw_req);
+    GPUWatchStreamReactor *reactor;
+    GPUWatchSubscribeRequest proto_req;
+
+    // raw method hands over the request in wire format
+    status = grpc::SerializationTraits<GPUWatchSubscribeRequest>::Deserialize(
+                 &req_buf, &proto_req);
+    reactor = new GPUWatchStreamReactor(context->peer(),
+                                        "GPUWatchSubscribe",
+                                        proto_req.overflowpolicy(),
+                                        proto_req.queuedepth());
+    if (unlikely(!status.ok())) {
+        reactor->Close(status);
+        return reactor;
+    }
+    ret = aga_svc_gpu_watch_subscribe(context, &proto_req, reactor);
+    if (unlikely(ret != SDK_RET_OK)) {
+        reactor->Close(Status(grpc::StatusCode::INVALID_ARGUMENT,
+                              "GPU watch subscribe request failed"));
+    }
+    return reactor;
+}
@@ -30,9 +30,12 @@ limitations under the License.
 #include "gen/proto/gpuagent/types.pb.h"
 #include "gen/proto/gpuagent/gpu_watch.pb.h"
 #include "gen/proto/gpuagent/gpu_watch.grpc.pb.h"
+#include "nic/gpuagent/svc/stream_reactor.hpp"
 
 using grpc::Status;
 using grpc::ServerContext;
+using grpc::CallbackServerContext;
+using grpc::ServerWriteReactor;
 
 using types::Empty;
 using amdgpu::GPUWatchAttrId;
@@ -47,9 +50,20 @@ using amdgpu::GPUWatchDeleteResponse;
 using amdgpu::GPUWatchGetRequest;
 using amdgpu::GPUWatchGetResponse;
 using amdgpu::GPUWatchSubscribeRequest;
+using amdgpu::GPUWatchHistoryGetRequest;
+using amdgpu::GPUWatchHistoryGetResponse;
 using amdgpu::GPUWatch;
 
-class GPUWatchSvcImpl final : public GPUWatchSvc::Service {
+/// reactor that streams GPU watch updates to a subscriber, updates are
+/// written pre-serialized so one encoding is shared by all subscribers
+typedef StreamReactor<grpc::ByteBuffer> GPUWatchStreamReactor;
+
+/// GPUWatchSubscribe is served with the raw callback API so that subscribers
+/// don't pin a sync gRPC thread for the lifetime of the stream and updates
+/// can be serialized once for all subscribers
+class GPUWatchSvcImpl final :
+    public GPUWatchSvc::WithRawCallbackMethod_GPUWatchSubscribe<
+               GPUWatchSvc::Service> {
 public:
     Status GPUWatchCreate(ServerContext *context,
                           const GPUWatchRequest *proto_req,
@@ -60,9 +74,12 @@ public:
     Status GPUWatchGet(ServerContext *context,
                        const GPUWatchGetRequest *proto_req,
                        GPUWatchGetResponse *proto_rsp) override;
-    Status GPUWatchSubscribe(ServerContext *context,
-               const GPUWatchSubscribeRequest *proto_req,
-               grpc::ServerWriter<GPUWatch> *writer) override;
+    Status GPUWatchHistoryGet(ServerContext *context,
+                              const GPUWatchHistoryGetRequest *proto_req,
+                              GPUWatchHistoryGetResponse *proto_rsp) override;
+    ServerWriteReactor<grpc::ByteBuffer> *GPUWatchSubscribe(
+               CallbackServerContext *context,
+               const grpc::ByteBuffer *raw_req) override;
 };
 
 #endif    // __AGA_SVC_GPU_WATCH_HPP__
@@ -43,13 +43,21 @@ aga_svc_gpu_watch_create (const GPUWatchRequest *proto_req,
                           GPUWatchResponse *proto_rsp)
 {
     sdk_ret_t ret;
+    aga_batch_ctxt_t bctxt;
     aga_gpu_watch_spec_t api_spec;
+    aga_batch_params_t batch_params = {};
 
     if ((proto_req == NULL) || (proto_req->spec_size() == 0)){
         proto_rsp->set_apistatus(types::ApiStatus::API_STATUS_INVALID_ARG);
         return SDK_RET_INVALID_ARG;
     }
     aga_api_trace_verbose("GPUWatch", "Create", proto_req);
+    // all the GPU watches in the request are created or none of them are
+    bctxt = aga_batch_start(&batch_params);
+    if (unlikely(bctxt == AGA_BATCH_CTXT_INVALID)) {
+        proto_rsp->set_apistatus(sdk_ret_to_api_status(SDK_RET_OOM));
+        return SDK_RET_OOM;
+    }
     for (int i = 0; i < proto_req->spec_size(); i ++) {
         auto spec = proto_req->spec(i);
 
@@ -58,12 +66,17 @@ aga_svc_gpu_watch_create (const GPUWatchRequest *proto_req,
         if (unlikely(ret != SDK_RET_OK)) {
             goto end;
         }
-        ret = aga_gpu_watch_create(&api_spec);
+        ret = aga_gpu_watch_create(&api_spec, bctxt);
         if (unlikely(ret != SDK_RET_OK)) {
             goto end;
         }
     }
+    ret = aga_batch_commit(bctxt);
+    bctxt = AGA_BATCH_CTXT_INVALID;
 end:
+    if (bctxt != AGA_BATCH_CTXT_INVALID) {
+        aga_batch_destroy(bctxt);
+    }
     proto_rsp->set_apistatus(sdk_ret_to_api_status(ret));
     return ret;
 }
@@ -74,20 +87,33 @@ aga_svc_gpu_watch_delete (const GPUWatchDeleteRequest *proto_req,
 {
     sdk_ret_t ret;
     aga_obj_key_t key;
+    aga_batch_ctxt_t bctxt;
+    aga_batch_params_t batch_params = {};
 
     if ((proto_req == NULL) || (proto_req->id_size() == 0)) {
         proto_rsp->set_apistatus(types::ApiStatus::API_STATUS_INVALID_ARG);
         return SDK_RET_INVALID_ARG;
     }
     aga_api_trace_verbose("GPUWatch", "Delete", proto_req);
+    // all the GPU watches in the request are deleted or none of them are
+    bctxt = aga_batch_start(&batch_params);
+    if (unlikely(bctxt == AGA_BATCH_CTXT_INVALID)) {
+        proto_rsp->set_apistatus(sdk_ret_to_api_status(SDK_RET_OOM));
+        return SDK_RET_OOM;
+    }
     for (int i = 0; i < proto_req->id_size(); i++) {
         aga_obj_key_proto_to_api_spec(&key, proto_req->id(i));
-        ret = aga_gpu_watch_delete(&key);
+        ret = aga_gpu_watch_delete(&key, bctxt);
         if (unlikely(ret != SDK_RET_OK)) {
             goto end;
         }
     }
+    ret = aga_batch_commit(bctxt);
+    bctxt = AGA_BATCH_CTXT_INVALID;
 end:
+    if (bctxt != AGA_BATCH_CTXT_INVALID) {
+        aga_batch_destroy(bctxt);
+    }
     proto_rsp->set_apistatus(sdk_ret_to_api_status(ret));
     return ret;
 }
@@ -113,7 +139,6 @@ aga_svc_gpu_watch_get (const GPUWatchGetRequest *proto_req,
     }
     for (int i = 0; i < proto_req->id_size(); i ++) {
         aga_obj_key_proto_to_api_spec(&key, proto_req->id(i));
-        memset(&info, 0, sizeof(aga_gpu_watch_info_t));
         ret = aga_gpu_watch_read(&key, &info);
         if (unlikely(ret != SDK_RET_OK)) {
             proto_rsp->set_apistatus(sdk_ret_to_api_status(ret));
@@ -125,32 +150,122 @@ aga_svc_gpu_watch_get (const GPUWatchGetRequest *proto_req,
     return ret;
 }
 
+static inline sdk_ret_t
+aga_svc_gpu_watch_history_get (const GPUWatchHistoryGetRequest *proto_req,
+                               GPUWatchHistoryGetResponse *proto_rsp)
+{
+    sdk_ret_t ret;
+    aga_gpu_watch_history_query_t query = {};
+
+    if (proto_req == NULL) {
+        proto_rsp->set_apistatus(types::ApiStatus::API_STATUS_INVALID_ARG);
+        return SDK_RET_INVALID_ARG;
+    }
+    aga_api_trace_verbose("GPUWatch", "HistoryGet", proto_req);
+    ret = aga_gpu_watch_history_query_proto_to_api_spec(&query, *proto_req);
+    if (likely(ret == SDK_RET_OK)) {
+        ret = aga_gpu_watch_history_read(
+                  &query, aga_gpu_watch_series_to_history_get_rsp_proto,
+                  proto_rsp);
+    }
+    proto_rsp->set_apistatus(sdk_ret_to_api_status(ret));
+    return ret;
+}
+
+void
+aga_svc_gpu_watch_encoded_free_cb (void *encoded)
+{
+    delete (grpc::ByteBuffer *)encoded;
+}
+
+/// \brief    serialize GPU watch info into a byte buffer that can be
+///           written as is to any number of GPUWatchSubscribe streams
+/// \param[in] info     GPU watch information
+/// \param[in] delta    true if info carries only the attributes that changed
+/// \return    serialized GPU watch update or NULL in case of failure
+static inline grpc::ByteBuffer *
+aga_svc_gpu_watch_encode (const aga_gpu_watch_info_t *info, bool delta)
+{
+    Status status;
+    bool own_buffer;
+    GPUWatch proto_rsp;
+    grpc::ByteBuffer *buf;
+
+    if (delta) {
+        // only the watch id is needed to apply the changes
+        proto_rsp.mutable_spec()->set_id(info->spec.key.id, OBJ_MAX_KEY_LEN);
+        aga_gpu_watch_stats_to_proto(proto_rsp.mutable_stats(), &info->stats);
+        proto_rsp.set_delta(true);
+    } else {
+        aga_gpu_watch_info_to_proto(&proto_rsp, info);
+    }
+    buf = new grpc::ByteBuffer();
+    status = grpc::SerializationTraits<GPUWatch>::Serialize(proto_rsp, buf,
+                                                            &own_buffer);
+    if (unlikely(!status.ok())) {
+        AGA_TRACE_ERR("Failed to serialize gpu watch {}, err {}",
+                      info->spec.key.str(), status.error_message());
+        delete buf;
+        return NULL;
+    }
+    return buf;
+}
+
 sdk_ret_t
-aga_svc_gpu_watch_subscribe_write_cb (const aga_gpu_watch_info_t *info,
+aga_svc_gpu_watch_subscribe_write_cb (aga_gpu_watch_update_t *update,
                                       void *ctxt)
 {
-    bool rv;
-    GPUWatch proto_rsp;
+    bool rv, dropped;
+    const aga_gpu_watch_info_t *info = update->info;
     aga_gpu_watch_client_ctxt_t *client_ctxt;
 
     client_ctxt = (aga_gpu_watch_client_ctxt_t *)ctxt;
-    aga_gpu_watch_info_to_proto(&proto_rsp, info);
-    // try to write to the client stream
-    rv =
-        ((grpc::ServerWriter<GPUWatch> *)client_ctxt->stream)->Write(proto_rsp);
+    // first subscriber of this update serializes it for everyone
+    if (update->encoded == NULL) {
+        update->encoded = aga_svc_gpu_watch_encode(info, update->delta);
+        if (unlikely(update->encoded == NULL)) {
+            // skip this update, subscriber is still reachable
+            return SDK_RET_OK;
+        }
+        update->encoded_free_cb = aga_svc_gpu_watch_encoded_free_cb;
+    }
+    // queue the update on the client stream, the byte buffer shares the
+    // serialized slices so no copy of the payload is made per subscriber;
+    // updates of the same watch coalesce if the subscriber asked for it,
+    // except for change only subscribers as every change must be applied
+    // in order
+    rv = ((GPUWatchStreamReactor *)client_ctxt->stream)->Send(
+             *(grpc::ByteBuffer *)update->encoded,
+             client_ctxt->changes_only ? std::string() :
+                 std::string(info->spec.key.id, OBJ_MAX_KEY_LEN),
+             &dropped);
     if (unlikely(rv == false)) {
         AGA_TRACE_ERR("Failed to notify gpu watch {} to client {}",
                       info->spec.key.str(), client_ctxt->client.c_str());
         return SDK_RET_ERR;
     }
+    if (unlikely(dropped && client_ctxt->changes_only)) {
+        // an older update of any of the watches may have been dropped, so
+        // the values remembered as sent no longer match what the client
+        // has; forget them so that every watch goes out as a keyframe next
+        // NOTE: write callback runs in the watcher thread that owns delta
+        client_ctxt->delta.clear();
+    }
     return SDK_RET_OK;
 }
 
+void
+aga_svc_gpu_watch_subscribe_close_cb (void *stream)
+{
+    ((GPUWatchStreamReactor *)stream)->Close();
+}
+
 static inline sdk_ret_t
-aga_svc_gpu_watch_subscribe(ServerContext* context,
+aga_svc_gpu_watch_subscribe(CallbackServerContext* context,
     const GPUWatchSubscribeRequest *proto_req,
-    grpc::ServerWriter<GPUWatch> *stream) {
-    aga_gpu_watch_subscribe_req_t req;
+    GPUWatchStreamReactor *stream) {
+    aga_gpu_watch_attr_id_t attr_id;
+    aga_gpu_watch_subscribe_req_t req = {};
 
     if (proto_req->id_size() == 0) {
         // empty event subscribe request is not supported
@@ -168,12 +283,26 @@ aga_svc_gpu_watch_subscribe(ServerContext* context,
                         req.gpu_watch_ids[i].str());
     }
     req.num_gpu_watch_ids = proto_req->id_size();
+    req.changes_only = proto_req->changesonly();
+    req.keyframe_interval = proto_req->keyframeinterval();
+    for (auto i = 0; i < proto_req->deadband_size(); i++) {
+        const auto& deadband = proto_req->deadband(i);
+
+        attr_id = aga_gpu_watch_attr_id_to_api_spec(deadband.attribute());
+        if ((attr_id == AGA_GPU_WATCH_ATTR_ID_INVALID) ||
+            (deadband.threshold() < 0)) {
+            AGA_TRACE_ERR("Invalid GPU watch deadband, attribute {}, "
+                          "threshold {}", (uint32_t)deadband.attribute(),
+                          deadband.threshold());
+            return SDK_RET_INVALID_ARG;
+        }
+        req.deadband[attr_id] = deadband.threshold();
+    }
     req.write_cb = aga_svc_gpu_watch_subscribe_write_cb;
+    req.close_cb = aga_svc_gpu_watch_subscribe_close_cb;
     strncpy(req.client, context->peer().c_str(), AGA_MAX_GPU_WATCH_CLIENT_STR);
     req.stream = stream;
-    aga_gpu_watch_subscribe(&req);
-
-    return SDK_RET_OK;
+    return aga_gpu_watch_subscribe(&req);
 }
 
 #endif    // __AGA_SVC_GPU_WATCH_SVC_HPP__
@@ -195,6 +195,30 @@ aga_gpu_watch_attr_id_to_proto (aga_gpu_watch_attr_id_t id)
     }
 }
 
+// convert gpu watch aggregation statistic to proto
+static inline amdgpu::GPUWatchAggStat
+aga_gpu_watch_agg_stat_to_proto (aga_gpu_watch_agg_stat_t stat)
+{
+    switch (stat) {
+    case AGA_GPU_WATCH_AGG_STAT_MIN:
+        return amdgpu::GPUWatchAggStat::GPU_WATCH_AGG_STAT_MIN;
+    case AGA_GPU_WATCH_AGG_STAT_MAX:
+        return amdgpu::GPUWatchAggStat::GPU_WATCH_AGG_STAT_MAX;
+    case AGA_GPU_WATCH_AGG_STAT_AVG:
+        return amdgpu::GPUWatchAggStat::GPU_WATCH_AGG_STAT_AVG;
+    case AGA_GPU_WATCH_AGG_STAT_P50:
+        return amdgpu::GPUWatchAggStat::GPU_WATCH_AGG_STAT_P50;
+    case AGA_GPU_WATCH_AGG_STAT_P90:
+        return amdgpu::GPUWatchAggStat::GPU_WATCH_AGG_STAT_P90;
+    case AGA_GPU_WATCH_AGG_STAT_P95:
+        return amdgpu::GPUWatchAggStat::GPU_WATCH_AGG_STAT_P95;
+    case AGA_GPU_WATCH_AGG_STAT_P99:
+        return amdgpu::GPUWatchAggStat::GPU_WATCH_AGG_STAT_P99;
+    default:
+        return amdgpu::GPUWatchAggStat::GPU_WATCH_AGG_STAT_NONE;
+    }
+}
+
 // populate proto buf spec from gpu watch API spec
 static inline void
 aga_gpu_watch_spec_to_proto (amdgpu::GPUWatchSpec *proto_spec,
@@ -208,6 +232,12 @@ aga_gpu_watch_spec_to_proto (amdgpu::GPUWatchSpec *proto_spec,
         proto_spec->add_attribute(aga_gpu_watch_attr_id_to_proto(
                                       spec->attr_id[i]));
     }
+    proto_spec->set_samplinginterval(spec->sampling_interval);
+    proto_spec->set_aggregationwindow(spec->agg_window);
+    for (uint32_t i = 0; i < spec->num_agg_stats; i++) {
+        proto_spec->add_aggregationstat(aga_gpu_watch_agg_stat_to_proto(
+                                            spec->agg_stat[i]));
+    }
 }
 
 // populate proto buf status from gpu watch API status
@@ -246,12 +276,26 @@ aga_gpu_watch_stats_to_proto (amdgpu::GPUWatchStats *proto_stats,
                 proto_attr->mutable_value()->set_longval(attr->value.long_val);
                 break;
             case AGA_GPU_WATCH_ATTR_VALUE_TYPE_STRING:
-                proto_attr->mutable_value()->set_stringval(attr->value.str_val,
-                                                 AGA_MAX_WATCH_ATTR_STR + 1);
+                proto_attr->mutable_value()->set_stringval(
+                                                 attr->value.str_val);
                 break;
             default:
                 break;
             }
+            if (attr->capture_ns) {
+                proto_attr->mutable_capturetime()->set_seconds(
+                                attr->timestamp.tv_sec);
+                proto_attr->mutable_capturetime()->set_nanos(
+                                attr->timestamp.tv_nsec);
+                proto_attr->set_capturemonotonictime(attr->capture_ns);
+                proto_attr->set_collectionlatency(attr->collection_latency);
+            }
+            for (const auto& agg : attr->agg) {
+                auto proto_agg = proto_attr->add_aggregate();
+
+                proto_agg->set_stat(aga_gpu_watch_agg_stat_to_proto(agg.stat));
+                proto_agg->set_value(agg.value);
+            }
         }
     }
 }
@@ -276,4 +320,26 @@ aga_gpu_watch_info_to_get_rsp_proto (void *ctxt,
     aga_gpu_watch_info_to_proto(get_rsp_proto->add_response(), info);
 }
 
+// populate proto buf series from remembered samples of a GPU attribute
+static inline void
+aga_gpu_watch_series_to_history_get_rsp_proto (
+    void *ctxt, const aga_gpu_watch_series_t *series)
+{
+    amdgpu::GPUWatchHistoryGetResponse *rsp_proto =
+        (amdgpu::GPUWatchHistoryGetResponse *)ctxt;
+    auto proto_series = rsp_proto->add_series();
+
+    proto_series->set_gpu(series->gpu.id, OBJ_MAX_KEY_LEN);
+    proto_series->set_id(aga_gpu_watch_attr_id_to_proto(series->id));
+    proto_series->set_units(aga_gpu_watch_attr_id_to_units(series->id));
+    proto_series->mutable_sample()->Reserve(series->sample.size());
+    for (const auto& sample : series->sample) {
+        auto proto_sample = proto_series->add_sample();
+
+        proto_sample->mutable_time()->set_seconds(sample.timestamp.tv_sec);
+        proto_sample->mutable_time()->set_nanos(sample.timestamp.tv_nsec);
+        proto_sample->set_value(sample.value);
+    }
+}
+
 #endif    // __AGA_SVC_GPU_WATCH_TO_PROTO_HPP__
@@ -168,6 +168,30 @@ aga_gpu_watch_attr_id_to_api_spec (GPUWatchAttrId id)
     }
 }
 
+// convert gpu watch aggregation statistic to spec
+static inline aga_gpu_watch_agg_stat_t
+aga_gpu_watch_agg_stat_to_api_spec (amdgpu::GPUWatchAggStat stat)
+{
+    switch (stat) {
+    case amdgpu::GPUWatchAggStat::GPU_WATCH_AGG_STAT_MIN:
+        return AGA_GPU_WATCH_AGG_STAT_MIN;
+    case amdgpu::GPUWatchAggStat::GPU_WATCH_AGG_STAT_MAX:
+        return AGA_GPU_WATCH_AGG_STAT_MAX;
+    case amdgpu::GPUWatchAggStat::GPU_WATCH_AGG_STAT_AVG:
+        return AGA_GPU_WATCH_AGG_STAT_AVG;
+    case amdgpu::GPUWatchAggStat::GPU_WATCH_AGG_STAT_P50:
+        return AGA_GPU_WATCH_AGG_STAT_P50;
+    case amdgpu::GPUWatchAggStat::GPU_WATCH_AGG_STAT_P90:
+        return AGA_GPU_WATCH_AGG_STAT_P90;
+    case amdgpu::GPUWatchAggStat::GPU_WATCH_AGG_STAT_P95:
+        return AGA_GPU_WATCH_AGG_STAT_P95;
+    case amdgpu::GPUWatchAggStat::GPU_WATCH_AGG_STAT_P99:
+        return AGA_GPU_WATCH_AGG_STAT_P99;
+    default:
+        return AGA_GPU_WATCH_AGG_STAT_NONE;
+    }
+}
+
 static inline sdk_ret_t
 aga_gpu_watch_proto_to_api_spec (aga_gpu_watch_spec_t *api_spec,
                                  const GPUWatchSpec& proto_spec)
@@ -184,6 +208,46 @@ aga_gpu_watch_proto_to_api_spec (aga_gpu_watch_spec_t *api_spec,
             aga_gpu_watch_attr_id_to_api_spec(proto_spec.attribute(i));
     }
     api_spec->num_attrs = proto_spec.attribute_size();
+    api_spec->sampling_interval = proto_spec.samplinginterval();
+    if (proto_spec.aggregationstat_size() > AGA_GPU_WATCH_AGG_STATS_MAX) {
+        return SDK_RET_INVALID_ARG;
+    }
+    api_spec->agg_window = proto_spec.aggregationwindow();
+    for (int i = 0; i < proto_spec.aggregationstat_size(); i++) {
+        api_spec->agg_stat[i] =
+            aga_gpu_watch_agg_stat_to_api_spec(proto_spec.aggregationstat(i));
+    }
+    api_spec->num_agg_stats = proto_spec.aggregationstat_size();
+    return SDK_RET_OK;
+}
+
+static inline sdk_ret_t
+aga_gpu_watch_history_query_proto_to_api_spec (
+    aga_gpu_watch_history_query_t *api_spec,
+    const amdgpu::GPUWatchHistoryGetRequest& proto_spec)
+{
+    if ((proto_spec.gpu_size() > AGA_MAX_GPU) ||
+        (proto_spec.attribute_size() > AGA_GPU_WATCH_ATTRS_MAX)) {
+        return SDK_RET_INVALID_ARG;
+    }
+    for (int i = 0; i < proto_spec.gpu_size(); i++) {
+        aga_obj_key_proto_to_api_spec(&api_spec->gpu[i], proto_spec.gpu(i));
+    }
+    api_spec->num_gpu = proto_spec.gpu_size();
+    for (int i = 0; i < proto_spec.attribute_size(); i++) {
+        api_spec->attr_id[i] =
+            aga_gpu_watch_attr_id_to_api_spec(proto_spec.attribute(i));
+    }
+    api_spec->num_attrs = proto_spec.attribute_size();
+    if (proto_spec.has_starttime()) {
+        api_spec->start_time.tv_sec = proto_spec.starttime().seconds();
+        api_spec->start_time.tv_nsec = proto_spec.starttime().nanos();
+    }
+    if (proto_spec.has_endtime()) {
+        api_spec->end_time.tv_sec = proto_spec.endtime().seconds();
+        api_spec->end_time.tv_nsec = proto_spec.endtime().nanos();
+    }
+    api_spec->resolution = proto_spec.resolution();
     return SDK_RET_OK;
 }
 
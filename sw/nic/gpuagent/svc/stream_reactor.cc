@@ -0,0 +1,84 @@
+
+/*
+Copyright (c) Advanced Micro Devices, Inc. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+//----------------------------------------------------------------------------
+///
+/// \file
+/// bookkeeping of the live subscriber streams
+///
+//----------------------------------------------------------------------------
+
+#include <set>
+#include "nic/gpuagent/svc/stream_reactor.hpp"
+
+/// all live streams, protected by g_stream_lock
+static std::mutex g_stream_lock;
+static std::set<StreamReactorBase *> g_streams;
+
+StreamReactorBase::StreamReactorBase(const std::string& client,
+                                     const std::string& method,
+                                     types::StreamOverflowPolicy policy,
+                                     uint32_t queue_depth) :
+    client_(client), method_(method), policy_(policy),
+    queue_depth_peak_(0), num_sent_(0), num_dropped_(0), num_coalesced_(0),
+    registered_(false) {
+    if (queue_depth == 0) {
+        queue_depth_max_ = AGA_STREAM_QUEUE_DEPTH_DEFAULT;
+    } else if (queue_depth > AGA_STREAM_QUEUE_DEPTH_MAX) {
+        queue_depth_max_ = AGA_STREAM_QUEUE_DEPTH_MAX;
+    } else {
+        queue_depth_max_ = queue_depth;
+    }
+}
+
+StreamReactorBase::~StreamReactorBase() {
+    Unregister();
+}
+
+void
+StreamReactorBase::Register(void) {
+    std::lock_guard<std::mutex> lock(g_stream_lock);
+
+    if (!registered_) {
+        g_streams.insert(this);
+        registered_ = true;
+    }
+}
+
+void
+StreamReactorBase::Unregister(void) {
+    std::lock_guard<std::mutex> lock(g_stream_lock);
+
+    if (registered_) {
+        g_streams.erase(this);
+        registered_ = false;
+    }
+}
+
+void
+StreamReactorBase::Walk(const std::function<void(const stream_stats_t&)>& cb) {
+    stream_stats_t stats;
+
+    // NOTE: streams unregister under g_stream_lock before they are freed,
+    //       so holding it keeps every stream in the set alive
+    std::lock_guard<std::mutex> lock(g_stream_lock);
+    for (auto stream : g_streams) {
+        stream->Stats(&stats);
+        cb(stats);
+    }
+}
@@ -0,0 +1,281 @@
+
+/*
+Copyright (c) Advanced Micro Devices, Inc. All rights reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+     http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+*/
+
+
+//----------------------------------------------------------------------------
+///
+/// \file
+/// server side streaming reactor shared by the subscribe RPCs
+///
+//----------------------------------------------------------------------------
+
+#ifndef __AGA_SVC_STREAM_REACTOR_HPP__
+#define __AGA_SVC_STREAM_REACTOR_HPP__
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <functional>
+#include "grpc++/grpc++.h"
+#include "gen/proto/gpuagent/types.pb.h"
+
+/// default number of messages queued per subscriber
+#define AGA_STREAM_QUEUE_DEPTH_DEFAULT    64
+/// max. number of messages that can be queued per subscriber
+#define AGA_STREAM_QUEUE_DEPTH_MAX        4096
+
+/// send queue stats of a subscriber stream
+typedef struct stream_stats_s {
+    std::string client;                     ///< peer of the stream
+    std::string method;                     ///< streaming RPC name
+    types::StreamOverflowPolicy policy;     ///< overflow policy
+    uint32_t queue_depth_max;               ///< send queue capacity
+    uint32_t queue_depth;                   ///< messages queued now
+    uint32_t queue_depth_peak;              ///< send queue high watermark
+    uint64_t num_sent;                      ///< messages written to client
+    uint64_t num_dropped;                   ///< messages dropped on overflow
+    uint64_t num_coalesced;                 ///< messages replaced in queue
+} stream_stats_t;
+
+/// \brief    type independent part of the stream reactor, tracks all live
+///           streams so their queue stats can be queried
+class StreamReactorBase {
+public:
+    StreamReactorBase(const std::string& client, const std::string& method,
+                      types::StreamOverflowPolicy policy,
+                      uint32_t queue_depth);
+    virtual ~StreamReactorBase();
+
+    /// \brief    walk all live streams and invoke the callback with their
+    ///           send queue stats
+    /// \param[in] cb    callback invoked once per stream
+    static void Walk(const std::function<void(const stream_stats_t&)>& cb);
+
+protected:
+    /// \brief    snapshot of the send queue stats of this stream
+    /// \param[out] stats    stats of this stream
+    virtual void Stats(stream_stats_t *stats) = 0;
+
+    /// \brief    add the stream to the list of live streams
+    /// \remark   must be called only once the stream is fully constructed,
+    ///           as Walk() may query it right away
+    void Register(void);
+
+    /// \brief    remove the stream from the list of live streams
+    /// \remark   must be called before the members of the derived stream
+    ///           are destroyed
+    void Unregister(void);
+
+protected:
+    std::mutex mutex_;
+    std::string client_;                    ///< peer of the stream
+    std::string method_;                    ///< streaming RPC name
+    types::StreamOverflowPolicy policy_;    ///< overflow policy
+    uint32_t queue_depth_max_;              ///< send queue capacity
+    uint32_t queue_depth_peak_;             ///< send queue high watermark
+    uint64_t num_sent_;                     ///< messages written to client
+    uint64_t num_dropped_;                  ///< messages dropped on overflow
+    uint64_t num_coalesced_;                ///< messages replaced in queue
+    bool registered_;                       ///< true if in list of streams
+};
+
+/// \brief    write reactor for long lived server streams
+/// \remark   backend threads hand messages to Send() without blocking, the
+///           reactor queues them in a bounded send queue and drains it one
+///           write at a time from gRPC's callback threads, so a slow client
+///           never stalls the backend; the reactor stays alive until
+///           Close() is called and gRPC reports OnDone(), so the owner of
+///           the stream must always close it
+template <typename T>
+class StreamReactor : public grpc::ServerWriteReactor<T>,
+                      public StreamReactorBase {
+public:
+    StreamReactor(const std::string& client, const std::string& method,
+                  types::StreamOverflowPolicy policy,
+                  uint32_t queue_depth) :
+        StreamReactorBase(client, method, policy, queue_depth),
+        write_in_flight_(false), closed_(false), overflow_(false),
+        finish_pending_(false), finished_(false) {
+        Register();
+    }
+
+    ~StreamReactor() {
+        Unregister();
+    }
+
+    /// \brief    queue a message to be written to the client
+    /// \param[in] msg    message to be written
+    /// \param[in] key    key identifying the object the message is about,
+    ///                   used to coalesce updates of the same object
+    /// \param[out] dropped    if not NULL, set to true if an older message
+    ///                        was dropped to make room for this one
+    /// \return    false if the stream is no longer writable
+    bool Send(const T& msg, const std::string& key = std::string(),
+              bool *dropped = NULL) {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (dropped) {
+            *dropped = false;
+        }
+
+        if (closed_) {
+            return false;
+        }
+        if (!write_in_flight_) {
+            pending_.emplace_back(key, msg);
+            UpdatePeak_();
+            StartNextWrite_();
+            return true;
+        }
+        if ((policy_ == types::STREAM_OVERFLOW_POLICY_COALESCE_LATEST) &&
+            !key.empty()) {
+            for (auto& it : pending_) {
+                if (it.first == key) {
+                    it.second = msg;
+                    num_coalesced_++;
+                    return true;
+                }
+            }
+        }
+        if (pending_.size() >= queue_depth_max_) {
+            num_dropped_++;
+            if (policy_ == types::STREAM_OVERFLOW_POLICY_DISCONNECT) {
+                // client can't keep up, next Close() reports it
+                closed_ = true;
+                overflow_ = true;
+                pending_.clear();
+                return false;
+            }
+            pending_.pop_front();
+            if (dropped) {
+                *dropped = true;
+            }
+        }
+        pending_.emplace_back(key, msg);
+        UpdatePeak_();
+        return true;
+    }
+
+    /// \brief    finish the stream with the given status, messages that are
+    ///           still queued are dropped
+    /// \param[in] status    status to be sent to the client
+    void Close(const grpc::Status& status = grpc::Status::OK) {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        closed_ = true;
+        pending_.clear();
+        if (overflow_ && status.ok()) {
+            status_ = grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED,
+                                   "Subscriber send queue overflow");
+        } else {
+            status_ = status;
+        }
+        if (write_in_flight_) {
+            // finish once the outstanding write completes
+            finish_pending_ = true;
+            return;
+        }
+        Finish_(lock);
+    }
+
+    void OnWriteDone(bool ok) override {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        write_in_flight_ = false;
+        if (ok) {
+            num_sent_++;
+        } else {
+            // client went away, next Send() reports it to the backend
+            closed_ = true;
+            pending_.clear();
+        }
+        if (finish_pending_) {
+            Finish_(lock);
+        } else if (!pending_.empty()) {
+            StartNextWrite_();
+        }
+    }
+
+    void OnCancel(void) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        closed_ = true;
+        pending_.clear();
+    }
+
+    void OnDone(void) override {
+        Unregister();
+        delete this;
+    }
+
+protected:
+    void Stats(stream_stats_t *stats) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        stats->client = client_;
+        stats->method = method_;
+        stats->policy = policy_;
+        stats->queue_depth_max = queue_depth_max_;
+        stats->queue_depth = pending_.size();
+        stats->queue_depth_peak = queue_depth_peak_;
+        stats->num_sent = num_sent_;
+        stats->num_dropped = num_dropped_;
+        stats->num_coalesced = num_coalesced_;
+    }
+
+private:
+    // NOTE: caller must hold mutex_
+    void UpdatePeak_(void) {
+        if (pending_.size() > queue_depth_peak_) {
+            queue_depth_peak_ = pending_.size();
+        }
+    }
+
+    // NOTE: caller must hold mutex_
+    void StartNextWrite_(void) {
+        current_ = std::move(pending_.front().second);
+        pending_.pop_front();
+        write_in_flight_ = true;
+        this->StartWrite(&current_);
+    }
+
+    // NOTE: lock is released before finishing as OnDone() may free the
+    //       reactor as soon as Finish() is called
+    void Finish_(std::unique_lock<std::mutex>& lock) {
+        if (finished_) {
+            return;
+        }
+        finished_ = true;
+        finish_pending_ = false;
+        lock.unlock();
+        this->Finish(status_);
+    }
+
+private:
+    /// messages waiting to be written along with their coalescing key
+    std::deque<std::pair<std::string, T>> pending_;
+    T current_;                  ///< message being written currently
+    grpc::Status status_;        ///< status to finish the stream with
+    bool write_in_flight_;       ///< true if a write is outstanding
+    bool closed_;                ///< true if no more writes are accepted
+    bool overflow_;              ///< true if closed due to queue overflow
+    bool finish_pending_;        ///< true if Finish() awaits a write to end
+    bool finished_;              ///< true once Finish() is called
+};
+
+#endif    // __AGA_SVC_STREAM_REACTOR_HPP__